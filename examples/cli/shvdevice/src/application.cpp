@@ -5,6 +5,7 @@
 #include <shv/iotqt/rpc/clientconnection.h>
 #include <shv/iotqt/node/shvnodetree.h>
 #include <shv/iotqt/node/localfsnode.h>
+#include <shv/iotqt/node/asyncmethodrunner.h>
 #include <shv/coreqt/log.h>
 #include <shv/chainpack/tunnelctl.h>
 #include <shv/chainpack/metamethod.h>
@@ -25,6 +26,7 @@ static const std::vector<cp::MetaMethod> meta_methods {
 	{cp::Rpc::METH_APP_NAME, cp::MetaMethod::Flag::IsGetter, {}, "String", cp::AccessLevel::Browse},
 	{cp::Rpc::METH_DEVICE_ID, cp::MetaMethod::Flag::IsGetter, {}, "String", cp::AccessLevel::Browse},
 	{cp::Rpc::METH_DEVICE_TYPE, cp::MetaMethod::Flag::IsGetter, {}, "String", cp::AccessLevel::Browse},
+	{cp::Rpc::METH_GET_LOG, cp::MetaMethod::Flag::None, "Map", "List", cp::AccessLevel::Read},
 };
 
 AppRootNode::AppRootNode(QObject *parent)
@@ -71,6 +73,12 @@ shv::chainpack::RpcValue AppRootNode::processRpcRequest(const shv::chainpack::Rp
 		if(rq.method() == cp::Rpc::METH_DEVICE_TYPE) {
 			return "SampleShvClient";
 		}
+		if(rq.method() == cp::Rpc::METH_GET_LOG) {
+			// reading of journal files would block the event loop, response is sent by runner
+			Application *app = Application::instance();
+			app->asyncMethodRunner()->runGetLog(rq, *app->shvJournal());
+			return {};
+		}
 	}
 	return Super::processRpcRequest(rq);
 }
@@ -88,6 +96,15 @@ Application::Application(int &argc, char **argv, AppCliOptions* cli_opts)
 	auto root = new AppRootNode();
 	m_shvTree = new si::node::ShvNodeTree(root, this);
 	connect(m_shvTree->root(), &si::node::ShvRootNode::sendRpcMessage, m_rpcConnection, &si::rpc::ClientConnection::sendRpcMessage);
+
+	if(cli_opts->shvJournalDir_isset())
+		m_shvJournal.setJournalDir(cli_opts->shvJournalDir());
+	else
+		m_shvJournal.setJournalDir("/tmp/shvjournal/" + applicationName().toStdString());
+	m_shvJournal.setFileSizeLimit(cli_opts->shvJournalFileSizeLimit());
+	m_shvJournal.setJournalSizeLimit(cli_opts->shvJournalSizeLimit());
+	m_asyncMethodRunner = new si::node::AsyncMethodRunner(this);
+	connect(m_asyncMethodRunner, &si::node::AsyncMethodRunner::responseReady, m_rpcConnection, &si::rpc::ClientConnection::sendRpcMessage);
 	//m_shvTree->mkdir("sys/rproc");
 
 	QTimer::singleShot(0, m_rpcConnection, &si::rpc::ClientConnection::open);
@@ -113,9 +130,23 @@ AppCliOptions* Application::cliOptions()
 	return m_cliOptions;
 }
 
+shv::core::utils::ShvFileJournal *Application::shvJournal()
+{
+	return &m_shvJournal;
+}
+
+shv::iotqt::node::AsyncMethodRunner *Application::asyncMethodRunner() const
+{
+	return m_asyncMethodRunner;
+}
+
 void Application::onBrokerConnectedChanged(bool is_connected)
 {
 	m_isBrokerConnected = is_connected;
+	if(!is_connected) {
+		// nobody would receive responses of pending getLog calls
+		m_asyncMethodRunner->cancelAll();
+	}
 	if(is_connected) {
 		QTimer::singleShot(0, this, [this]() {
 			subscribeChanges();
@@ -141,6 +172,8 @@ void Application::onRpcMessageReceived(const shv::chainpack::RpcMessage &msg)
 	else if(msg.isSignal()) {
 		cp::RpcSignal nt(msg);
 		shvInfo() << "RPC signal received:" << nt.toPrettyString();
+		if(nt.method().asString() == cp::Rpc::SIG_VAL_CHANGED)
+			m_shvJournal.append(shv::core::utils::ShvJournalEntry(nt.shvPath().asString(), nt.params(), shv::core::utils::ShvJournalEntry::DOMAIN_VAL_CHANGE));
 	}
 }
 
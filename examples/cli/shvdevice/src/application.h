@@ -1,6 +1,7 @@
 #pragma once
 
 #include <shv/iotqt/node/shvnode.h>
+#include <shv/core/utils/shvfilejournal.h>
 
 #include <QCoreApplication>
 
@@ -9,7 +10,7 @@ class QTimer;
 
 namespace shv::chainpack { class RpcMessage; }
 namespace shv::iotqt::rpc { class ClientConnection; }
-namespace shv::iotqt::node { class ShvNodeTree; }
+namespace shv::iotqt::node { class ShvNodeTree; class AsyncMethodRunner; }
 
 class AppRootNode : public shv::iotqt::node::ShvRootNode
 {
@@ -38,6 +39,8 @@ public:
 	shv::iotqt::rpc::ClientConnection *rpcConnection() const;
 
 	AppCliOptions* cliOptions();
+	shv::core::utils::ShvFileJournal* shvJournal();
+	shv::iotqt::node::AsyncMethodRunner* asyncMethodRunner() const;
 
 private:
 	void onBrokerConnectedChanged(bool is_connected);
@@ -49,6 +52,9 @@ private:
 	AppCliOptions* m_cliOptions;
 
 	shv::iotqt::node::ShvNodeTree *m_shvTree = nullptr;
+	/// changes of subscribed values are logged, getLog is served from worker threads
+	shv::core::utils::ShvFileJournal m_shvJournal;
+	shv::iotqt::node::AsyncMethodRunner *m_asyncMethodRunner = nullptr;
 	bool m_isBrokerConnected = false;
 };
 
@@ -0,0 +1,75 @@
+#include <shv/broker/aclmanager.h>
+
+#include <benchmark/benchmark.h>
+
+using namespace shv::broker;
+using namespace shv::iotqt::acl;
+using namespace shv::chainpack;
+
+namespace {
+// ACL of a broker with many devices, each role grants access to its own subtree
+class BenchAclManager : public AclManager
+{
+	using Super = AclManager;
+public:
+	BenchAclManager(int role_count, int rules_per_role)
+		: Super(nullptr)
+	{
+		std::vector<std::string> user_roles;
+		for(int i = 0; i < role_count; ++i) {
+			const auto role_name = "role_" + std::to_string(i);
+			m_roles[role_name] = AclRole();
+			AclRoleAccessRules rules;
+			for(int j = 0; j < rules_per_role; ++j) {
+				rules.emplace_back("shv/site_" + std::to_string(i) + "/device_" + std::to_string(j) + "/**", "", "rd");
+			}
+			m_rules[role_name] = rules;
+			user_roles.push_back(role_name);
+		}
+		m_user = AclUser(AclPassword("secret", AclPassword::Format::Plain), user_roles);
+	}
+protected:
+	std::vector<std::string> aclMountDeviceIds() override { return {}; }
+	AclMountDef aclMountDef(const std::string &) override { return {}; }
+	std::vector<std::string> aclUsers() override { return {USER_NAME}; }
+	AclUser aclUser(const std::string &user_name) override { return user_name == USER_NAME? m_user: AclUser(); }
+	std::vector<std::string> aclRoles() override
+	{
+		std::vector<std::string> ret;
+		for(const auto &kv : m_roles)
+			ret.push_back(kv.first);
+		return ret;
+	}
+	AclRole aclRole(const std::string &role_name) override
+	{
+		auto it = m_roles.find(role_name);
+		return it == m_roles.end()? AclRole(): it->second;
+	}
+	std::vector<std::string> aclAccessRoles() override { return aclRoles(); }
+	AclRoleAccessRules aclAccessRoleRules(const std::string &role_name) override
+	{
+		auto it = m_rules.find(role_name);
+		return it == m_rules.end()? AclRoleAccessRules(): it->second;
+	}
+public:
+	static constexpr auto USER_NAME = "operator";
+private:
+	AclUser m_user;
+	std::map<std::string, AclRole> m_roles;
+	std::map<std::string, AclRoleAccessRules> m_rules;
+};
+
+void BM_AclManager_accessGrantForShvPath(benchmark::State &state)
+{
+	const auto role_count = static_cast<int>(state.range(0));
+	BenchAclManager acl(role_count, 20);
+	// last rule of the last role matches, so that all the rules are searched
+	const auto shv_path = "shv/site_" + std::to_string(role_count - 1) + "/device_19/status/value";
+	const std::string method = "get";
+	for(auto _ : state) {
+		auto acg = acl.accessGrantForShvPath(BenchAclManager::USER_NAME, shv_path, method, false, {});
+		benchmark::DoNotOptimize(acg);
+	}
+}
+BENCHMARK(BM_AclManager_accessGrantForShvPath)->Arg(1)->Arg(50);
+}
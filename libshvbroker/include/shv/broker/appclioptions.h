@@ -25,6 +25,9 @@ public:
 #ifdef WITH_SHV_WEBSOCKETS
 	CLIOPTION_GETTER_SETTER2(int, "server.websocket.port", s, setS, erverWebsocketPort)
 	CLIOPTION_GETTER_SETTER2(int, "server.websocket.sslport", s, setS, erverWebsocketSslPort)
+#endif
+#ifdef WITH_SHV_SHM_SOCKET
+	CLIOPTION_GETTER_SETTER2(std::string, "server.shmSocket", s, setS, erverShmSocket)
 #endif
 	CLIOPTION_GETTER_SETTER2(std::string, "server.ssl.key", s, setS, erverSslKeyFile)
 	CLIOPTION_GETTER_SETTER2(std::string, "server.ssl.cert", s, setS, erverSslCertFiles)
@@ -31,6 +31,7 @@ inline unsigned qHash(const std::string &s) noexcept //Q_DECL_NOEXCEPT_EXPR(noex
 #endif
 #include <shv/broker/azureconfig.h>
 #include <set>
+#include <unordered_map>
 
 class QSocketNotifier;
 class QSqlDatabase;
@@ -43,7 +44,7 @@ namespace shv::broker {
 
 const std::string BROKER_CURRENT_CLIENT_SHV_PATH = std::string(shv::chainpack::Rpc::DIR_BROKER) + '/' + CurrentClientShvNode::NodeId;
 
-namespace rpc { class WebSocketServer; class BrokerTcpServer; class ClientConnectionOnBroker;  class MasterBrokerConnection; class CommonRpcClientHandle; }
+namespace rpc { class WebSocketServer; class BrokerTcpServer; class ShmServer; class ClientConnectionOnBroker;  class MasterBrokerConnection; class CommonRpcClientHandle; }
 
 class AclManager;
 
@@ -86,6 +87,13 @@ public:
 
 	rpc::CommonRpcClientHandle* commonClientConnectionById(int connection_id);
 
+	/// every client and master broker connection is registered here regardless of transport,
+	/// connection is unregistered automatically when it is going to be deleted
+	void registerClientConnection(rpc::ClientConnectionOnBroker *conn);
+	void registerMasterBrokerConnection(rpc::MasterBrokerConnection *conn);
+	void unregisterConnection(int connection_id);
+	size_t connectionCount() const { return m_connections.size(); }
+
 	QSqlDatabase sqlConfigConnection();
 
 	AclManager *aclManager();
@@ -117,6 +125,8 @@ private:
 
 	void startWebSocketServers();
 
+	void startShmServer();
+
 	rpc::ClientConnectionOnBroker* clientConnectionById(int connection_id);
 	std::vector<int> clientConnectionIds();
 
@@ -149,6 +159,9 @@ protected:
 	rpc::WebSocketServer *m_webSocketServer = nullptr;
 	rpc::WebSocketServer *m_webSocketSslServer = nullptr;
 #endif
+#ifdef WITH_SHV_SHM_SOCKET
+	rpc::ShmServer *m_shmServer = nullptr;
+#endif
 #ifdef WITH_SHV_LDAP
 	std::unique_ptr<void, void(*)(void*)> m_ldapLib;
 	// LDAP username -> group
@@ -164,6 +177,12 @@ protected:
 	UserPathGrantCache m_userPathGrantCache;
 #endif
 	AclManager *m_aclManager = nullptr;
+	struct RegisteredConnection
+	{
+		rpc::ClientConnectionOnBroker *clientConnection = nullptr;
+		rpc::MasterBrokerConnection *masterBrokerConnection = nullptr;
+	};
+	std::unordered_map<int, RegisteredConnection> m_connections;
 #ifdef Q_OS_UNIX
 private:
 	// Unix signal handlers.
@@ -20,6 +20,10 @@ AppCliOptions::AppCliOptions()
 			.setComment("Web socket server port, set this option to enable websocket server").setDefaultValue(cp::IRpcConnection::DEFAULT_RPC_BROKER_WEB_SOCKET_PORT_NONSECURED);
 	addOption("server.websocket.sslport").setType(cp::RpcValue::Type::Int).setNames("--server-wss-port")
 			.setComment("Secure web socket server port, set this option to enable secure websocket server").setDefaultValue(cp::IRpcConnection::DEFAULT_RPC_BROKER_WEB_SOCKET_PORT_SECURED);
+#endif
+#ifdef WITH_SHV_SHM_SOCKET
+	addOption("server.shmSocket").setType(cp::RpcValue::Type::String).setNames("--server-shm-socket")
+			.setComment("Local socket name for shared memory connections (shm: scheme), set this option to enable shared memory server, clients must run as the same user as broker");
 #endif
 	addOption("server.ssl.key").setType(cp::RpcValue::Type::String).setNames("--server-ssl-key")
 			.setComment("SSL key file").setDefaultValue("wss.key");
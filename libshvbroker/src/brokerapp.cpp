@@ -16,6 +16,10 @@
 #include "rpc/websocketserver.h"
 #endif
 
+#ifdef WITH_SHV_SHM_SOCKET
+#include "rpc/shmserver.h"
+#endif
+
 #ifdef WITH_SHV_LDAP
 #include "openldap_dynamic.h"
 #include <shv/broker/ldap/ldap.h>
@@ -54,6 +58,7 @@
 #include <QJsonObject>
 #include <QFuture>
 
+#include <algorithm>
 #include <ctime>
 //#include <fstream>
 
@@ -610,61 +615,71 @@ void BrokerApp::startWebSocketServers()
 #endif
 }
 
-rpc::ClientConnectionOnBroker *BrokerApp::clientConnectionById(int connection_id)
+void BrokerApp::startShmServer()
 {
-	shvLogFuncFrame() << "conn id:" << connection_id;
-
-	rpc::ClientConnectionOnBroker *conn = nullptr;
-	if (m_sslServer) {
-		conn = sslServer()->connectionById(connection_id);
-		shvDebug() << "SSL connection:" << conn;
-	}
-	if (!conn && m_tcpServer) {
-		conn = tcpServer()->connectionById(connection_id);
-		shvDebug() << "TCP connection:" << conn;
-	}
-#ifdef WITH_SHV_WEBSOCKETS
-	if(!conn && m_webSocketServer) {
-		conn = m_webSocketServer->connectionById(connection_id);
-		shvDebug() << "ws connection:" << conn;
+#ifdef WITH_SHV_SHM_SOCKET
+	auto *opts = cliOptions();
+	if(opts->serverShmSocket_isset() && !opts->serverShmSocket().empty()) {
+		SHV_SAFE_DELETE(m_shmServer);
+		m_shmServer = new rpc::ShmServer(this);
+		if(!m_shmServer->start(QString::fromStdString(opts->serverShmSocket()))) {
+			SHV_EXCEPTION("Cannot start shared memory server!");
+		}
 	}
-	if(!conn && m_webSocketSslServer) {
-		conn = m_webSocketSslServer->connectionById(connection_id);
-		shvDebug() << "wss connection:" << conn;
+	else {
+		shvMessage() << "Shared memory server socket is not set, it will not be started.";
 	}
 #endif
-	return conn;
+}
+
+rpc::ClientConnectionOnBroker *BrokerApp::clientConnectionById(int connection_id)
+{
+	auto it = m_connections.find(connection_id);
+	if(it == m_connections.end())
+		return nullptr;
+	return it->second.clientConnection;
 }
 
 std::vector<int> BrokerApp::clientConnectionIds()
 {
 	std::vector<int> ids;
-	if(m_tcpServer) {
-		ids = m_tcpServer->connectionIds();
-	}
-	if(m_sslServer) {
-		std::vector<int> ids2 = m_sslServer->connectionIds();
-		ids.insert( ids.end(), ids2.begin(), ids2.end() );
-	}
-#ifdef WITH_SHV_WEBSOCKETS
-	if(m_webSocketServer) {
-		std::vector<int> ids2 = m_webSocketServer->connectionIds();
-		ids.insert( ids.end(), ids2.begin(), ids2.end() );
+	ids.reserve(m_connections.size());
+	for(const auto &[id, conn] : m_connections) {
+		if(conn.clientConnection)
+			ids.push_back(id);
 	}
-	if(m_webSocketSslServer) {
-		std::vector<int> ids2 = m_webSocketSslServer->connectionIds();
-		ids.insert( ids.end(), ids2.begin(), ids2.end() );
-	}
-#endif
+	std::sort(ids.begin(), ids.end());
 	return ids;
 }
 
+void BrokerApp::registerClientConnection(rpc::ClientConnectionOnBroker *conn)
+{
+	const int id = conn->connectionId();
+	m_connections[id] = RegisteredConnection{.clientConnection = conn};
+	connect(conn, &rpc::ClientConnectionOnBroker::aboutToBeDeleted, this, &BrokerApp::unregisterConnection);
+	// connection can be also deleted together with its server
+	connect(conn, &QObject::destroyed, this, [this, id]() { unregisterConnection(id); });
+}
+
+void BrokerApp::registerMasterBrokerConnection(rpc::MasterBrokerConnection *conn)
+{
+	const int id = conn->connectionId();
+	m_connections[id] = RegisteredConnection{.masterBrokerConnection = conn};
+	connect(conn, &QObject::destroyed, this, [this, id]() { unregisterConnection(id); });
+}
+
+void BrokerApp::unregisterConnection(int connection_id)
+{
+	m_connections.erase(connection_id);
+}
+
 void BrokerApp::lazyInit()
 {
 	initDbConfigSqlConnection();
 	reloadConfig();
 	startTcpServers();
 	startWebSocketServers();
+	startShmServer();
 	createMasterBrokerConnections();
 }
 
@@ -1410,6 +1425,7 @@ void BrokerApp::createMasterBrokerConnections()
 		shvInfo() << "creating master broker connection:" << kv.first;
 		auto *bc = new rpc::MasterBrokerConnection(this);
 		bc->setObjectName(QString::fromStdString(kv.first));
+		registerMasterBrokerConnection(bc);
 		int id = bc->connectionId();
 		connect(bc, &rpc::MasterBrokerConnection::brokerConnectedChanged, this, [id, this](bool is_connected) {
 			this->onConnectedToMasterBrokerChanged(id, is_connected);
@@ -1421,16 +1437,24 @@ void BrokerApp::createMasterBrokerConnections()
 
 QList<rpc::MasterBrokerConnection *> BrokerApp::masterBrokerConnections() const
 {
-	return findChildren<rpc::MasterBrokerConnection*>(QString(), Qt::FindDirectChildrenOnly);
+	QList<rpc::MasterBrokerConnection *> ret;
+	for(const auto &[id, conn] : m_connections) {
+		if(conn.masterBrokerConnection)
+			ret.push_back(conn.masterBrokerConnection);
+	}
+	// keep creation order, the first one is the default master broker
+	std::sort(ret.begin(), ret.end(), [](const rpc::MasterBrokerConnection *c1, const rpc::MasterBrokerConnection *c2) {
+		return c1->connectionId() < c2->connectionId();
+	});
+	return ret;
 }
 
 rpc::MasterBrokerConnection *BrokerApp::masterBrokerConnectionById(int connection_id)
 {
-	for(rpc::MasterBrokerConnection *bc : masterBrokerConnections()) {
-		if(bc->connectionId() == connection_id)
-			return bc;
-	}
-	return nullptr;
+	auto it = m_connections.find(connection_id);
+	if(it == m_connections.end())
+		return nullptr;
+	return it->second.masterBrokerConnection;
 }
 
 std::vector<rpc::CommonRpcClientHandle *> BrokerApp::allClientConnections()
@@ -1445,11 +1469,12 @@ std::vector<rpc::CommonRpcClientHandle *> BrokerApp::allClientConnections()
 
 rpc::CommonRpcClientHandle *BrokerApp::commonClientConnectionById(int connection_id)
 {
-	rpc::CommonRpcClientHandle *ret = clientConnectionById(connection_id);
-	if(ret)
-		return ret;
-	ret = masterBrokerConnectionById(connection_id);
-	return ret;
+	auto it = m_connections.find(connection_id);
+	if(it == m_connections.end())
+		return nullptr;
+	if(it->second.clientConnection)
+		return it->second.clientConnection;
+	return it->second.masterBrokerConnection;
 }
 
 QSqlDatabase BrokerApp::sqlConfigConnection()
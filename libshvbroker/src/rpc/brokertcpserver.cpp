@@ -20,11 +20,6 @@ BrokerTcpServer::BrokerTcpServer(SslMode ssl_mode, QObject *parent)
 
 BrokerTcpServer::~BrokerTcpServer() = default;
 
-ClientConnectionOnBroker *BrokerTcpServer::connectionById(int connection_id)
-{
-	return qobject_cast<rpc::ClientConnectionOnBroker *>(Super::connectionById(connection_id));
-}
-
 bool BrokerTcpServer::loadSslConfig()
 {
 	if (m_sslMode == SslMode::SecureMode) {
@@ -85,11 +80,15 @@ void BrokerTcpServer::incomingConnection(qintptr socket_descriptor)
 
 shv::iotqt::rpc::ServerConnection *BrokerTcpServer::createServerConnection(QTcpSocket *socket, QObject *parent)
 {
+	ClientConnectionOnBroker *conn = nullptr;
 	if (m_sslMode == SecureMode) {
-		return new ClientConnectionOnBroker(new shv::iotqt::rpc::SslSocket(qobject_cast<QSslSocket *>(socket)), parent);
+		conn = new ClientConnectionOnBroker(new shv::iotqt::rpc::SslSocket(qobject_cast<QSslSocket *>(socket)), parent);
 	}
-
-	return new ClientConnectionOnBroker(new shv::iotqt::rpc::TcpSocket(socket), parent);
+	else {
+		conn = new ClientConnectionOnBroker(new shv::iotqt::rpc::TcpSocket(socket), parent);
+	}
+	BrokerApp::instance()->registerClientConnection(conn);
+	return conn;
 }
 
 }
@@ -19,7 +19,6 @@ public:
 	BrokerTcpServer(SslMode ssl_mode, QObject *parent = nullptr);
 	~BrokerTcpServer() override;
 
-	ClientConnectionOnBroker* connectionById(int connection_id);
 	bool loadSslConfig();
 protected:
 	void incomingConnection(qintptr socket_descriptor) override;
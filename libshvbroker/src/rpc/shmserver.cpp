@@ -0,0 +1,54 @@
+#include "shmserver.h"
+
+#include "clientconnectiononbroker.h"
+#include <shv/broker/brokerapp.h>
+
+#include <shv/coreqt/log.h>
+#include <shv/iotqt/rpc/shmsocket.h>
+
+#include <QLocalSocket>
+
+namespace shv::broker::rpc {
+
+ShmServer::ShmServer(QObject *parent)
+	: Super(parent)
+{
+	// shared memory segments are created with owner only permissions,
+	// so only clients running as the broker user can connect
+	setSocketOptions(QLocalServer::UserAccessOption);
+	connect(this, &ShmServer::newConnection, this, &ShmServer::onNewConnection);
+}
+
+ShmServer::~ShmServer() = default;
+
+bool ShmServer::start(const QString &server_name)
+{
+	shvInfo() << "Starting shared memory server on local socket:" << server_name;
+	// remove stale socket file left by crashed broker
+	QLocalServer::removeServer(server_name);
+	if (!listen(server_name)) {
+		shvError() << tr("Unable to start the server: %1.").arg(errorString());
+		close();
+		return false;
+	}
+	shvInfo() << "Shared memory RPC server is listenning on" << fullServerName();
+	return true;
+}
+
+ClientConnectionOnBroker *ShmServer::createServerConnection(QLocalSocket *socket, QObject *parent)
+{
+	return new ClientConnectionOnBroker(new shv::iotqt::rpc::ShmSocket(socket, shv::iotqt::rpc::ShmSocket::Role::Server), parent);
+}
+
+void ShmServer::onNewConnection()
+{
+	QLocalSocket *sock = nextPendingConnection();
+	if(sock) {
+		ClientConnectionOnBroker *c = createServerConnection(sock, this);
+		shvInfo().nospace() << "shared memory client connected, connection ID: " << c->connectionId();
+		c->setConnectionName("shm:" + std::to_string(c->connectionId()));
+		BrokerApp::instance()->registerClientConnection(c);
+	}
+}
+
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <QLocalServer>
+
+namespace shv::broker::rpc {
+
+class ClientConnectionOnBroker;
+
+/// Accepts same host clients connecting with shm: scheme,
+/// local server socket is used to negotiate shared memory segment only
+class ShmServer : public QLocalServer
+{
+	Q_OBJECT
+	using Super = QLocalServer;
+public:
+	explicit ShmServer(QObject *parent = nullptr);
+	~ShmServer() override;
+
+	bool start(const QString &server_name);
+private:
+	ClientConnectionOnBroker* createServerConnection(QLocalSocket *socket, QObject *parent);
+	void onNewConnection();
+};
+}
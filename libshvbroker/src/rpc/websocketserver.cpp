@@ -45,22 +45,6 @@ bool WebSocketServer::start(int port)
 	return true;
 }
 
-std::vector<int> WebSocketServer::connectionIds() const
-{
-	std::vector<int> ret;
-	for(const auto &pair : m_connections)
-		ret.push_back(pair.first);
-	return ret;
-}
-
-ClientConnectionOnBroker *WebSocketServer::connectionById(int connection_id)
-{
-	auto it = m_connections.find(connection_id);
-	if(it == m_connections.end())
-		return nullptr;
-	return it->second;
-}
-
 ClientConnectionOnBroker *WebSocketServer::createServerConnection(QWebSocket *socket, QObject *parent)
 {
 	return new ClientConnectionOnBroker(new shv::iotqt::rpc::WebSocket(socket), parent);
@@ -75,14 +59,8 @@ void WebSocketServer::onNewConnection()
 		shvInfo().nospace() << "web socket client connected: " << sock->peerAddress().toString() << ':' << sock->peerPort()
 							<< " connection ID: " << c->connectionId();
 		c->setConnectionName(sock->peerAddress().toString().toStdString() + ':' + std::to_string(sock->peerPort()));
-		m_connections[c->connectionId()] = c;
-		connect(c, &ClientConnectionOnBroker::aboutToBeDeleted, this, &WebSocketServer::unregisterConnection);
+		BrokerApp::instance()->registerClientConnection(c);
 	}
 }
 
-void WebSocketServer::unregisterConnection(int connection_id)
-{
-	m_connections.erase(connection_id);
-}
-
 }
@@ -17,14 +17,8 @@ public:
 	~WebSocketServer() override;
 
 	bool start(int port = 0);
-
-	std::vector<int> connectionIds() const;
-	ClientConnectionOnBroker* connectionById(int connection_id);
 private:
 	ClientConnectionOnBroker* createServerConnection(QWebSocket *socket, QObject *parent);
 	void onNewConnection();
-	void unregisterConnection(int connection_id);
-private:
-	std::map<int, ClientConnectionOnBroker*> m_connections;
 };
 }
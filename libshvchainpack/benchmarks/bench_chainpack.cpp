@@ -0,0 +1,95 @@
+#include <shv/chainpack/chainpackreader.h>
+#include <shv/chainpack/chainpackwriter.h>
+#include <shv/chainpack/cponwriter.h>
+#include <shv/chainpack/rpcmessage.h>
+
+#include <benchmark/benchmark.h>
+
+#include <sstream>
+
+using namespace shv::chainpack;
+
+namespace {
+// Map of device properties similar to what getSnapshot or getLog return
+RpcValue make_device_snapshot(int64_t property_count)
+{
+	RpcValue::Map props;
+	for(int64_t i = 0; i < property_count; ++i) {
+		RpcValue::Map prop;
+		prop["value"] = static_cast<double>(i) * 1.5;
+		prop["status"] = static_cast<uint64_t>(i % 7);
+		prop["ts"] = RpcValue::DateTime::fromMSecsSinceEpoch(1700000000000 + i * 100);
+		prop["unit"] = "kWh";
+		prop["history"] = RpcValue::List{i, i + 1, i + 2, i + 3};
+		props["device/property_" + std::to_string(i) + "/value"] = prop;
+	}
+	return props;
+}
+
+RpcRequest make_request(int64_t property_count)
+{
+	RpcRequest rq;
+	rq.setRequestId(123);
+	rq.setShvPath("shv/site/device/properties");
+	rq.setMethod("set");
+	rq.setParams(make_device_snapshot(property_count));
+	return rq;
+}
+
+void BM_ChainPackWriter(benchmark::State &state)
+{
+	const auto val = make_device_snapshot(state.range(0));
+	size_t bytes = 0;
+	for(auto _ : state) {
+		std::ostringstream out;
+		ChainPackWriter wr(out);
+		wr.write(val);
+		bytes += out.view().size();
+		benchmark::DoNotOptimize(out);
+	}
+	state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+BENCHMARK(BM_ChainPackWriter)->Arg(10)->Arg(1000);
+
+void BM_ChainPackReader(benchmark::State &state)
+{
+	const auto data = make_device_snapshot(state.range(0)).toChainPack();
+	for(auto _ : state) {
+		std::istringstream in(data);
+		ChainPackReader rd(in);
+		RpcValue val;
+		rd.read(val);
+		benchmark::DoNotOptimize(val);
+	}
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data.size()));
+}
+BENCHMARK(BM_ChainPackReader)->Arg(10)->Arg(1000);
+
+void BM_CponWriter(benchmark::State &state)
+{
+	const auto val = make_device_snapshot(state.range(0));
+	size_t bytes = 0;
+	for(auto _ : state) {
+		std::ostringstream out;
+		CponWriter wr(out);
+		wr.write(val);
+		bytes += out.view().size();
+		benchmark::DoNotOptimize(out);
+	}
+	state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+BENCHMARK(BM_CponWriter)->Arg(10)->Arg(1000);
+
+void BM_RpcFrame_toFrameData(benchmark::State &state)
+{
+	const auto frame = make_request(state.range(0)).toRpcFrame();
+	size_t bytes = 0;
+	for(auto _ : state) {
+		auto frame_data = frame.toFrameData();
+		bytes += frame_data.size();
+		benchmark::DoNotOptimize(frame_data);
+	}
+	state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+BENCHMARK(BM_RpcFrame_toFrameData)->Arg(0)->Arg(10)->Arg(1000);
+}
@@ -12,6 +12,7 @@ class SHVCHAINPACK_DECL_EXPORT CponWriterOptions
 	bool m_hexBlob = false;
 	std::string m_indent;
 	bool m_jsonFormat = false;
+	size_t m_maxLength = 0;
 public:
 	bool isTranslateIds() const;
 	CponWriterOptions& setTranslateIds(bool b);
@@ -24,6 +25,10 @@ public:
 
 	bool isJsonFormat() const;
 	CponWriterOptions& setJsonFormat(bool b);
+
+	size_t maxLength() const;
+	/// writer stops traversing value after approximately max_len bytes, 0 means unlimited
+	CponWriterOptions& setMaxLength(size_t max_len);
 };
 
 class SHVCHAINPACK_DECL_EXPORT CponWriter : public AbstractStreamWriter
@@ -51,6 +56,8 @@ public:
 	void writeMapElement(const std::string &key, const RpcValue &val) override;
 	void writeMapElement(RpcValue::Int key, const RpcValue &val) override;
 	void writeRawData(const std::string &data) override;
+
+	bool isMaxLengthReached() const;
 private:
 	void writeMetaBegin(bool is_oneliner);
 	void writeMetaEnd();
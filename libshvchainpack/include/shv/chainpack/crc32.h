@@ -1,5 +1,7 @@
 #pragma once
 
+#include <shv/chainpack/shvchainpackglobal.h>
+
 #include <cstddef>
 #include <cstdint>
 #include <array>
@@ -28,6 +30,49 @@ consteval auto make_table() {
 	return table;
 }
 
+/// Tables for slicing-by-8, they work on non-inverted CRC state,
+/// which is bitwise complement of Crc32::remainder()
+template<crc32_t POLY>
+consteval auto make_slicing_tables() {
+	std::array<std::array<crc32_t, 256>, 8> tables;
+	for(crc32_t i = 0; i < 0x100; ++i) {
+		auto r = i;
+		for(int j = 0; j < 8; ++j)
+			r = (r & 1? POLY: 0) ^ (r >> 1);
+		tables[0][i] = r;
+	}
+	for(size_t k = 1; k < tables.size(); ++k) {
+		for(size_t i = 0; i < 0x100; ++i) {
+			const auto r = tables[k - 1][i];
+			tables[k][i] = (r >> 8) ^ tables[0][r & 0xFF];
+		}
+	}
+	return tables;
+}
+
+template<crc32_t POLY>
+constexpr crc32_t crc32_update_sliced(crc32_t state, const uint8_t *data, size_t n)
+{
+	constexpr auto t = make_slicing_tables<POLY>();
+	auto load32 = [](const uint8_t *p) {
+		return static_cast<crc32_t>(p[0]) | static_cast<crc32_t>(p[1]) << 8 | static_cast<crc32_t>(p[2]) << 16 | static_cast<crc32_t>(p[3]) << 24;
+	};
+	for(; n >= 8; n -= 8, data += 8) {
+		const auto lo = load32(data) ^ state;
+		const auto hi = load32(data + 4);
+		state = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24]
+			^ t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+	}
+	for(; n > 0; --n, ++data) {
+		state = t[0][(state ^ *data) & 0xFF] ^ (state >> 8);
+	}
+	return state;
+}
+
+/// Adds data to CRC-32/ISO-HDLC remainder,
+/// PCLMULQDQ or ARMv8 CRC32 instructions are used when CPU supports them
+SHVCHAINPACK_DECL_EXPORT crc32_t crc32_posix_add(crc32_t remainder, const uint8_t *data, size_t n);
+
 template<crc32_t POLY>
 class Crc32
 {
@@ -37,8 +82,11 @@ public:
 		m_remainder = m_table[ix] ^ (m_remainder >> 8);
 	}
 	void add(const void *data, size_t n) {
-		for (size_t i = 0; i < n; ++i) {
-			add(static_cast<const uint8_t*>(data)[i]);
+		if constexpr (POLY == CRC_POSIX_POLY_REV) {
+			m_remainder = crc32_posix_add(m_remainder, static_cast<const uint8_t*>(data), n);
+		}
+		else {
+			m_remainder = ~crc32_update_sliced<POLY>(~m_remainder, static_cast<const uint8_t*>(data), n);
 		}
 	}
 	crc32_t remainder() const { return m_remainder; }
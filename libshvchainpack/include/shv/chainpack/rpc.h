@@ -11,6 +11,8 @@ public:
 	static const char* protocolTypeToString(ProtocolType pv);
 
 	static constexpr auto OPT_IDLE_WD_TIMEOUT = "idleWatchDogTimeOut";
+	/// login option with list of frame compressions supported by client, login result contains the selected one
+	static constexpr auto OPT_COMPRESSION = "compression";
 
 	static constexpr auto SND_LOG_ARROW = "<==S";
 	static constexpr auto RCV_LOG_ARROW = "R==>";
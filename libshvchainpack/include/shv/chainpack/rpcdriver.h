@@ -12,6 +12,8 @@ class ParseException;
 
 class SHVCHAINPACK_DECL_EXPORT RpcDriver
 {
+public:
+	static constexpr size_t DEFAULT_FRAME_COMPRESSION_THRESHOLD = 1024;
 public:
 	explicit RpcDriver();
 	virtual ~RpcDriver();
@@ -23,6 +25,12 @@ public:
 	static void setDefaultRpcTimeoutMsec(int msec);
 
 	static std::string frameToPrettyCpon(const RpcFrame &frame);
+
+	/// compression negotiated with peer during login
+	void setFrameCompression(RpcFrame::Compression compression);
+	RpcFrame::Compression frameCompression() const { return m_frameCompression; }
+	/// frames with data smaller than threshold are sent uncompressed
+	void setFrameCompressionThreshold(size_t threshold) { m_frameCompressionThreshold = threshold; }
 protected:
 	virtual bool isOpen() = 0;
 
@@ -37,6 +45,8 @@ protected:
 protected:
 	/// We must remember recent message protocol type to support legacy CPON clients
 	Rpc::ProtocolType m_clientProtocolType = Rpc::ProtocolType::Invalid;
+	RpcFrame::Compression m_frameCompression = RpcFrame::Compression::None;
+	size_t m_frameCompressionThreshold = DEFAULT_FRAME_COMPRESSION_THRESHOLD;
 private:
 	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
 	static int s_defaultRpcTimeoutMsec;
@@ -18,6 +18,11 @@ struct AccessGrant;
 
 struct SHVCHAINPACK_DECL_EXPORT RpcFrame
 {
+	/// compression of frame data, it is stored in frame meta, so that broker can forward compressed frames as they are
+	enum class Compression {None = 0, Deflate};
+	/// upper limit of frame data size, decompression fails when inflated data would exceed it
+	static constexpr size_t MAX_DATA_SIZE = 64 * 1024 * 1024;
+
 	Rpc::ProtocolType protocol = Rpc::ProtocolType::ChainPack;
 	RpcValue::MetaData meta;
 	std::string data;
@@ -28,6 +33,16 @@ struct SHVCHAINPACK_DECL_EXPORT RpcFrame
 	RpcMessage toRpcMessage(std::string *errmsg = nullptr) const;
 	std::string toFrameData() const;
 	static RpcFrame fromFrameData(const std::string &frame_data);
+
+	Compression compression() const;
+	/// does nothing if data are already compressed or compression is not supported by this build
+	void compress(Compression compression);
+	/// throws std::runtime_error if data are corrupted, inflated data exceed max_size
+	/// or compression is not supported by this build
+	void decompress(size_t max_size = MAX_DATA_SIZE);
+	static bool isCompressionSupported(Compression compression);
+	static const char* compressionToString(Compression compression);
+	static Compression compressionFromString(const std::string &name);
 };
 
 class SHVCHAINPACK_DECL_EXPORT RpcMessage
@@ -48,6 +63,7 @@ public:
 								UserId = 16,
 								AccessLevel = 17,
 								Source = 19,
+								Compression = 22,
 								MAX};};
 		struct Key { enum Enum {Params = 1, Result, Error, MAX};};
 
@@ -145,6 +161,9 @@ public:
 
 	std::string toPrettyString() const;
 	std::string toCpon() const;
+	/// string representation cut to max_len, message is traversed only until the limit is reached
+	std::string toPrettyString(size_t max_len) const;
+	std::string toCpon(size_t max_len) const;
 	std::string toChainPack() const;
 
 	RpcFrame toRpcFrame(Rpc::ProtocolType protocol = Rpc::ProtocolType::ChainPack) const;
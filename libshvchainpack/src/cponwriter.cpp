@@ -3,6 +3,7 @@
 
 #include <shv/chainpack/ccpon.h>
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <fstream>
@@ -49,6 +50,16 @@ CponWriterOptions& CponWriterOptions::setJsonFormat(bool b)
 	m_jsonFormat = b; return *this;
 }
 
+size_t CponWriterOptions::maxLength() const
+{
+	return m_maxLength;
+}
+
+CponWriterOptions& CponWriterOptions::setMaxLength(size_t max_len)
+{
+	m_maxLength = max_len; return *this;
+}
+
 namespace {
 bool is_oneline_list(const RpcList &lst)
 {
@@ -160,8 +171,15 @@ CponWriter& CponWriter::operator <<(const RpcValue::MetaData &meta_data)
 	return *this;
 }
 
+bool CponWriter::isMaxLengthReached() const
+{
+	return m_opts.maxLength() > 0 && m_outCtx.bytes_written >= m_opts.maxLength();
+}
+
 void CponWriter::write(const RpcValue &value)
 {
+	if(isMaxLengthReached())
+		return;
 	if(!value.metaData().isEmpty()) {
 		write(value.metaData());
 	}
@@ -188,11 +206,13 @@ void CponWriter::write(const RpcValue &value)
 
 void CponWriter::write(const RpcValue::MetaData &meta_data)
 {
-	if(!meta_data.isEmpty()) {
+	if(!meta_data.isEmpty() && !isMaxLengthReached()) {
 		writeMetaBegin(is_oneline_meta(meta_data));
 		const RpcValue::IMap &cim = meta_data.iValues();
 		if(!cim.empty()) {
 			for (const auto &kv : cim) {
+				if(isMaxLengthReached())
+					break;
 				if(m_opts.isTranslateIds()) {
 					ContainerState &cs = m_containerStates[m_containerStates.size() - 1];
 					ccpon_pack_field_delim(&m_outCtx, cs.elementCount++ == 0, cs.isOneLiner);
@@ -235,6 +255,8 @@ void CponWriter::write(const RpcValue::MetaData &meta_data)
 		}
 		const RpcValue::Map &csm = meta_data.sValues();
 		for (const auto &kv : csm) {
+			if(isMaxLengthReached())
+				break;
 			writeMapElement(kv.first, kv.second);
 		}
 		writeMetaEnd();
@@ -387,13 +409,20 @@ CponWriter &CponWriter::write_p(RpcValue::DateTime value)
 
 CponWriter &CponWriter::write_p(const std::string &value)
 {
-	ccpon_pack_string(&m_outCtx, value.data(), value.size());
+	// escaping can only make the result longer, so the rest of the string is never needed
+	auto len = value.size();
+	if(m_opts.maxLength() > 0)
+		len = std::min(len, m_opts.maxLength() - std::min(m_opts.maxLength(), m_outCtx.bytes_written));
+	ccpon_pack_string(&m_outCtx, value.data(), len);
 	return *this;
 }
 
 CponWriter &CponWriter::write_p(const RpcValue::Blob &value)
 {
-	ccpon_pack_blob(&m_outCtx, value.data(), value.size());
+	auto len = value.size();
+	if(m_opts.maxLength() > 0)
+		len = std::min(len, m_opts.maxLength() - std::min(m_opts.maxLength(), m_outCtx.bytes_written));
+	ccpon_pack_blob(&m_outCtx, value.data(), len);
 	return *this;
 }
 
@@ -401,6 +430,8 @@ CponWriter &CponWriter::write_p(const RpcValue::Map &values)
 {
 	writeContainerBegin(RpcValue::Type::Map, is_oneline_map(values));
 	for (const auto &kv : values) {
+		if(isMaxLengthReached())
+			break;
 		writeMapElement(kv.first, kv.second);
 	}
 	writeContainerEnd();
@@ -411,6 +442,8 @@ CponWriter &CponWriter::write_p(const RpcValue::IMap &values, const RpcValue::Me
 {
 	writeContainerBegin(RpcValue::Type::IMap, is_oneline_map(values));
 	for (const auto &kv : values) {
+		if(isMaxLengthReached())
+			break;
 		if(m_opts.isTranslateIds() && meta_data) {
 			ContainerState &cs = m_containerStates[m_containerStates.size() - 1];
 			ccpon_pack_field_delim(&m_outCtx, cs.elementCount++ == 0, cs.isOneLiner);
@@ -439,6 +472,8 @@ CponWriter &CponWriter::write_p(const RpcList &values)
 {
 	writeContainerBegin(RpcValue::Type::List, is_oneline_list(values));
 	for (const auto& value : values) {
+		if(isMaxLengthReached())
+			break;
 		writeListElement(value);
 	}
 	writeContainerEnd();
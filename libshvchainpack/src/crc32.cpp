@@ -0,0 +1,142 @@
+#include <shv/chainpack/crc32.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SHV_CRC32_PCLMUL
+#include <immintrin.h>
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+#define SHV_CRC32_ARMV8
+#include <arm_acle.h>
+#if defined(__linux__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+#endif
+
+#include <cstring>
+
+namespace shv::chainpack {
+
+namespace {
+using UpdateFn = crc32_t (*)(crc32_t state, const uint8_t *data, size_t n);
+
+crc32_t update_sliced(crc32_t state, const uint8_t *data, size_t n)
+{
+	return crc32_update_sliced<CRC_POSIX_POLY_REV>(state, data, n);
+}
+
+#ifdef SHV_CRC32_PCLMUL
+// folding constants for CRC-32/ISO-HDLC, see Intel's "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction"
+alignas(16) constexpr uint64_t K1K2[] = {0x0154442bd4, 0x01c6e41596};
+alignas(16) constexpr uint64_t K3K4[] = {0x01751997d0, 0x00ccaa009e};
+alignas(16) constexpr uint64_t K5K0[] = {0x0163cd6124, 0x0000000000};
+alignas(16) constexpr uint64_t POLY_MU[] = {0x01db710641, 0x01f7011641};
+constexpr size_t PCLMUL_MIN_LENGTH = 64;
+
+__attribute__((target("pclmul,sse4.1")))
+__m128i fold16(__m128i x, __m128i k, __m128i data)
+{
+	const auto lo = _mm_clmulepi64_si128(x, k, 0x00);
+	const auto hi = _mm_clmulepi64_si128(x, k, 0x11);
+	return _mm_xor_si128(_mm_xor_si128(hi, lo), data);
+}
+
+__attribute__((target("pclmul,sse4.1")))
+crc32_t update_pclmul(crc32_t state, const uint8_t *data, size_t n)
+{
+	if(n < PCLMUL_MIN_LENGTH)
+		return update_sliced(state, data, n);
+
+	auto load = [](const uint8_t *p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); };
+	auto x1 = _mm_xor_si128(load(data), _mm_cvtsi32_si128(static_cast<int>(state)));
+	auto x2 = load(data + 16);
+	auto x3 = load(data + 32);
+	auto x4 = load(data + 48);
+	data += 64;
+	n -= 64;
+
+	auto k = _mm_load_si128(reinterpret_cast<const __m128i*>(K1K2));
+	for(; n >= 64; n -= 64, data += 64) {
+		x1 = fold16(x1, k, load(data));
+		x2 = fold16(x2, k, load(data + 16));
+		x3 = fold16(x3, k, load(data + 32));
+		x4 = fold16(x4, k, load(data + 48));
+	}
+
+	k = _mm_load_si128(reinterpret_cast<const __m128i*>(K3K4));
+	x1 = fold16(x1, k, x2);
+	x1 = fold16(x1, k, x3);
+	x1 = fold16(x1, k, x4);
+	for(; n >= 16; n -= 16, data += 16) {
+		x1 = fold16(x1, k, load(data));
+	}
+
+	// fold 128 bits to 64 bits
+	const auto mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+	x2 = _mm_clmulepi64_si128(x1, k, 0x10);
+	x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+	k = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(K5K0));
+	x2 = _mm_srli_si128(x1, 4);
+	x1 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+
+	// Barrett reduction to 32 bits
+	k = _mm_load_si128(reinterpret_cast<const __m128i*>(POLY_MU));
+	x2 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k, 0x10);
+	x2 = _mm_clmulepi64_si128(_mm_and_si128(x2, mask32), k, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+	state = static_cast<crc32_t>(_mm_extract_epi32(x1, 1));
+
+	return update_sliced(state, data, n);
+}
+#endif
+
+#ifdef SHV_CRC32_ARMV8
+#ifdef __clang__
+#define SHV_CRC32_TARGET __attribute__((target("crc")))
+#else
+#define SHV_CRC32_TARGET __attribute__((target("+crc")))
+#endif
+SHV_CRC32_TARGET
+crc32_t update_armv8(crc32_t state, const uint8_t *data, size_t n)
+{
+	for(; n > 0 && reinterpret_cast<uintptr_t>(data) % sizeof(uint64_t); --n, ++data) {
+		state = __crc32b(state, *data);
+	}
+	for(; n >= sizeof(uint64_t); n -= sizeof(uint64_t), data += sizeof(uint64_t)) {
+		uint64_t word;
+		std::memcpy(&word, data, sizeof(word));
+		state = __crc32d(state, word);
+	}
+	for(; n > 0; --n, ++data) {
+		state = __crc32b(state, *data);
+	}
+	return state;
+}
+#endif
+
+UpdateFn select_update_fn()
+{
+#ifdef SHV_CRC32_PCLMUL
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1"))
+		return update_pclmul;
+#endif
+#ifdef SHV_CRC32_ARMV8
+#if defined(__ARM_FEATURE_CRC32)
+	return update_armv8;
+#elif defined(__linux__) && defined(HWCAP_CRC32)
+	if(getauxval(AT_HWCAP) & HWCAP_CRC32)
+		return update_armv8;
+#endif
+#endif
+	return update_sliced;
+}
+}
+
+crc32_t crc32_posix_add(crc32_t remainder, const uint8_t *data, size_t n)
+{
+	static const UpdateFn update = select_update_fn();
+	return ~update(~remainder, data, n);
+}
+
+}
@@ -37,6 +37,11 @@ void RpcDriver::sendRpcFrame(RpcFrame &&frame)
 				   << "send raw meta + data: " << frame.meta.toPrettyString()
 				   << Utils::toHex(frame.data, 0, 250);
 	try {
+		if (const auto compression = frame.compression(); compression != RpcFrame::Compression::None
+				&& (compression != m_frameCompression || frame.protocol != m_clientProtocolType)) {
+			// forwarded frame is compressed, but peer does not support it
+			frame.decompress();
+		}
 		if (frame.protocol != m_clientProtocolType) {
 			// convert chainpack to cpon if client needs it
 			// clients communicating with Cpon are deprecated
@@ -48,6 +53,9 @@ void RpcDriver::sendRpcFrame(RpcFrame &&frame)
 			}
 			frame = msg.toRpcFrame(m_clientProtocolType);
 		}
+		if (m_frameCompression != RpcFrame::Compression::None && frame.data.size() >= m_frameCompressionThreshold) {
+			frame.compress(m_frameCompression);
+		}
 		auto frame_data = frame.toFrameData();
 		//logRpcData().nospace() << "FRAME DATA WRITE " << frame_data.size() << " bytes of data:\n" << shv::chainpack::utils::hexDump(frame_data);
 		writeFrameData(frame_data);
@@ -57,6 +65,11 @@ void RpcDriver::sendRpcFrame(RpcFrame &&frame)
 	}
 }
 
+void RpcDriver::setFrameCompression(RpcFrame::Compression compression)
+{
+	m_frameCompression = RpcFrame::isCompressionSupported(compression)? compression: RpcFrame::Compression::None;
+}
+
 int RpcDriver::defaultRpcTimeoutMsec()
 {
 	return s_defaultRpcTimeoutMsec;
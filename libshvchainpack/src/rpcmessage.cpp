@@ -10,6 +10,11 @@
 #include <shv/chainpack/cponreader.h>
 #include <shv/chainpack/chainpackreader.h>
 
+#ifdef LIBSHV_WITH_ZLIB
+#include <zlib.h>
+#endif
+
+#include <array>
 #include <cassert>
 #include <sstream>
 
@@ -34,6 +39,7 @@ RpcMessage::MetaType::MetaType()
 		{static_cast<int>(Tag::TunnelCtl), {static_cast<int>(Tag::TunnelCtl), "tctl"}},
 		{static_cast<int>(Tag::UserId), {static_cast<int>(Tag::UserId), "userId"}},
 		{static_cast<int>(Tag::Source), {static_cast<int>(Tag::Source), "source"}},
+		{static_cast<int>(Tag::Compression), {static_cast<int>(Tag::Compression), "compression"}},
 	};
 }
 
@@ -63,6 +69,20 @@ RpcMessage RpcFrame::toRpcMessage(std::string *errmsg) const
 		}
 		return RpcMessage();
 	};
+	if (compression() != Compression::None) {
+		auto frame = *this;
+		try {
+			frame.decompress();
+		}
+		catch (const std::runtime_error &e) {
+			if (!errmsg) {
+				throw;
+			}
+			*errmsg = e.what();
+			return {};
+		}
+		return frame.toRpcMessage(errmsg);
+	}
 	switch (protocol) {
 	case Rpc::ProtocolType::ChainPack: {
 		auto val = RpcValue::fromChainPack(data, errmsg);
@@ -164,6 +184,109 @@ RpcFrame RpcFrame::fromFrameData(const std::string &frame_data)
 	return {};
 }
 
+RpcFrame::Compression RpcFrame::compression() const
+{
+	return static_cast<Compression>(meta.value(RpcMessage::MetaType::Tag::Compression).toInt());
+}
+
+void RpcFrame::compress(Compression compression)
+{
+	if (compression == Compression::None || this->compression() != Compression::None || !isCompressionSupported(compression)) {
+		return;
+	}
+#ifdef LIBSHV_WITH_ZLIB
+#if defined __GNUC__ && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuseless-cast"
+#endif
+	auto compressed_size = ::compressBound(static_cast<uLong>(data.size()));
+	std::string compressed_data(compressed_size, '\0');
+	if (::compress2(reinterpret_cast<Bytef*>(compressed_data.data()), &compressed_size, reinterpret_cast<const Bytef*>(data.data()), static_cast<uLong>(data.size()), Z_DEFAULT_COMPRESSION) != Z_OK) {
+		return;
+	}
+#if defined __GNUC__ && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+	compressed_data.resize(compressed_size);
+	data = std::move(compressed_data);
+	meta.setValue(RpcMessage::MetaType::Tag::Compression, static_cast<int>(compression));
+#endif
+}
+
+void RpcFrame::decompress(size_t max_size)
+{
+	const auto frame_compression = compression();
+	if (frame_compression == Compression::None) {
+		return;
+	}
+	if (!isCompressionSupported(frame_compression)) {
+		throw std::runtime_error("Frame compression " + std::to_string(static_cast<int>(frame_compression)) + " is not supported");
+	}
+#ifdef LIBSHV_WITH_ZLIB
+	z_stream strm{};
+	if (::inflateInit(&strm) != Z_OK) {
+		throw std::runtime_error("Cannot initialize frame decompression");
+	}
+	std::string decompressed_data;
+	std::array<char, 16 * 1024> buff;
+	strm.next_in = reinterpret_cast<Bytef*>(data.data());
+	strm.avail_in = static_cast<uInt>(data.size());
+	int ret;
+	do {
+		strm.next_out = reinterpret_cast<Bytef*>(buff.data());
+		strm.avail_out = static_cast<uInt>(buff.size());
+		ret = ::inflate(&strm, Z_NO_FLUSH);
+		if (ret != Z_OK && ret != Z_STREAM_END) {
+			::inflateEnd(&strm);
+			throw std::runtime_error("Corrupted compressed frame data");
+		}
+		auto inflated_size = buff.size() - strm.avail_out;
+		if (decompressed_data.size() + inflated_size > max_size) {
+			::inflateEnd(&strm);
+			throw std::runtime_error("Decompressed frame data exceed max size " + std::to_string(max_size));
+		}
+		decompressed_data.append(buff.data(), inflated_size);
+	} while (ret != Z_STREAM_END && (strm.avail_in > 0 || strm.avail_out == 0));
+	::inflateEnd(&strm);
+	if (ret != Z_STREAM_END) {
+		throw std::runtime_error("Truncated compressed frame data");
+	}
+	data = std::move(decompressed_data);
+	meta.setValue(RpcMessage::MetaType::Tag::Compression, RpcValue());
+#endif
+}
+
+bool RpcFrame::isCompressionSupported(Compression compression)
+{
+	switch (compression) {
+	case Compression::None:
+		return true;
+	case Compression::Deflate:
+#ifdef LIBSHV_WITH_ZLIB
+		return true;
+#else
+		return false;
+#endif
+	}
+	return false;
+}
+
+const char* RpcFrame::compressionToString(Compression compression)
+{
+	switch (compression) {
+	case Compression::None: return "none";
+	case Compression::Deflate: return "deflate";
+	}
+	return "???";
+}
+
+RpcFrame::Compression RpcFrame::compressionFromString(const std::string &name)
+{
+	if (name == compressionToString(Compression::Deflate))
+		return Compression::Deflate;
+	return Compression::None;
+}
+
 //==================================================================
 // RpcMessage
 //==================================================================
@@ -632,6 +755,35 @@ std::string RpcMessage::toCpon() const
 	return m_value.toCpon();
 }
 
+namespace {
+std::string to_cpon_limited(const RpcValue &value, bool translate_ids, size_t max_len)
+{
+	std::ostringstream out;
+	{
+		CponWriterOptions opts;
+		opts.setTranslateIds(translate_ids).setMaxLength(max_len);
+		CponWriter wr(out, opts);
+		wr << value;
+	}
+	auto ret = out.str();
+	if(max_len > 0 && ret.size() > max_len)
+		ret.resize(max_len);
+	return ret;
+}
+}
+
+std::string RpcMessage::toPrettyString(size_t max_len) const
+{
+	if(!m_value.isValid())
+		return "<invalid>";
+	return to_cpon_limited(m_value, true, max_len);
+}
+
+std::string RpcMessage::toCpon(size_t max_len) const
+{
+	return to_cpon_limited(m_value, false, max_len);
+}
+
 std::string RpcMessage::toChainPack() const
 {
 	return m_value.toChainPack();
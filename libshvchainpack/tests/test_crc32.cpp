@@ -9,6 +9,8 @@
 
 #include <zlib.h>
 
+#include <random>
+
 using namespace shv::chainpack;
 using namespace std;
 using namespace std::string_literals;
@@ -61,3 +63,37 @@ DOCTEST_TEST_CASE("CRC on strings")
 	}
 }
 
+DOCTEST_TEST_CASE("CRC on random buffers of every alignment")
+{
+	std::mt19937 gen(42);
+	std::uniform_int_distribution<int> dist(0, 255);
+	vector<uint8_t> buff(4096 + 64);
+	for(auto &b : buff) {
+		b = static_cast<uint8_t>(dist(gen));
+	}
+	auto bytewise_crc = [](const uint8_t *data, size_t n) {
+		shv::chainpack::Crc32Shv3 crc;
+		for(size_t i = 0; i < n; ++i) {
+			crc.add(data[i]);
+		}
+		return crc.remainder();
+	};
+	for(size_t offset = 0; offset < 64; ++offset) {
+		for(size_t len : {0, 1, 7, 8, 15, 16, 17, 63, 64, 65, 127, 128, 200, 255, 1000, 4096}) {
+			const auto *data = buff.data() + offset;
+			shv::chainpack::Crc32Shv3 crc;
+			crc.add(data, len);
+			CAPTURE(offset);
+			CAPTURE(len);
+			REQUIRE(crc.remainder() == bytewise_crc(data, len));
+			REQUIRE(crc.remainder() == ::crc32(0L, data, static_cast<unsigned int>(len)));
+
+			// chunked add must give the same result as a single one
+			shv::chainpack::Crc32Shv3 crc2;
+			const auto half = len / 3;
+			crc2.add(data, half);
+			crc2.add(data + half, len - half);
+			REQUIRE(crc2.remainder() == crc.remainder());
+		}
+	}
+}
@@ -0,0 +1,114 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <shv/chainpack/rpcdriver.h>
+#include <shv/chainpack/rpcmessage.h>
+#include <shv/chainpack/exception.h>
+
+#include <doctest/doctest.h>
+
+#include <vector>
+
+using namespace shv::chainpack;
+using std::string;
+
+namespace {
+
+class TestDriver : public RpcDriver
+{
+public:
+	explicit TestDriver(RpcFrame::Compression compression, Rpc::ProtocolType protocol = Rpc::ProtocolType::ChainPack)
+	{
+		setClientProtocolType(protocol);
+		setFrameCompression(compression);
+	}
+
+	std::vector<RpcFrame> writtenFrames;
+protected:
+	bool isOpen() override { return true; }
+	void writeFrameData(const std::string &frame_data) override { writtenFrames.push_back(RpcFrame::fromFrameData(frame_data)); }
+	void onParseDataException(const ParseException &) override {}
+	void onRpcMessageReceived(const RpcMessage &) override {}
+};
+
+RpcResponse createResponse(size_t result_size)
+{
+	RpcResponse resp;
+	resp.setRequestId(123);
+	resp.setResult(RpcValue::String(result_size, 'x'));
+	return resp;
+}
+
+}
+
+DOCTEST_TEST_CASE("RpcDriver forwards frames between compressed and uncompressed peers")
+{
+	if (!RpcFrame::isCompressionSupported(RpcFrame::Compression::Deflate)) {
+		TestDriver peer(RpcFrame::Compression::Deflate);
+		REQUIRE(peer.frameCompression() == RpcFrame::Compression::None);
+		return;
+	}
+	const auto resp = createResponse(10000);
+
+	DOCTEST_SUBCASE("compressed frame to uncompressed peer is decompressed")
+	{
+		auto frame = resp.toRpcFrame();
+		frame.compress(RpcFrame::Compression::Deflate);
+		TestDriver peer(RpcFrame::Compression::None);
+		peer.sendRpcFrame(std::move(frame));
+		REQUIRE(peer.writtenFrames.size() == 1);
+		REQUIRE(peer.writtenFrames[0].compression() == RpcFrame::Compression::None);
+		REQUIRE(RpcResponse(peer.writtenFrames[0].toRpcMessage()).result() == resp.result());
+	}
+
+	DOCTEST_SUBCASE("compressed frame to compressing peer is forwarded as it is")
+	{
+		auto frame = resp.toRpcFrame();
+		frame.compress(RpcFrame::Compression::Deflate);
+		const auto compressed_data = frame.data;
+		TestDriver peer(RpcFrame::Compression::Deflate);
+		peer.sendRpcFrame(std::move(frame));
+		REQUIRE(peer.writtenFrames.size() == 1);
+		REQUIRE(peer.writtenFrames[0].compression() == RpcFrame::Compression::Deflate);
+		REQUIRE(peer.writtenFrames[0].data == compressed_data);
+	}
+
+	DOCTEST_SUBCASE("uncompressed frame to compressing peer is compressed")
+	{
+		TestDriver peer(RpcFrame::Compression::Deflate);
+		peer.sendRpcFrame(resp.toRpcFrame());
+		REQUIRE(peer.writtenFrames.size() == 1);
+		REQUIRE(peer.writtenFrames[0].compression() == RpcFrame::Compression::Deflate);
+		REQUIRE(RpcResponse(peer.writtenFrames[0].toRpcMessage()).result() == resp.result());
+	}
+
+	DOCTEST_SUBCASE("small frame to compressing peer is sent uncompressed")
+	{
+		const auto small_resp = createResponse(10);
+		TestDriver peer(RpcFrame::Compression::Deflate);
+		peer.sendRpcFrame(small_resp.toRpcFrame());
+		REQUIRE(peer.writtenFrames.size() == 1);
+		REQUIRE(peer.writtenFrames[0].compression() == RpcFrame::Compression::None);
+		REQUIRE(RpcResponse(peer.writtenFrames[0].toRpcMessage()).result() == small_resp.result());
+	}
+
+	DOCTEST_SUBCASE("compressed frame to cpon peer is decompressed and converted")
+	{
+		auto frame = resp.toRpcFrame();
+		frame.compress(RpcFrame::Compression::Deflate);
+		TestDriver peer(RpcFrame::Compression::None, Rpc::ProtocolType::Cpon);
+		peer.sendRpcFrame(std::move(frame));
+		REQUIRE(peer.writtenFrames.size() == 1);
+		REQUIRE(peer.writtenFrames[0].protocol == Rpc::ProtocolType::Cpon);
+		REQUIRE(peer.writtenFrames[0].compression() == RpcFrame::Compression::None);
+		REQUIRE(RpcResponse(peer.writtenFrames[0].toRpcMessage()).result() == resp.result());
+	}
+
+	DOCTEST_SUBCASE("compression bomb is not forwarded")
+	{
+		auto frame = createResponse(RpcFrame::MAX_DATA_SIZE + 1).toRpcFrame();
+		frame.compress(RpcFrame::Compression::Deflate);
+		REQUIRE(frame.compression() == RpcFrame::Compression::Deflate);
+		TestDriver peer(RpcFrame::Compression::None);
+		peer.sendRpcFrame(std::move(frame));
+		REQUIRE(peer.writtenFrames.empty());
+	}
+}
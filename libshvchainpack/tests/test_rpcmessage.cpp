@@ -114,3 +114,93 @@ DOCTEST_TEST_CASE("RpcMessage")
 	}
 
 }
+
+DOCTEST_TEST_CASE("RpcFrame compression")
+{
+	RpcResponse resp;
+	resp.setRequestId(123);
+	resp.setResult(RpcValue::String(10000, 'x'));
+	auto frame = resp.toRpcFrame();
+	const auto frame_data = frame.data;
+	REQUIRE(frame.compression() == RpcFrame::Compression::None);
+
+	if (!RpcFrame::isCompressionSupported(RpcFrame::Compression::Deflate)) {
+		frame.compress(RpcFrame::Compression::Deflate);
+		REQUIRE(frame.compression() == RpcFrame::Compression::None);
+		return;
+	}
+
+	DOCTEST_SUBCASE("round trip")
+	{
+		frame.compress(RpcFrame::Compression::Deflate);
+		REQUIRE(frame.compression() == RpcFrame::Compression::Deflate);
+		REQUIRE(frame.data.size() < frame_data.size());
+
+		auto frame2 = RpcFrame::fromFrameData(frame.toFrameData());
+		REQUIRE(frame2.compression() == RpcFrame::Compression::Deflate);
+		REQUIRE(RpcResponse(frame2.toRpcMessage()).result() == resp.result());
+		frame2.decompress();
+		REQUIRE(frame2.compression() == RpcFrame::Compression::None);
+		REQUIRE(frame2.data == frame_data);
+	}
+
+	DOCTEST_SUBCASE("corrupted data")
+	{
+		frame.compress(RpcFrame::Compression::Deflate);
+		frame.data.resize(frame.data.size() / 2);
+		string errmsg;
+		frame.toRpcMessage(&errmsg);
+		REQUIRE(!errmsg.empty());
+		REQUIRE_THROWS_AS(frame.decompress(), std::runtime_error);
+	}
+
+	DOCTEST_SUBCASE("inflated size limit")
+	{
+		frame.compress(RpcFrame::Compression::Deflate);
+		auto frame2 = frame;
+		REQUIRE_THROWS_AS(frame2.decompress(frame_data.size() - 1), std::runtime_error);
+		REQUIRE(frame2.compression() == RpcFrame::Compression::Deflate);
+		frame2.decompress(frame_data.size());
+		REQUIRE(frame2.data == frame_data);
+
+		RpcResponse big_resp;
+		big_resp.setRequestId(124);
+		big_resp.setResult(RpcValue::String(RpcFrame::MAX_DATA_SIZE + 1, 'x'));
+		auto bomb = big_resp.toRpcFrame();
+		bomb.compress(RpcFrame::Compression::Deflate);
+		REQUIRE(bomb.compression() == RpcFrame::Compression::Deflate);
+		string errmsg;
+		bomb.toRpcMessage(&errmsg);
+		REQUIRE(!errmsg.empty());
+	}
+
+	DOCTEST_SUBCASE("names")
+	{
+		REQUIRE(RpcFrame::compressionFromString(RpcFrame::compressionToString(RpcFrame::Compression::Deflate)) == RpcFrame::Compression::Deflate);
+		REQUIRE(RpcFrame::compressionFromString("foo") == RpcFrame::Compression::None);
+	}
+}
+
+DOCTEST_TEST_CASE("RpcMessage length limited string")
+{
+	RpcRequest rq;
+	rq.setRequestId(1);
+	rq.setShvPath("test");
+	rq.setMethod("foo");
+	RpcList params;
+	for(int i = 0; i < 1000; ++i)
+		params.push_back(RpcValue::Map{{"value", i}, {"text", std::string(100, 'x')}});
+	rq.setParams(params);
+
+	for(size_t max_len : {1, 10, 100, 1024}) {
+		CAPTURE(max_len);
+		REQUIRE(rq.toCpon(max_len) == rq.toCpon().substr(0, max_len));
+		REQUIRE(rq.toPrettyString(max_len) == rq.toPrettyString().substr(0, max_len));
+	}
+	REQUIRE(rq.toCpon(0) == rq.toCpon());
+
+	RpcResponse resp;
+	resp.setRequestId(2);
+	resp.setResult(RpcValue::Blob(100000, 'a'));
+	REQUIRE(resp.toCpon(50) == resp.toCpon().substr(0, 50));
+}
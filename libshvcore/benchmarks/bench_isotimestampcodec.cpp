@@ -0,0 +1,77 @@
+#include <shv/core/utils/isotimestampcodec.h>
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+using namespace shv::core::utils;
+using shv::chainpack::RpcValue;
+
+namespace {
+// journal records are mostly monotonic, consecutive timestamps share the same day
+std::vector<int64_t> make_timestamps(int64_t count)
+{
+	std::vector<int64_t> ret;
+	int64_t msec = 1700000000000LL;
+	for(int64_t i = 0; i < count; ++i) {
+		msec += 3037;
+		ret.push_back(msec);
+	}
+	return ret;
+}
+
+std::vector<std::string> make_strings(int64_t count)
+{
+	std::vector<std::string> ret;
+	for(auto ts : make_timestamps(count))
+		ret.push_back(RpcValue::DateTime::fromMSecsSinceEpoch(ts).toIsoString());
+	return ret;
+}
+
+void BM_RpcDateTime_toIsoString(benchmark::State &state)
+{
+	const auto timestamps = make_timestamps(state.range(0));
+	for(auto _ : state) {
+		for(auto ts : timestamps)
+			benchmark::DoNotOptimize(RpcValue::DateTime::fromMSecsSinceEpoch(ts).toIsoString());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RpcDateTime_toIsoString)->Arg(100000);
+
+void BM_IsoTimestampCodec_toIsoString(benchmark::State &state)
+{
+	const auto timestamps = make_timestamps(state.range(0));
+	IsoTimestampCodec codec;
+	for(auto _ : state) {
+		for(auto ts : timestamps)
+			benchmark::DoNotOptimize(codec.toIsoString(ts));
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_IsoTimestampCodec_toIsoString)->Arg(100000);
+
+void BM_RpcDateTime_fromUtcString(benchmark::State &state)
+{
+	const auto strings = make_strings(state.range(0));
+	for(auto _ : state) {
+		for(const auto &s : strings)
+			benchmark::DoNotOptimize(RpcValue::DateTime::fromUtcString(s).msecsSinceEpoch());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RpcDateTime_fromUtcString)->Arg(100000);
+
+void BM_IsoTimestampCodec_fromIsoString(benchmark::State &state)
+{
+	const auto strings = make_strings(state.range(0));
+	IsoTimestampCodec codec;
+	for(auto _ : state) {
+		for(const auto &s : strings)
+			benchmark::DoNotOptimize(codec.fromIsoString(s));
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_IsoTimestampCodec_fromIsoString)->Arg(100000);
+}
@@ -0,0 +1,47 @@
+#include <shv/core/utils/shvjournalfilereader.h>
+#include <shv/core/utils/shvjournalfilewriter.h>
+
+#include <benchmark/benchmark.h>
+
+#include <sstream>
+
+using namespace shv::core::utils;
+using namespace shv::chainpack;
+
+namespace {
+// Journal of a site with some devices, each changing few properties periodically
+std::string make_journal(int64_t entry_count)
+{
+	std::ostringstream out;
+	ShvJournalFileWriter wr(out);
+	constexpr int64_t START_MSEC = 1700000000000;
+	for(int64_t i = 0; i < entry_count; ++i) {
+		ShvJournalEntry e;
+		e.epochMsec = START_MSEC + i * 10;
+		e.path = "site/device_" + std::to_string(i % 50) + "/property_" + std::to_string(i % 7) + "/value";
+		e.value = (i % 3 == 0)? RpcValue(static_cast<double>(i) / 10): RpcValue(i);
+		e.shortTime = static_cast<int>(i % 65536);
+		e.domain = ShvJournalEntry::DOMAIN_VAL_CHANGE;
+		wr.append(e);
+	}
+	return out.str();
+}
+
+void BM_ShvJournalFileReader(benchmark::State &state)
+{
+	const auto data = make_journal(state.range(0));
+	for(auto _ : state) {
+		std::istringstream in(data);
+		ShvJournalFileReader rd(in);
+		int64_t n = 0;
+		while(rd.next()) {
+			benchmark::DoNotOptimize(rd.entry());
+			++n;
+		}
+		benchmark::DoNotOptimize(n);
+	}
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data.size()));
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ShvJournalFileReader)->Arg(1000)->Arg(100000);
+}
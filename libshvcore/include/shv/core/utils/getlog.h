@@ -5,11 +5,28 @@
 #include <shv/core/utils/shvjournalfilereader.h>
 #include <shv/core/utils/shvlogrpcvaluereader.h>
 
+#include <atomic>
+
 
 namespace shv::core::utils {
+/// Controls parsing of journal files on worker threads.
+/// Entries are still merged in file order, so the result is the same as with sequential reading.
+struct SHVCORE_DECL_EXPORT GetLogParallelism
+{
+	/// Number of worker threads, files are read sequentially on the calling thread when less than 2.
+	unsigned threadCount = 0;
+	/// Max number of files parsed ahead of the file being merged, 0 means twice the thread count.
+	unsigned readAheadFileCount = 0;
+
+	bool isParallel() const { return threadCount > 1; }
+};
+
 std::vector<int64_t>::const_iterator SHVCORE_DECL_EXPORT newestMatchingFileIt(const std::vector<int64_t>& files, const ShvGetLogParams& params);
 
 [[nodiscard]] chainpack::RpcValue SHVCORE_DECL_EXPORT getLog(const std::vector<std::function<ShvJournalFileReader()>>& readers, const ShvGetLogParams &params, const shv::chainpack::RpcValue::DateTime& now, IgnoreRecordCountLimit ignore_record_count_limit = IgnoreRecordCountLimit::No);
+/// getLog throws when cancelled is set by other thread, so that caller which is not interested in result any more
+/// does not keep worker thread busy
+[[nodiscard]] chainpack::RpcValue SHVCORE_DECL_EXPORT getLog(const std::vector<std::function<ShvJournalFileReader()>>& readers, const ShvGetLogParams &params, const shv::chainpack::RpcValue::DateTime& now, IgnoreRecordCountLimit ignore_record_count_limit, const GetLogParallelism &parallelism, const std::atomic<bool> *cancelled = nullptr);
 [[nodiscard]] chainpack::RpcValue SHVCORE_DECL_EXPORT getLog(const std::vector<std::function<ShvLogRpcValueReader()>>& readers, const ShvGetLogParams &params, const shv::chainpack::RpcValue::DateTime& now, IgnoreRecordCountLimit ignore_record_count_limit = IgnoreRecordCountLimit::No);
 [[nodiscard]] chainpack::RpcValue SHVCORE_DECL_EXPORT getLog(const std::vector<ShvJournalEntry>& entries, const ShvGetLogParams &params, const shv::chainpack::RpcValue::DateTime& now, IgnoreRecordCountLimit ignore_record_count_limit = IgnoreRecordCountLimit::No);
 }
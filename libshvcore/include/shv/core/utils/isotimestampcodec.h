@@ -0,0 +1,44 @@
+#pragma once
+
+#include <shv/core/shvcoreglobal.h>
+
+#include <shv/chainpack/rpcvalue.h>
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+namespace shv::core::utils {
+
+/// Allocation free formatting and parsing of UTC ISO date time strings like '2018-01-10T12:03:56.123Z'
+/// Date part of recently formatted and parsed timestamp is cached, since consecutive journal records
+/// almost always share the same day.
+/// Output is byte identical to RpcValue::DateTime::toIsoString() and parsing results are the same
+/// as RpcValue::DateTime::fromUtcString(), strings which do not fit the fixed format fall back to RpcValue::DateTime.
+class SHVCORE_DECL_EXPORT IsoTimestampCodec
+{
+public:
+	using MsecPolicy = shv::chainpack::RpcValue::DateTime::MsecPolicy;
+	static constexpr bool IncludeTimeZone = shv::chainpack::RpcValue::DateTime::IncludeTimeZone;
+public:
+	IsoTimestampCodec();
+
+	/// returned view points to internal buffer, it is valid until the next call of toIsoString()
+	std::string_view toIsoString(int64_t epoch_msec, MsecPolicy msec_policy = MsecPolicy::Auto, bool include_tz = IncludeTimeZone);
+	/// returns msecs since epoch, *plen is set to count of consumed characters or to 0 when str is not valid date time
+	int64_t fromIsoString(std::string_view str, size_t *plen = nullptr);
+
+	static int64_t daysFromCivil(int year, unsigned month, unsigned day);
+	static void civilFromDays(int64_t days, int &year, unsigned &month, unsigned &day);
+private:
+	static constexpr size_t DATE_PREFIX_LEN = 11; // YYYY-MM-DDT
+	static constexpr int64_t MSEC_PER_DAY = 24 * 60 * 60 * 1000;
+
+	std::array<char, 32> m_formatBuffer;
+	int64_t m_formatDay;
+
+	std::array<char, DATE_PREFIX_LEN - 1> m_parseDatePrefix;
+	int64_t m_parseDayMsec;
+};
+
+} // namespace shv::core::utils
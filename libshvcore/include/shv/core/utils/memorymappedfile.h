@@ -0,0 +1,41 @@
+#pragma once
+
+#include <shv/core/shvcoreglobal.h>
+
+#include <string>
+#include <string_view>
+
+namespace shv::core::utils {
+
+/// Read-only memory mapped file.
+/// Content is mapped with its size at the time of opening, data appended later are not visible.
+/// On platforms without mmap() support, the file content is read to memory.
+class SHVCORE_DECL_EXPORT MemoryMappedFile
+{
+public:
+	enum class AccessPattern {Normal, Sequential, Random};
+public:
+	MemoryMappedFile();
+	/// throws shv::core::Exception if the file cannot be opened or mapped
+	MemoryMappedFile(const std::string &file_name, AccessPattern access_pattern = AccessPattern::Normal);
+	MemoryMappedFile(const MemoryMappedFile &) = delete;
+	MemoryMappedFile(MemoryMappedFile &&o) noexcept;
+	~MemoryMappedFile();
+
+	MemoryMappedFile& operator=(const MemoryMappedFile &) = delete;
+	MemoryMappedFile& operator=(MemoryMappedFile &&o) noexcept;
+
+	std::string_view data() const;
+	size_t size() const;
+	bool isEmpty() const;
+private:
+	void close();
+private:
+	const char *m_data = nullptr;
+	size_t m_size = 0;
+#ifdef _WIN32
+	std::string m_buffer;
+#endif
+};
+
+} // namespace shv::core::utils
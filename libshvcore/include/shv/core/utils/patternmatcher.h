@@ -1,16 +1,25 @@
 #pragma once
 
 #include <shv/core/shvcoreglobal.h>
+#include <shv/core/stringview.h>
 
 #include <shv/core/utils/shvgetlogparams.h>
 #include <shv/core/utils/shvjournalentry.h>
 
 #include <regex>
+#include <unordered_map>
+#include <vector>
 
 namespace shv::core::utils {
 
+/// Path and domain match results are memoized per distinct path and domain,
+/// journals typically repeat small set of paths, so matching of large log
+/// costs one pattern evaluation per unique path only.
+/// Because of memoization, single PatternMatcher instance must not be used from more threads simultaneously.
 class SHVCORE_DECL_EXPORT PatternMatcher
 {
+public:
+	static constexpr size_t MAX_MATCH_CACHE_SIZE = 64 * 1024;
 public:
 	PatternMatcher() = default;
 	PatternMatcher(const ShvGetLogParams &filter);
@@ -18,15 +27,29 @@ public:
 	bool isRegexError() const;
 	bool match(const ShvJournalEntry &entry) const;
 	bool match(const std::string &path, const std::string &domain) const;
+	bool matchPath(const std::string &path) const;
+	bool matchDomain(const std::string &domain) const;
 
+private:
+	struct WildCardSegment
+	{
+		enum class Type {Literal, AnySegment, AnySegments};
+		Type type;
+		std::string text;
+	};
+	bool matchPathHelper(const std::string &path) const;
+	bool matchWildCard(const StringViewList &path_lst) const;
 private:
 	std::regex m_pathPatternRegEx;
 	bool m_usePathPatternRegEx = false;
-	std::string m_pathPatternWildCard;
+	std::vector<WildCardSegment> m_pathPatternWildCard;
 
 	std::regex m_domainPatternRegEx;
 	bool m_useDomainPatternregEx = false;
 
 	bool m_regexError = false;
+
+	mutable std::unordered_map<std::string, bool> m_pathMatchCache;
+	mutable std::unordered_map<std::string, bool> m_domainMatchCache;
 };
 }
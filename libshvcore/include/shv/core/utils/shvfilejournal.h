@@ -2,11 +2,15 @@
 
 #include <shv/core/shvcoreglobal.h>
 #include <shv/core/utils/abstractshvjournal.h>
+#include <shv/core/utils/getlog.h>
 #include <shv/core/utils/shvjournalentry.h>
+#include <shv/core/utils/shvjournalfilesummary.h>
 #include <shv/core/utils/shvgetlogparams.h>
 
+#include <atomic>
 #include <fstream>
 #include <functional>
+#include <memory>
 
 namespace shv::core::utils {
 
@@ -37,11 +41,18 @@ public:
 	std::string deviceType() const;
 	void setDeviceType(std::string type);
 	int64_t recentlyWrittenEntryDateTime() const;
+	void setGetLogParallelism(const GetLogParallelism &p);
+	const GetLogParallelism& getLogParallelism() const;
 
 	static int64_t findLastEntryDateTime(const std::string &fn, int64_t journal_start_msec, std::ifstream::pos_type *p_date_time_fpos = nullptr);
 	void append(const ShvJournalEntry &entry) override;
 
 	shv::chainpack::RpcValue getLog(const ShvGetLogParams &params, IgnoreRecordCountLimit ignore_record_count_limit = IgnoreRecordCountLimit::No) override;
+	using AsyncGetLog = std::function<shv::chainpack::RpcValue (const std::atomic<bool> &cancelled)>;
+	/// returns getLog over copy of current catalogue, which can be called on worker thread,
+	/// journal is not rotated until returned function is destroyed, so that files it reads are not deleted
+	AsyncGetLog asyncGetLog(const ShvGetLogParams &params, IgnoreRecordCountLimit ignore_record_count_limit = IgnoreRecordCountLimit::No);
+	int activeReaderCount() const;
 	shv::chainpack::RpcValue getSnapShotMap() override;
 
 	void convertLog1JournalDir();
@@ -63,8 +74,19 @@ public:
 	static constexpr int TxtColumnCount = TxtColumn::UserId + 1;
 	struct JournalContext
 	{
+		struct FileInfo
+		{
+			int64_t size = 0;
+			/// epoch msec of last entry, 0 if not known, first entry msec is part of file name
+			int64_t lastEntryMsec = 0;
+			/// size of summary sidecar file, it is part of journal size
+			int64_t summarySize = 0;
+		};
 		bool journalDirExists = false;
 		std::vector<int64_t> files;
+		/// catalogue of files in the same order as files, it is kept current by journal writes and rotation,
+		/// so journal dir is scanned again only when check is forced or external change is detected
+		std::vector<FileInfo> fileInfos;
 		int64_t journalSize = -1;
 		int64_t lastFileSize = -1;
 		int64_t recentTimeStamp = 0;
@@ -81,12 +103,16 @@ public:
 		std::string fileMsecToFilePath(int64_t file_msec) const;
 	};
 	static constexpr bool Force = true;
+	/// journal dir is scanned again when force is set or when journal files were changed by someone else
 	const JournalContext& checkJournalContext(bool force = !Force);
 	void createNewLogFile(int64_t journal_file_start_msec = 0);
-	static shv::chainpack::RpcValue getLog(const JournalContext &journal_context, const ShvGetLogParams &params, IgnoreRecordCountLimit ignore_record_count_limit = IgnoreRecordCountLimit::No);
+	/// journal context copy makes it possible to call getLog on worker thread
+	static shv::chainpack::RpcValue getLog(const JournalContext &journal_context, const ShvGetLogParams &params, IgnoreRecordCountLimit ignore_record_count_limit = IgnoreRecordCountLimit::No, const GetLogParallelism &parallelism = {}, const std::atomic<bool> *cancelled = nullptr);
 private:
 
 	void checkJournalContext_helper(bool force = false);
+	/// cheap check that first and last catalogued files were not changed externally
+	bool isCatalogueCurrent() const;
 
 	void rotateJournal();
 	void updateJournalStatus();
@@ -95,10 +121,19 @@ private:
 	bool journalDirExists();
 
 	void appendThrow(const ShvJournalEntry &entry);
+	/// entry is added to summary as file reader will return it
+	void addToLastFileSummary(ShvJournalEntry entry, int64_t written_msec);
 private:
 	JournalContext m_journalContext;
 
 	int64_t m_fileSizeLimit = DEFAULT_FILE_SIZE_LIMIT;
 	int64_t m_journalSizeLimit = DEFAULT_JOURNAL_SIZE_LIMIT;
+	GetLogParallelism m_getLogParallelism;
+	/// summary of the last file collected by appends, so that the file need not be parsed again when it is closed,
+	/// it is kept only for file created by this journal, 0 file msec means that summary is not known
+	ShvJournalFileSummary m_lastFileSummary;
+	int64_t m_lastFileSummaryFileMsec = 0;
+	/// asyncGetLog functions alive, shared with them, since they can outlive the journal
+	std::shared_ptr<std::atomic<int>> m_activeReaderCount = std::make_shared<std::atomic<int>>(0);
 };
 } // namespace shv::core::utils
@@ -2,13 +2,16 @@
 
 #include <shv/core/shvcoreglobal.h>
 #include <shv/core/utils/shvjournalentry.h>
+#include <shv/core/utils/isotimestampcodec.h>
+#include <shv/core/utils/memorymappedfile.h>
 #include <shv/core/exception.h>
 
 #include <string>
-#include <fstream>
+#include <istream>
 
 namespace shv::core::utils {
 
+/// Journal files are memory mapped and scanned in place, only the istream constructor reads data line by line.
 class SHVCORE_DECL_EXPORT ShvJournalFileReader
 {
 public:
@@ -23,12 +26,21 @@ public:
 
 	static int64_t fileNameToFileMsec(const std::string &fn, bool throw_exc = shv::core::Exception::Throw);
 	static std::string msecToBaseFileName(int64_t msec);
+	/// searches journal data backwards for the last record with valid date time
+	/// returns its msecs since epoch or -1, *p_line_pos is set to start of the record or std::string::npos
+	static int64_t findLastEntryDateTime(StringView journal_data, size_t *p_line_pos = nullptr);
+private:
+	bool nextLine(StringView &line);
+	bool parseLine(StringView line);
 private:
 	std::string m_fileName;
-	std::ifstream m_inputFileStream;
+	MemoryMappedFile m_mappedFile;
+	size_t m_dataPos = 0;
 	std::istream *m_istream = nullptr;
+	std::string m_lineBuffer;
 	ShvJournalEntry m_currentEntry;
 	int64_t m_snapshotMsec = 0;
 	bool m_inSnapshot = true;
+	IsoTimestampCodec m_timestampCodec;
 };
 } // namespace shv::core::utils
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <shv/core/shvcoreglobal.h>
+#include <shv/core/utils/abstractshvjournal.h>
+#include <shv/core/utils/shvjournalentry.h>
+
+#include <shv/chainpack/rpcvalue.h>
+
+#include <set>
+#include <string>
+
+namespace shv::core::utils {
+
+class PatternMatcher;
+
+/// Summary of a closed journal file, it is stored in a sidecar file next to the journal file.
+/// getLog uses it to skip files without any path matching the query, without parsing them.
+struct SHVCORE_DECL_EXPORT ShvJournalFileSummary
+{
+	static constexpr auto KEY_FILE_SIZE = "fileSize";
+	static constexpr auto KEY_SINCE = "since";
+	static constexpr auto KEY_UNTIL = "until";
+	static constexpr auto KEY_RECORD_COUNT = "recordCount";
+	static constexpr auto KEY_PATHS = "paths";
+	static constexpr auto KEY_DOMAINS = "domains";
+	static constexpr auto KEY_SNAPSHOT = "snapshot";
+
+	static const std::string FILE_EXT;
+
+	/// size of the summarized journal file, summary is outdated when the file size differs
+	int64_t fileSize = -1;
+	int64_t sinceMsec = 0;
+	int64_t untilMsec = 0;
+	int recordCount = 0;
+	std::set<std::string> paths;
+	std::set<std::string> domains;
+	/// snapshot at the end of the file
+	ShvSnapshot snapshot;
+
+	bool isValid() const;
+	/// adds entry as it is read from the summarized file
+	void addEntry(const ShvJournalEntry &entry);
+	/// returns false if none of file entries can match the pattern
+	bool mayContainMatch(const PatternMatcher &pattern_matcher) const;
+
+	shv::chainpack::RpcValue toRpcValue() const;
+	static ShvJournalFileSummary fromRpcValue(const shv::chainpack::RpcValue &rv);
+
+	static std::string summaryFilePath(const std::string &journal_file_path);
+	static ShvJournalFileSummary fromJournalFile(const std::string &journal_file_path);
+	/// loads summary from its sidecar file, the summary is rebuilt and saved when missing or outdated
+	static ShvJournalFileSummary forJournalFile(const std::string &journal_file_path);
+	/// returns size of written summary file
+	int64_t save(const std::string &journal_file_path) const;
+};
+
+} // namespace shv::core::utils
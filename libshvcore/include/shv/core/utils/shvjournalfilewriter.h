@@ -1,6 +1,7 @@
 #pragma once
 
 #include <shv/core/shvcoreglobal.h>
+#include <shv/core/utils/isotimestampcodec.h>
 
 #include <cstdint>
 #include <string>
@@ -35,5 +36,6 @@ private:
 	std::ofstream m_fileOut;
 	std::ostream *m_out = nullptr;
 	int64_t m_recentTimeStamp = 0;
+	IsoTimestampCodec m_timestampCodec;
 };
 } // namespace shv::core::utils
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <shv/core/utils/shvpath.h>
+
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace shv::core::utils {
+
+/// Maps shv paths to values, lookup of the longest stored prefix of a path
+/// costs time proportional to the path depth and does not allocate.
+/// Path segments are delimited by '/', empty segments are ignored.
+template<typename T>
+class ShvPathTrie
+{
+public:
+	void clear()
+	{
+		m_nodes.clear();
+	}
+
+	bool isEmpty() const
+	{
+		return m_nodes.empty();
+	}
+
+	void insert(std::string_view path, T value)
+	{
+		if(m_nodes.empty())
+			m_nodes.emplace_back();
+		size_t node_ix = 0;
+		forEachSegment(path, [this, &node_ix](std::string_view segment, size_t) {
+			auto &children = m_nodes[node_ix].children;
+			if(auto it = children.find(segment); it != children.end()) {
+				node_ix = it->second;
+			}
+			else {
+				auto child_ix = m_nodes.size();
+				children.emplace(std::string(segment), child_ix);
+				m_nodes.emplace_back();
+				node_ix = child_ix;
+			}
+			return true;
+		});
+		m_nodes[node_ix].value = std::move(value);
+	}
+
+	/// returns value of the longest stored prefix of path together with the prefix length,
+	/// returns nullptr if no prefix of path is stored
+	std::pair<const T*, size_t> findLongestPrefix(std::string_view path) const
+	{
+		if(m_nodes.empty())
+			return {nullptr, 0};
+		size_t node_ix = 0;
+		std::pair<const T*, size_t> ret{nullptr, 0};
+		if(m_nodes[0].value)
+			ret.first = &*m_nodes[0].value;
+		forEachSegment(path, [this, &node_ix, &ret](std::string_view segment, size_t segment_end) {
+			const auto &children = m_nodes[node_ix].children;
+			auto it = children.find(segment);
+			if(it == children.end())
+				return false;
+			node_ix = it->second;
+			if(const auto &value = m_nodes[node_ix].value)
+				ret = {&*value, segment_end};
+			return true;
+		});
+		return ret;
+	}
+private:
+	template<typename Fn>
+	static void forEachSegment(std::string_view path, Fn fn)
+	{
+		size_t pos = 0;
+		while(pos < path.size()) {
+			auto end = path.find(ShvPath::SHV_PATH_DELIM, pos);
+			if(end == std::string_view::npos)
+				end = path.size();
+			if(end > pos && !fn(path.substr(pos, end - pos), end))
+				return;
+			pos = end + 1;
+		}
+	}
+private:
+	struct Node
+	{
+		std::optional<T> value;
+		std::map<std::string, size_t, std::less<>> children;
+	};
+	std::vector<Node> m_nodes;
+};
+
+} // namespace shv::core::utils
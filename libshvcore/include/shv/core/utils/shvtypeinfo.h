@@ -1,11 +1,14 @@
 #pragma once
 
 #include <shv/core/shvcoreglobal.h>
+#include <shv/core/utils/shvpathtrie.h>
 
 #include <shv/chainpack/rpcvalue.h>
 
 #include <string>
 #include <functional>
+#include <mutex>
+#include <unordered_map>
 
 namespace shv::chainpack { class MetaMethod; }
 
@@ -237,6 +240,8 @@ public:
 		std::string fieldPath;
 	};
 	PathInfo pathInfo(const std::string &shv_path) const;
+	/// enables memo of recently resolved paths, 0 (default) disables it
+	void setPathInfoCacheCapacity(size_t capacity);
 
 	chainpack::RpcValue typesAsRpcValue() const;
 	chainpack::RpcValue toRpcValue() const;
@@ -249,6 +254,10 @@ public:
 	void forEachProperty(std::function<void (const std::string &shv_path, const ShvPropertyDescr &)> fn) const;
 private:
 	static ShvTypeInfo fromNodesTree(const chainpack::RpcValue &v);
+	PathInfo resolvePathInfo(const std::string &shv_path) const;
+	void buildPathIndex();
+	void buildDevicePropertyIndex(const std::string &device_type);
+	void pathIndexChanged();
 	void fromNodesTree_helper(const shv::chainpack::RpcValue::Map &node_types,
 							  const shv::chainpack::RpcValue &node,
 							  const std::string &device_type,
@@ -263,5 +272,28 @@ private:
 	std::map<std::string, std::string> m_systemPathsRoots; // shv-path-root -> system-path
 	std::map<std::string, chainpack::RpcValue> m_blacklistedPaths; // shv-path -> blacklist
 	std::map<std::string, ShvPropertyDescr> m_propertyDeviations; // should be empty, devices should not have different property descriptions for same device-type
+
+	ShvPathTrie<std::string> m_devicePathIndex; // path -> device-type-name
+	ShvPathTrie<ShvPropertyDescr> m_propertyDeviationIndex; // shv-path -> property-deviation
+	std::map<std::string, ShvPathTrie<size_t>, std::less<>> m_devicePropertyIndex; // device-type-name -> property-name -> property index
+
+	/// bounded memo of pathInfo() results, it is cleared when full or when type info changes
+	class PathInfoCache
+	{
+	public:
+		PathInfoCache() = default;
+		PathInfoCache(const PathInfoCache &other);
+		PathInfoCache& operator=(const PathInfoCache &other);
+
+		void setCapacity(size_t capacity);
+		std::optional<PathInfo> find(const std::string &shv_path) const;
+		void insert(const std::string &shv_path, const PathInfo &path_info);
+		void clear();
+	private:
+		size_t m_capacity = 0;
+		std::unordered_map<std::string, PathInfo> m_pathInfos;
+		mutable std::mutex m_mutex;
+	};
+	mutable PathInfoCache m_pathInfoCache;
 };
 } // namespace shv::core::utils
@@ -1,12 +1,18 @@
+#include <shv/core/exception.h>
 #include <shv/core/log.h>
 #include <shv/core/utils/abstractshvjournal.h>
 #include <shv/core/utils/getlog.h>
 #include <shv/core/utils/patternmatcher.h>
 #include <shv/core/utils/shvlogheader.h>
 
+#include <atomic>
 #include <concepts>
+#include <condition_variable>
+#include <exception>
 #include <functional>
+#include <mutex>
 #include <optional>
+#include <thread>
 
 #define logWGetLog() shvCWarning("GetLog")
 #define logIGetLog() shvCInfo("GetLog")
@@ -115,6 +121,182 @@ private:
 	std::optional<std::vector<ShvJournalEntry>::const_iterator> m_entriesIter;
 };
 
+// Parses journal files on worker threads and hands out the matching entries in file order.
+// Only a bounded window of files is parsed ahead of the consumer, files after the one
+// containing the `until` entry are not read at all.
+class ParallelFileLogReader {
+public:
+	ParallelFileLogReader(const std::vector<std::function<ShvJournalFileReader()>>& readers, const ShvGetLogParams& params, const GetLogParallelism& parallelism)
+		: m_state(std::make_unique<State>(readers, params, parallelism))
+	{
+		try {
+			for (unsigned i = 0; i < parallelism.threadCount; ++i) {
+				m_state->workers.emplace_back([state = m_state.get()] { state->parseFiles(); });
+			}
+		} catch (...) {
+			// destructor is not called when constructor throws, already started workers must be joined here
+			m_state->stop();
+			throw;
+		}
+	}
+	ParallelFileLogReader(ParallelFileLogReader&&) = default;
+	~ParallelFileLogReader()
+	{
+		if (m_state) {
+			m_state->stop();
+		}
+	}
+
+	bool next()
+	{
+		return m_state->next();
+	}
+	const ShvJournalEntry& entry() const
+	{
+		return m_state->entry();
+	}
+
+private:
+	struct FileResult {
+		std::vector<ShvJournalEntry> entries;
+		std::exception_ptr error;
+		bool done = false;
+	};
+
+	struct State {
+		State(const std::vector<std::function<ShvJournalFileReader()>>& readers_, const ShvGetLogParams& params_, const GetLogParallelism& parallelism)
+			: readers(readers_)
+			, params(params_)
+			, untilMsec(params_.until.isDateTime() ? params_.until.toDateTime().msecsSinceEpoch() : std::numeric_limits<int64_t>::max())
+			, readAhead(parallelism.readAheadFileCount > 0 ? parallelism.readAheadFileCount : 2 * parallelism.threadCount)
+			, results(readers_.size())
+		{
+		}
+
+		void stop()
+		{
+			{
+				std::lock_guard lock(mutex);
+				cancelled = true;
+			}
+			cond.notify_all();
+			for (auto& worker : workers) {
+				worker.join();
+			}
+			workers.clear();
+		}
+
+		void parseFiles()
+		{
+			// PatternMatcher caches are not thread safe, every worker has its own one
+			PatternMatcher pattern_matcher(params);
+			std::unique_lock lock(mutex);
+			while (true) {
+				cond.wait(lock, [this] {
+					return cancelled || nextFileToParse >= fileCountLimit() || nextFileToParse < currentFile + readAhead;
+				});
+				if (cancelled || nextFileToParse >= fileCountLimit()) {
+					return;
+				}
+				auto file_ix = nextFileToParse++;
+				lock.unlock();
+
+				FileResult result;
+				bool until_reached = false;
+				try {
+					auto reader = readers[file_ix]();
+					while (reader.next() && !cancelled.load(std::memory_order_relaxed)) {
+						const auto& entry = reader.entry();
+						if (!pattern_matcher.match(entry)) {
+							continue;
+						}
+						result.entries.push_back(entry);
+						if (entry.epochMsec >= untilMsec) {
+							until_reached = true;
+							break;
+						}
+					}
+				} catch (...) {
+					result.error = std::current_exception();
+				}
+				result.done = true;
+
+				lock.lock();
+				results[file_ix] = std::move(result);
+				if (until_reached) {
+					untilFile = std::min(untilFile, file_ix);
+				}
+				cond.notify_all();
+			}
+		}
+
+		bool next()
+		{
+			if (finished) {
+				return false;
+			}
+			if (started && ++currentEntry < results[currentFile].entries.size()) {
+				return true;
+			}
+			std::unique_lock lock(mutex);
+			while (true) {
+				if (started) {
+					// release the consumed file and let the workers move the read-ahead window
+					results[currentFile] = {};
+					currentFile++;
+					cond.notify_all();
+				}
+				started = true;
+				currentEntry = 0;
+				if (currentFile >= fileCountLimit()) {
+					finished = true;
+					return false;
+				}
+				cond.wait(lock, [this] { return results[currentFile].done; });
+				if (results[currentFile].error) {
+					std::rethrow_exception(results[currentFile].error);
+				}
+				if (!results[currentFile].entries.empty()) {
+					return true;
+				}
+			}
+		}
+
+		const ShvJournalEntry& entry() const
+		{
+			if (!started || finished) {
+				throw std::logic_error{"ParallelFileLogReader: entry() called before next()"};
+			}
+			return results[currentFile].entries[currentEntry];
+		}
+
+		// files following the one with the first entry after `until` are never needed
+		size_t fileCountLimit() const
+		{
+			return untilFile == std::numeric_limits<size_t>::max() ? results.size() : untilFile + 1;
+		}
+
+		const std::vector<std::function<ShvJournalFileReader()>>& readers;
+		const ShvGetLogParams params;
+		const int64_t untilMsec;
+		const size_t readAhead;
+
+		std::mutex mutex;
+		std::condition_variable cond;
+		std::vector<FileResult> results;
+		std::vector<std::thread> workers;
+		size_t nextFileToParse = 0;
+		size_t untilFile = std::numeric_limits<size_t>::max();
+		size_t currentFile = 0;
+		size_t currentEntry = 0;
+		bool started = false;
+		bool finished = false;
+		std::atomic<bool> cancelled = false;
+	};
+
+	std::unique_ptr<State> m_state;
+};
+
 template <typename Type>
 concept LogReader = requires(Type x)
 {
@@ -123,7 +305,7 @@ concept LogReader = requires(Type x)
 };
 
 template <LogReader Type>
-[[nodiscard]] chainpack::RpcValue impl_get_log(const std::vector<std::function<Type()>>& readers, const ShvGetLogParams& orig_params, const shv::chainpack::RpcValue::DateTime& now, IgnoreRecordCountLimit ignore_record_count_limit)
+[[nodiscard]] chainpack::RpcValue impl_get_log(const std::vector<std::function<Type()>>& readers, const ShvGetLogParams& orig_params, const shv::chainpack::RpcValue::DateTime& now, IgnoreRecordCountLimit ignore_record_count_limit, const std::atomic<bool> *cancelled = nullptr)
 {
 	logIGetLog() << "========================= getLog ==================";
 	logIGetLog() << "params:" << orig_params.toRpcValue().toCpon();
@@ -164,6 +346,9 @@ template <LogReader Type>
 	for (const auto& readerFn : readers) {
 		auto reader = readerFn();
 		while(reader.next()) {
+			if (cancelled && cancelled->load(std::memory_order_relaxed)) {
+				SHV_EXCEPTION("getLog cancelled");
+			}
 			const auto& entry = reader.entry();
 
 			if (!pattern_matcher.match(entry)) {
@@ -289,6 +474,17 @@ exit_nested_loop:
 	return impl_get_log(readers, params, now, ignore_record_count_limit);
 }
 
+[[nodiscard]] chainpack::RpcValue getLog(const std::vector<std::function<ShvJournalFileReader()>>& readers, const ShvGetLogParams& params, const shv::chainpack::RpcValue::DateTime& now, IgnoreRecordCountLimit ignore_record_count_limit, const GetLogParallelism& parallelism, const std::atomic<bool> *cancelled)
+{
+	if (!parallelism.isParallel() || readers.size() < 2) {
+		return impl_get_log(readers, params, now, ignore_record_count_limit, cancelled);
+	}
+	logMGetLog() << "Reading" << readers.size() << "files using" << parallelism.threadCount << "threads";
+	std::vector<std::function<ParallelFileLogReader()>> parallel_readers;
+	parallel_readers.emplace_back([&readers, &params, &parallelism] { return ParallelFileLogReader(readers, params, parallelism); });
+	return impl_get_log(parallel_readers, params, now, ignore_record_count_limit, cancelled);
+}
+
 [[nodiscard]] chainpack::RpcValue getLog(const std::vector<std::function<ShvLogRpcValueReader()>>& readers, const ShvGetLogParams& params, const shv::chainpack::RpcValue::DateTime& now, IgnoreRecordCountLimit ignore_record_count_limit)
 {
 	return impl_get_log(readers, params, now, ignore_record_count_limit);
@@ -0,0 +1,182 @@
+#include <shv/core/utils/isotimestampcodec.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace cp = shv::chainpack;
+
+namespace shv::core::utils {
+
+namespace {
+constexpr bool is_digit(char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+constexpr unsigned digit(char c)
+{
+	return static_cast<unsigned>(c - '0');
+}
+
+bool parse_2_digits(const char *p, unsigned &val)
+{
+	if(!is_digit(p[0]) || !is_digit(p[1]))
+		return false;
+	val = digit(p[0]) * 10 + digit(p[1]);
+	return true;
+}
+
+void write_2_digits(char *p, unsigned val)
+{
+	p[0] = static_cast<char>('0' + val / 10);
+	p[1] = static_cast<char>('0' + val % 10);
+}
+}
+
+IsoTimestampCodec::IsoTimestampCodec()
+	: m_formatDay(std::numeric_limits<int64_t>::min())
+	, m_parseDayMsec(std::numeric_limits<int64_t>::min())
+{
+	m_formatBuffer.fill(0);
+	m_parseDatePrefix.fill(0);
+}
+
+// days_from_civil() and civil_from_days() algorithms by Howard Hinnant
+// http://howardhinnant.github.io/date_algorithms.html
+int64_t IsoTimestampCodec::daysFromCivil(int year, unsigned month, unsigned day)
+{
+	int64_t y = year;
+	y -= month <= 2;
+	const int64_t era = (y >= 0 ? y : y - 399) / 400;
+	const auto yoe = static_cast<unsigned>(y - era * 400);                    // [0, 399]
+	const unsigned doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;  // [0, 365]
+	const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;               // [0, 146096]
+	return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+void IsoTimestampCodec::civilFromDays(int64_t days, int &year, unsigned &month, unsigned &day)
+{
+	days += 719468;
+	const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+	const auto doe = static_cast<unsigned>(days - era * 146097);              // [0, 146096]
+	const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365; // [0, 399]
+	const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);              // [0, 365]
+	const unsigned mp = (5 * doy + 2) / 153;                                   // [0, 11]
+	day = doy - (153 * mp + 2) / 5 + 1;                                        // [1, 31]
+	month = mp < 10 ? mp + 3 : mp - 9;                                         // [1, 12]
+	year = static_cast<int>(static_cast<int64_t>(yoe) + era * 400 + (month <= 2));
+}
+
+std::string_view IsoTimestampCodec::toIsoString(int64_t epoch_msec, MsecPolicy msec_policy, bool include_tz)
+{
+	auto fallback = [this, epoch_msec, msec_policy, include_tz]() {
+		auto s = cp::RpcValue::DateTime::fromMSecsSinceEpoch(epoch_msec).toIsoString(msec_policy, include_tz);
+		auto len = std::min(s.size(), m_formatBuffer.size());
+		std::memcpy(m_formatBuffer.data(), s.data(), len);
+		m_formatDay = std::numeric_limits<int64_t>::min();
+		return std::string_view(m_formatBuffer.data(), len);
+	};
+	if(epoch_msec < 0)
+		return fallback();
+	const int64_t day = epoch_msec / MSEC_PER_DAY;
+	if(day != m_formatDay) {
+		int year;
+		unsigned month;
+		unsigned mday;
+		civilFromDays(day, year, month, mday);
+		if(year > 9999)
+			return fallback();
+		char *p = m_formatBuffer.data();
+		write_2_digits(p, static_cast<unsigned>(year) / 100);
+		write_2_digits(p + 2, static_cast<unsigned>(year) % 100);
+		p[4] = '-';
+		write_2_digits(p + 5, month);
+		p[7] = '-';
+		write_2_digits(p + 8, mday);
+		p[10] = 'T';
+		m_formatDay = day;
+	}
+	const auto day_msec = static_cast<unsigned>(epoch_msec - day * MSEC_PER_DAY);
+	const unsigned msec = day_msec % 1000;
+	const unsigned day_sec = day_msec / 1000;
+	char *p = m_formatBuffer.data() + DATE_PREFIX_LEN;
+	write_2_digits(p, day_sec / 3600);
+	p[2] = ':';
+	write_2_digits(p + 3, (day_sec / 60) % 60);
+	p[5] = ':';
+	write_2_digits(p + 6, day_sec % 60);
+	p += 8;
+	if((msec > 0 && msec_policy == MsecPolicy::Auto) || msec_policy == MsecPolicy::Always) {
+		*p++ = '.';
+		*p++ = static_cast<char>('0' + msec / 100);
+		write_2_digits(p, msec % 100);
+		p += 2;
+	}
+	if(include_tz)
+		*p++ = 'Z';
+	return std::string_view(m_formatBuffer.data(), static_cast<size_t>(p - m_formatBuffer.data()));
+}
+
+int64_t IsoTimestampCodec::fromIsoString(std::string_view str, size_t *plen)
+{
+	// fast path for YYYY-MM-DDTHH:MM:SS[.mmm][Z]
+	auto fallback = [str, plen]() {
+		size_t len;
+		auto dt = cp::RpcValue::DateTime::fromUtcString(std::string(str), &len);
+		if(plen)
+			*plen = len;
+		return len == 0? 0: dt.msecsSinceEpoch();
+	};
+	static constexpr size_t SEC_END_POS = 19;
+	if(str.size() < SEC_END_POS)
+		return fallback();
+	const char *s = str.data();
+	if(std::memcmp(s, m_parseDatePrefix.data(), m_parseDatePrefix.size()) != 0 || m_parseDayMsec == std::numeric_limits<int64_t>::min()) {
+		unsigned y1;
+		unsigned y2;
+		unsigned month;
+		unsigned mday;
+		if(!parse_2_digits(s, y1) || !parse_2_digits(s + 2, y2) || s[4] != '-'
+				|| !parse_2_digits(s + 5, month) || s[7] != '-'
+				|| !parse_2_digits(s + 8, mday))
+			return fallback();
+		if(month < 1 || month > 12 || mday < 1 || mday > 31)
+			return fallback();
+		m_parseDayMsec = daysFromCivil(static_cast<int>(y1 * 100 + y2), month, mday) * MSEC_PER_DAY;
+		std::memcpy(m_parseDatePrefix.data(), s, m_parseDatePrefix.size());
+	}
+	unsigned hour;
+	unsigned min;
+	unsigned sec;
+	if(!(s[10] == 'T' || s[10] == ' ')
+			|| !parse_2_digits(s + 11, hour) || s[13] != ':'
+			|| !parse_2_digits(s + 14, min) || s[16] != ':'
+			|| !parse_2_digits(s + 17, sec))
+		return fallback();
+	if(hour > 23 || min > 59 || sec > 59)
+		return fallback();
+	size_t pos = SEC_END_POS;
+	if(pos < str.size() && is_digit(s[pos]))
+		return fallback();
+	unsigned msec = 0;
+	if(pos < str.size() && s[pos] == '.') {
+		if(pos + 4 > str.size() || !is_digit(s[pos + 1]) || !is_digit(s[pos + 2]) || !is_digit(s[pos + 3]))
+			return fallback();
+		if(pos + 4 < str.size() && is_digit(s[pos + 4]))
+			return fallback();
+		msec = digit(s[pos + 1]) * 100 + digit(s[pos + 2]) * 10 + digit(s[pos + 3]);
+		pos += 4;
+	}
+	if(pos < str.size()) {
+		if(s[pos] == 'Z')
+			pos++;
+		else if(s[pos] == '+' || s[pos] == '-')
+			return fallback(); // time zone offset
+	}
+	if(plen)
+		*plen = pos;
+	return m_parseDayMsec + ((static_cast<int64_t>(hour) * 60 + min) * 60 + sec) * 1000 + msec;
+}
+
+} // namespace shv::core::utils
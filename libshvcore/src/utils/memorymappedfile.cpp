@@ -0,0 +1,128 @@
+#include <shv/core/utils/memorymappedfile.h>
+
+#include <shv/core/exception.h>
+
+#ifdef _WIN32
+#include <fstream>
+#include <sstream>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace shv::core::utils {
+
+MemoryMappedFile::MemoryMappedFile() = default;
+
+#ifdef _WIN32
+MemoryMappedFile::MemoryMappedFile(const std::string &file_name, AccessPattern access_pattern)
+{
+	(void)access_pattern;
+	std::ifstream in(file_name, std::ios::in | std::ios::binary);
+	if(!in)
+		SHV_EXCEPTION("Cannot open file " + file_name + " for reading.");
+	std::ostringstream ss;
+	ss << in.rdbuf();
+	m_buffer = std::move(ss).str();
+	m_data = m_buffer.data();
+	m_size = m_buffer.size();
+}
+
+void MemoryMappedFile::close()
+{
+	m_buffer.clear();
+	m_data = nullptr;
+	m_size = 0;
+}
+#else
+MemoryMappedFile::MemoryMappedFile(const std::string &file_name, AccessPattern access_pattern)
+{
+	int fd = ::open(file_name.c_str(), O_RDONLY | O_CLOEXEC);
+	if(fd < 0)
+		SHV_EXCEPTION("Cannot open file " + file_name + " for reading: " + std::strerror(errno));
+	struct stat st;
+	if(::fstat(fd, &st) < 0) {
+		auto err = errno;
+		::close(fd);
+		SHV_EXCEPTION("Cannot stat file " + file_name + ": " + std::strerror(err));
+	}
+	m_size = static_cast<size_t>(st.st_size);
+	if(m_size > 0) {
+		void *addr = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if(addr == MAP_FAILED) {
+			auto err = errno;
+			::close(fd);
+			m_size = 0;
+			SHV_EXCEPTION("Cannot map file " + file_name + ": " + std::strerror(err));
+		}
+		m_data = static_cast<const char*>(addr);
+		switch (access_pattern) {
+		case AccessPattern::Normal: break;
+		case AccessPattern::Sequential: ::madvise(addr, m_size, MADV_SEQUENTIAL); break;
+		case AccessPattern::Random: ::madvise(addr, m_size, MADV_RANDOM); break;
+		}
+	}
+	// mapping stays valid after the descriptor is closed
+	::close(fd);
+}
+
+void MemoryMappedFile::close()
+{
+	if(m_data)
+		::munmap(const_cast<char*>(m_data), m_size);
+	m_data = nullptr;
+	m_size = 0;
+}
+#endif
+
+MemoryMappedFile::MemoryMappedFile(MemoryMappedFile &&o) noexcept
+{
+	*this = std::move(o);
+}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+	close();
+}
+
+MemoryMappedFile &MemoryMappedFile::operator=(MemoryMappedFile &&o) noexcept
+{
+	if(this != &o) {
+		close();
+#ifdef _WIN32
+		m_buffer = std::move(o.m_buffer);
+		m_data = m_buffer.data();
+		m_size = m_buffer.size();
+		o.m_data = nullptr;
+		o.m_size = 0;
+#else
+		m_data = o.m_data;
+		m_size = o.m_size;
+		o.m_data = nullptr;
+		o.m_size = 0;
+#endif
+	}
+	return *this;
+}
+
+std::string_view MemoryMappedFile::data() const
+{
+	return std::string_view(m_data, m_size);
+}
+
+size_t MemoryMappedFile::size() const
+{
+	return m_size;
+}
+
+bool MemoryMappedFile::isEmpty() const
+{
+	return m_size == 0;
+}
+
+} // namespace shv::core::utils
@@ -27,7 +27,15 @@ PatternMatcher::PatternMatcher(const ShvGetLogParams &filter)
 		}
 		else {
 			shvDebug() << "\t wildcard";
-			m_pathPatternWildCard = filter.pathPattern;
+			// pre-compile pattern to segments, so it need not to be split for every matched path
+			for(auto &segment : shv::core::utils::split(filter.pathPattern, ShvPath::SHV_PATH_DELIM)) {
+				auto type = WildCardSegment::Type::Literal;
+				if(segment == "*")
+					type = WildCardSegment::Type::AnySegment;
+				else if(segment == "**")
+					type = WildCardSegment::Type::AnySegments;
+				m_pathPatternWildCard.push_back(WildCardSegment{type, std::move(segment)});
+			}
 			shvDebug() << "\t\t OK";
 		}
 	}
@@ -64,22 +72,82 @@ bool PatternMatcher::match(const std::string &path, const std::string &domain) c
 	if(isEmpty()) {
 		return true;
 	}
+	return matchPath(path) && matchDomain(domain);
+}
+
+bool PatternMatcher::matchPath(const std::string &path) const
+{
+	if(!m_usePathPatternRegEx && m_pathPatternWildCard.empty())
+		return true;
+	if(auto it = m_pathMatchCache.find(path); it != m_pathMatchCache.end())
+		return it->second;
+	bool ret = matchPathHelper(path);
+	if(m_pathMatchCache.size() < MAX_MATCH_CACHE_SIZE)
+		m_pathMatchCache.emplace(path, ret);
+	return ret;
+}
+
+bool PatternMatcher::matchDomain(const std::string &domain) const
+{
+	if(!m_useDomainPatternregEx)
+		return true;
+	if(auto it = m_domainMatchCache.find(domain); it != m_domainMatchCache.end())
+		return it->second;
+	bool ret = std::regex_match(domain, m_domainPatternRegEx);
+	if(m_domainMatchCache.size() < MAX_MATCH_CACHE_SIZE)
+		m_domainMatchCache.emplace(domain, ret);
+	return ret;
+}
+
+bool PatternMatcher::matchPathHelper(const std::string &path) const
+{
 	if(m_usePathPatternRegEx) {
 		std::smatch cmatch;
-		if(!std::regex_search(path, cmatch, m_pathPatternRegEx))
-			return false;
+		return std::regex_search(path, cmatch, m_pathPatternRegEx);
 	}
-	else if(!m_pathPatternWildCard.empty()) {
-		const shv::core::StringViewList path_lst = shv::core::utils::ShvPath::split(path);
-		const shv::core::StringViewList pattern_lst = shv::core::utils::split(std::string_view{m_pathPatternWildCard}, '/');
-		if(!ShvPath::matchWild(path_lst, pattern_lst))
+	return matchWildCard(ShvPath::splitPath(path));
+}
+
+bool PatternMatcher::matchWildCard(const StringViewList &path_lst) const
+{
+	// same semantics as ShvPath::matchWild(), but on pre-compiled pattern segments
+	const auto &pattern_lst = m_pathPatternWildCard;
+	size_t ptix = 0;
+	size_t phix = 0;
+	while(true) {
+		if(phix == path_lst.size() && ptix == pattern_lst.size())
+			return true;
+		if(ptix == pattern_lst.size() && phix < path_lst.size())
 			return false;
+		if(phix == path_lst.size() && ptix == pattern_lst.size() - 1 && pattern_lst[ptix].type == WildCardSegment::Type::AnySegments)
+			return true;
+		if(phix == path_lst.size() && ptix < pattern_lst.size())
+			return false;
+		const WildCardSegment &pt = pattern_lst[ptix];
+		if(pt.type == WildCardSegment::Type::AnySegment) {
+			// match exactly one path segment
+		}
+		else if(pt.type == WildCardSegment::Type::AnySegments) {
+			// match zero or more path segments
+			ptix++;
+			if(ptix == pattern_lst.size())
+				return true;
+			const std::string &pt2 = pattern_lst[ptix].text;
+			do {
+				if(path_lst[phix] == pt2)
+					break;
+				phix++;
+			} while(phix < path_lst.size());
+			if(phix == path_lst.size())
+				return false;
+		}
+		else {
+			if(!(path_lst[phix] == pt.text))
+				return false;
+		}
+		ptix++;
+		phix++;
 	}
-	if(m_useDomainPatternregEx) {
-		return std::regex_match(domain, m_domainPatternRegEx);
-	}
-	return true;
 }
 
 }
-
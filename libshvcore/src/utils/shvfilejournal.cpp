@@ -5,6 +5,8 @@
 #include <shv/core/utils/patternmatcher.h>
 #include <shv/core/utils/shvjournalfilewriter.h>
 #include <shv/core/utils/shvjournalfilereader.h>
+#include <shv/core/utils/shvjournalfilesummary.h>
+#include <shv/core/utils/memorymappedfile.h>
 #include <shv/core/utils/shvlogheader.h>
 
 #include <shv/core/log.h>
@@ -17,6 +19,7 @@
 #include <fstream>
 #include <sstream>
 #include <algorithm>
+#include <map>
 
 #define logWShvJournal() shvCWarning("ShvJournal")
 #define logIShvJournal() shvCInfo("ShvJournal")
@@ -195,6 +198,16 @@ int64_t ShvFileJournal::recentlyWrittenEntryDateTime() const
 	return m_journalContext.recentTimeStamp;
 }
 
+void ShvFileJournal::setGetLogParallelism(const GetLogParallelism &p)
+{
+	m_getLogParallelism = p;
+}
+
+const GetLogParallelism& ShvFileJournal::getLogParallelism() const
+{
+	return m_getLogParallelism;
+}
+
 
 void ShvFileJournal::setJournalSizeLimit(const std::string &n)
 {
@@ -209,6 +222,8 @@ void ShvFileJournal::append(const ShvJournalEntry &entry)
 	}
 	catch (std::exception &e) {
 		logIShvJournal() << "Append to log failed, journal dir will be read again, SD card might be replaced:" << e.what();
+		// entry might be written partially
+		m_lastFileSummaryFileMsec = 0;
 	}
 	try {
 		createJournalDirIfNotExist();
@@ -251,9 +266,12 @@ void ShvFileJournal::appendThrow(const ShvJournalEntry &entry)
 	auto orig_fsz = wr.fileSize();
 	wr.appendMonotonic(e);
 	m_journalContext.recentTimeStamp = wr.recentTimeStamp();
+	if(m_lastFileSummaryFileMsec == journal_file_start_msec)
+		addToLastFileSummary(e, wr.recentTimeStamp());
 	auto new_fsz = wr.fileSize();
 	m_journalContext.lastFileSize = new_fsz;
 	m_journalContext.journalSize += new_fsz - orig_fsz;
+	m_journalContext.fileInfos.back() = {.size = new_fsz, .lastEntryMsec = m_journalContext.recentTimeStamp};
 	if(m_journalContext.journalSize > m_journalSizeLimit) {
 		rotateJournal();
 	}
@@ -267,18 +285,59 @@ void ShvFileJournal::createNewLogFile(int64_t journal_file_start_msec)
 		if(!m_journalContext.files.empty() && m_journalContext.files[m_journalContext.files.size() - 1] >= journal_file_start_msec)
 			SHV_EXCEPTION("Journal context corrupted, new log file is older than last existing one.");
 	}
+	if(!m_journalContext.files.empty() && m_journalContext.fileInfos.back().summarySize == 0
+	   && m_lastFileSummaryFileMsec == m_journalContext.files.back() && m_lastFileSummary.recordCount > 0) {
+		// previous file is closed now, its summary collected by appends is saved here, so that it is part of journal size,
+		// summary is replaced atomically, getLog running on worker thread never reads it partially written,
+		// summary of file not written by this journal is created by getLog when needed
+		const auto closed_file_path = m_journalContext.fileMsecToFilePath(m_journalContext.files.back());
+		m_lastFileSummary.fileSize = m_journalContext.fileInfos.back().size;
+		try {
+			auto summary_size = m_lastFileSummary.save(closed_file_path);
+			m_journalContext.fileInfos.back().summarySize = summary_size;
+			m_journalContext.journalSize += summary_size;
+		}
+		catch (const std::exception &e) {
+			logWShvJournal() << "Cannot save summary of file:" << closed_file_path << e.what();
+		}
+	}
 	ShvJournalFileWriter wr(journalDir(), journal_file_start_msec, journal_file_start_msec);
 	logMShvJournal() << "New log file:" << wr.fileName() << "created.";
 	// new file should start with snapshot
 	logDShvJournal() << "Writing snapshot, entries count:" << m_snapshot.keyvals.size();
 	wr.appendSnapshot(journal_file_start_msec, m_snapshot.keyvals);
+	m_lastFileSummary = {};
+	m_lastFileSummaryFileMsec = journal_file_start_msec;
+	for(const auto &kv : m_snapshot.keyvals) {
+		// the same flags as ShvJournalFileWriter::appendSnapshot() writes
+		ShvJournalEntry e = kv.second;
+		e.setSnapshotValue(true);
+		e.setSpontaneous(false);
+		addToLastFileSummary(e, journal_file_start_msec);
+	}
+	int64_t fsz = wr.fileSize();
 	m_journalContext.files.push_back(journal_file_start_msec);
+	m_journalContext.fileInfos.push_back({.size = fsz, .lastEntryMsec = journal_file_start_msec});
+	m_journalContext.lastFileSize = fsz;
+	m_journalContext.journalSize += fsz;
 	m_journalContext.recentTimeStamp = journal_file_start_msec;
 }
 
+void ShvFileJournal::addToLastFileSummary(ShvJournalEntry entry, int64_t written_msec)
+{
+	if(entry.path.empty())
+		return;
+	entry.epochMsec = written_msec;
+	if(entry.domain.empty())
+		entry.domain = ShvJournalEntry::DOMAIN_VAL_CHANGE;
+	if(entry.shortTime < 0)
+		entry.shortTime = ShvJournalEntry::NO_SHORT_TIME;
+	m_lastFileSummary.addEntry(entry);
+}
+
 bool ShvFileJournal::JournalContext::isConsistent() const
 {
-	return journalDirExists && journalSize >= 0;
+	return journalDirExists && journalSize >= 0 && fileInfos.size() == files.size();
 }
 
 int64_t ShvFileJournal::JournalContext::fileNameToFileMsec(const std::string &fn)
@@ -307,6 +366,8 @@ void ShvFileJournal::checkJournalContext_helper(bool force)
 	if(!m_journalContext.isConsistent() || force) {
 		logMShvJournal() << "journal context not consistent or check forced, check forced:" << force;
 		m_journalContext.recentTimeStamp = 0;
+		// last file might be changed by someone else
+		m_lastFileSummaryFileMsec = 0;
 		m_journalContext.journalDirExists = journalDirExists();
 		if(!m_journalContext.journalDirExists)
 			createJournalDirIfNotExist();
@@ -339,22 +400,32 @@ bool ShvFileJournal::journalDirExists()
 
 void ShvFileJournal::rotateJournal()
 {
+	if(*m_activeReaderCount > 0) {
+		// getLog on worker thread might read any of catalogued files, rotation is retried on next append
+		logMShvJournal() << "Rotation of journal of size:" << m_journalContext.journalSize << "postponed, active readers:" << *m_activeReaderCount;
+		return;
+	}
 	logMShvJournal() << "Rotating journal of size:" << m_journalContext.journalSize;
-	updateJournalStatus();
-	size_t file_cnt = m_journalContext.files.size();
-	for(int64_t file_msec : m_journalContext.files) {
-		if(file_cnt == 1) {
-			/// keep at least one file in case of bad limits configuration
+	// catalogue is current, journal dir does not need to be scanned again
+	size_t removed_cnt = 0;
+	/// keep at least one file in case of bad limits configuration
+	while(removed_cnt + 1 < m_journalContext.files.size() && m_journalContext.journalSize >= m_journalSizeLimit) {
+		std::string fn = m_journalContext.fileMsecToFilePath(m_journalContext.files[removed_cnt]);
+		logMShvJournal() << "\t deleting file:" << fn;
+		if(rm_file(fn) == 0 && path_exists(fn)) {
+			logWShvJournal() << "Cannot delete file:" << fn << "journal dir will be read again";
+			m_journalContext.journalSize = -1;
 			break;
 		}
-		if(m_journalContext.journalSize < m_journalSizeLimit)
-			break;
-		std::string fn = m_journalContext.fileMsecToFilePath(file_msec);
-		logMShvJournal() << "\t deleting file:" << fn;
-		m_journalContext.journalSize -= rm_file(fn);
-		file_cnt--;
+		m_journalContext.journalSize -= m_journalContext.fileInfos[removed_cnt].size;
+		// summary created by getLog after the dir scan is not accounted, it is deleted anyway
+		m_journalContext.journalSize -= m_journalContext.fileInfos[removed_cnt].summarySize;
+		if(path_exists(ShvJournalFileSummary::summaryFilePath(fn)))
+			rm_file(ShvJournalFileSummary::summaryFilePath(fn));
+		removed_cnt++;
 	}
-	updateJournalStatus();
+	m_journalContext.files.erase(m_journalContext.files.begin(), m_journalContext.files.begin() + static_cast<std::ptrdiff_t>(removed_cnt));
+	m_journalContext.fileInfos.erase(m_journalContext.fileInfos.begin(), m_journalContext.fileInfos.begin() + static_cast<std::ptrdiff_t>(removed_cnt));
 	logMShvJournal() << "New journal of size:" << m_journalContext.journalSize;
 }
 
@@ -423,7 +494,8 @@ void ShvFileJournal::updateJournalStatus()
 	m_journalContext.journalSize = 0;
 	m_journalContext.lastFileSize = 0;
 	m_journalContext.files.clear();
-	int64_t max_file_msec = -1;
+	m_journalContext.fileInfos.clear();
+	std::vector<std::pair<int64_t, JournalContext::FileInfo>> catalogue;
 	std::error_code code;
 	auto dir_iter = std::filesystem::directory_iterator(m_journalContext.journalDir.c_str(), code);
 	if (code) {
@@ -432,28 +504,47 @@ void ShvFileJournal::updateJournalStatus()
 	}
 	m_journalContext.journalSize = 0;
 	const std::string &ext = FILE_EXT;
+	const std::string summary_ext = ext + ShvJournalFileSummary::FILE_EXT;
+	std::map<std::string, int64_t> summary_sizes;
 	for (const auto& entry : dir_iter) {
 		if(!entry.is_regular_file()) {
 			continue;
 		}
 		std::string fn = entry.path().filename().string();
+		if(fn.ends_with(summary_ext)) {
+			summary_sizes[fn.substr(0, fn.size() - ShvJournalFileSummary::FILE_EXT.size())] = file_size(m_journalContext.journalDir + '/' + fn);
+			continue;
+		}
 		if(!fn.ends_with(ext))
 			continue;
 		try {
 			int64_t msec = m_journalContext.fileNameToFileMsec(fn);
-			m_journalContext.files.push_back(msec);
-			fn = m_journalContext.journalDir + '/' + fn;
-			int64_t sz = file_size(fn);
-			if(msec > max_file_msec) {
-				max_file_msec = msec;
-				m_journalContext.lastFileSize = sz;
-			}
+			int64_t sz = file_size(m_journalContext.journalDir + '/' + fn);
+			catalogue.emplace_back(msec, JournalContext::FileInfo{.size = sz});
 			m_journalContext.journalSize += sz;
 		} catch (std::logic_error &e) {
 			shvWarning() << "Mallformated shv journal file name" << fn << e.what();
 		}
 	}
-	std::sort(m_journalContext.files.begin(), m_journalContext.files.end());
+	std::sort(catalogue.begin(), catalogue.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+	m_journalContext.files.reserve(catalogue.size());
+	m_journalContext.fileInfos.reserve(catalogue.size());
+	for(auto &[msec, info] : catalogue) {
+		if(auto it = summary_sizes.find(m_journalContext.fileMsecToFileName(msec)); it != summary_sizes.end()) {
+			info.summarySize = it->second;
+			m_journalContext.journalSize += it->second;
+			summary_sizes.erase(it);
+		}
+		m_journalContext.files.push_back(msec);
+		m_journalContext.fileInfos.push_back(info);
+	}
+	for(const auto &[fn, sz] : summary_sizes) {
+		// log file was deleted by someone else
+		logMShvJournal() << "deleting summary of not existing file:" << fn;
+		rm_file(m_journalContext.journalDir + '/' + fn + ShvJournalFileSummary::FILE_EXT);
+	}
+	if(!catalogue.empty())
+		m_journalContext.lastFileSize = catalogue.back().second.size;
 	logMShvJournal() << "journal dir contains:" << m_journalContext.files.size() << "files";
 	if(!m_journalContext.files.empty()) {
 		logMShvJournal() << "first file:"
@@ -486,91 +577,28 @@ void ShvFileJournal::checkRecentTimeStamp()
 			logWShvJournal() << "corrupted log file:" << fn;
 			m_journalContext.recentTimeStamp = 0;
 		}
+		m_journalContext.fileInfos.back().lastEntryMsec = m_journalContext.recentTimeStamp;
 	}
 }
 
 int64_t ShvFileJournal::findLastEntryDateTime(const std::string &fn, int64_t journal_start_msec, std::ifstream::pos_type *p_date_time_fpos)
 {
 	shvLogFuncFrame() << "'" + fn + "'";
-	std::ifstream::pos_type date_time_fpos = -1;
 	if(p_date_time_fpos)
-		*p_date_time_fpos = date_time_fpos;
-	std::ifstream in(fn, std::ios::in | std::ios::binary);
-	if (!in)
-		SHV_EXCEPTION("Cannot open file: " + fn + " for reading.");
-	int64_t dt_msec = -1;
-	in.seekg(0, std::ios::end);
-	auto fpos = in.tellg();
-	if(fpos == 0) {
+		*p_date_time_fpos = -1;
+	MemoryMappedFile file(fn, MemoryMappedFile::AccessPattern::Random);
+	if(file.isEmpty()) {
 		// empty file
 		return journal_start_msec;
 	}
-	static constexpr int TS_LEN = 30;
-	static constexpr int CHUNK_LEN = 512;
-	std::array<char, CHUNK_LEN + TS_LEN> buff;
 	logDShvJournal() << "------------------findLastEntryDateTime-----------------------------" << fn;
-	while(fpos > 0) {
-		in.seekg(-CHUNK_LEN, std::ios::cur);
-		fpos = in.tellg();
-		if(fpos < 0) {
-			in.clear();
-			in.seekg(0);
-			fpos = 0;
-		}
-		// date time string can be partialy on end of this chunk and at beggining of next,
-		// read little bit more data to cover this
-		// serialized date-time should never exceed 28 bytes see: 2018-01-10T12:03:56.123+0130
-		in.read(buff.data(), buff.size());
-		auto n = in.gcount();
-		if(in.eof()) {
-			in.clear();
-			in.seekg(-n, std::ios::end);
-		}
-		else {
-			in.seekg(-n, std::ios::cur);
-		}
-		if(n == 0)
-			break;
-
-		std::string chunk(buff.data(), static_cast<size_t>(n));
-		logDShvJournal() << "fpos:" << fpos << "chunk:" << chunk;
-		size_t line_start_pos = 0;
-
-		auto pos = chunk.length() - 1;
-		// remove trailing blanks, like trailing '\n' in log file
-		for(; pos > 0; --pos)
-			if(!(chunk[pos] == '\n' || chunk[pos] == '\t' || chunk[pos] == ' '))
-				break;
-		line_start_pos = chunk.rfind(RECORD_SEPARATOR, pos);
-		if(line_start_pos != std::string::npos)
-			line_start_pos++;
-
-		if(line_start_pos != std::string::npos) {
-			auto tab_pos = chunk.find(FIELD_SEPARATOR, line_start_pos);
-			if(tab_pos != std::string::npos) {
-				std::string s = chunk.substr(line_start_pos, tab_pos - line_start_pos);
-				logDShvJournal() << "\t checking:" << s;
-				size_t len;
-				chainpack::RpcValue::DateTime dt = chainpack::RpcValue::DateTime::fromUtcString(s, &len);
-				if(len > 0) {
-					date_time_fpos = fpos + static_cast<decltype(fpos)>(line_start_pos);
-					dt_msec = dt.msecsSinceEpoch();
-				}
-				else {
-					logWShvJournal() << fn << "Malformed shv journal date time:" << s << "will be ignored.";
-				}
-			}
-			else if(chunk.size() > line_start_pos) {
-				logWShvJournal() << fn << "Truncated shv journal date time:" << chunk.substr(line_start_pos) << "will be ignored.";
-			}
-		}
-
-		if(dt_msec > 0) {
-			logDShvJournal() << "\t return:" << dt_msec << chainpack::RpcValue::DateTime::fromMSecsSinceEpoch(dt_msec).toIsoString();
-			if(p_date_time_fpos)
-				*p_date_time_fpos = date_time_fpos;
-			return dt_msec;
-		}
+	size_t line_pos;
+	int64_t dt_msec = ShvJournalFileReader::findLastEntryDateTime(file.data(), &line_pos);
+	if(dt_msec > 0) {
+		logDShvJournal() << "\t return:" << dt_msec << chainpack::RpcValue::DateTime::fromMSecsSinceEpoch(dt_msec).toIsoString();
+		if(p_date_time_fpos)
+			*p_date_time_fpos = static_cast<std::streamoff>(line_pos);
+		return dt_msec;
 	}
 	logWShvJournal() << fn << "File does not contain record with valid date time";
 	return -1;
@@ -580,7 +608,9 @@ const ShvFileJournal::JournalContext &ShvFileJournal::checkJournalContext(bool f
 {
 	if(!force) try {
 		checkJournalContext_helper(false);
-		return m_journalContext;
+		if(isCatalogueCurrent())
+			return m_journalContext;
+		logIShvJournal() << "Journal files were changed externally, journal dir will be read again";
 	}
 	catch (std::exception &e) {
 		logIShvJournal() << "Check journal consistecy failed, journal dir will be read again, SD card might be replaced, error:" << e.what();
@@ -589,24 +619,70 @@ const ShvFileJournal::JournalContext &ShvFileJournal::checkJournalContext(bool f
 	return m_journalContext;
 }
 
+bool ShvFileJournal::isCatalogueCurrent() const
+{
+	const auto &ctx = m_journalContext;
+	if(ctx.files.empty())
+		return true;
+	std::error_code code;
+	auto last_file_size = std::filesystem::file_size(ctx.fileMsecToFilePath(ctx.files.back()), code);
+	if(code || static_cast<int64_t>(last_file_size) != ctx.fileInfos.back().size)
+		return false;
+	return std::filesystem::exists(ctx.fileMsecToFilePath(ctx.files.front()), code);
+}
+
 chainpack::RpcValue ShvFileJournal::getLog(const ShvGetLogParams &params, IgnoreRecordCountLimit ignore_record_count_limit)
 {
-	return ShvFileJournal::getLog(checkJournalContext(), params, ignore_record_count_limit);
+	return ShvFileJournal::getLog(checkJournalContext(), params, ignore_record_count_limit, m_getLogParallelism);
+}
+
+ShvFileJournal::AsyncGetLog ShvFileJournal::asyncGetLog(const ShvGetLogParams &params, IgnoreRecordCountLimit ignore_record_count_limit)
+{
+	// catalogue is modified by appends on this thread, worker gets its copy
+	auto journal_context = checkJournalContext();
+	++*m_activeReaderCount;
+	auto read_lock = std::shared_ptr<void>(nullptr, [reader_count = m_activeReaderCount](void*) { --*reader_count; });
+	return [journal_context = std::move(journal_context), params, ignore_record_count_limit, parallelism = m_getLogParallelism, read_lock = std::move(read_lock)](const std::atomic<bool> &cancelled) {
+		return ShvFileJournal::getLog(journal_context, params, ignore_record_count_limit, parallelism, &cancelled);
+	};
+}
+
+int ShvFileJournal::activeReaderCount() const
+{
+	return *m_activeReaderCount;
 }
 
-chainpack::RpcValue ShvFileJournal::getLog(const JournalContext &journal_context, const ShvGetLogParams &params, IgnoreRecordCountLimit ignore_record_count_limit)
+chainpack::RpcValue ShvFileJournal::getLog(const JournalContext &journal_context, const ShvGetLogParams &params, IgnoreRecordCountLimit ignore_record_count_limit, const GetLogParallelism &parallelism, const std::atomic<bool> *cancelled)
 {
 	std::vector<std::function<ShvJournalFileReader()>> readers;
 	{
 		std::vector<int64_t> non_empty_files;
-		std::copy_if(journal_context.files.begin(), journal_context.files.end(), std::back_inserter(non_empty_files), [&journal_context] (const auto& ms)  {return file_size(journal_context.fileMsecToFilePath(ms)) > 0;});
+		if (journal_context.fileInfos.size() == journal_context.files.size()) {
+			// catalogue is current, there is no need to stat every file
+			for (size_t i = 0; i < journal_context.files.size(); ++i) {
+				if (journal_context.fileInfos[i].size > 0)
+					non_empty_files.push_back(journal_context.files[i]);
+			}
+		}
+		else {
+			std::copy_if(journal_context.files.begin(), journal_context.files.end(), std::back_inserter(non_empty_files), [&journal_context] (const auto& ms)  {return file_size(journal_context.fileMsecToFilePath(ms)) > 0;});
+		}
+		PatternMatcher pattern_matcher(params);
 		for (auto it = shv::core::utils::newestMatchingFileIt(non_empty_files, params); it != non_empty_files.cend(); ++it) {
+			// the last journal file is still being appended, only closed files have summary
+			if (!pattern_matcher.isEmpty() && *it != journal_context.files.back()) {
+				auto summary = ShvJournalFileSummary::forJournalFile(journal_context.fileMsecToFilePath(*it));
+				if (!summary.mayContainMatch(pattern_matcher)) {
+					logDShvJournal() << "\t skipping file:" << journal_context.fileMsecToFileName(*it) << "without paths matching the pattern";
+					continue;
+				}
+			}
 			readers.emplace_back([full_file_name = journal_context.fileMsecToFilePath(*it)] {
 				return shv::core::utils::ShvJournalFileReader(full_file_name);
 			});
 		}
 	}
-	return shv::core::utils::getLog(readers, params, shv::chainpack::RpcValue::DateTime::now(), ignore_record_count_limit);
+	return shv::core::utils::getLog(readers, params, shv::chainpack::RpcValue::DateTime::now(), ignore_record_count_limit, parallelism, cancelled);
 }
 
 chainpack::RpcValue ShvFileJournal::getSnapShotMap()
@@ -5,6 +5,11 @@
 #include <shv/core/log.h>
 #include <shv/core/utils.h>
 
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstring>
+
 #define logWShvJournal() shvCWarning("ShvJournal")
 #define logIShvJournal() shvCInfo("ShvJournal")
 #define logMShvJournal() shvCMessage("ShvJournal")
@@ -15,31 +20,52 @@ namespace cp = shv::chainpack;
 namespace shv::core::utils {
 
 namespace {
-std::string getLine(std::istream &in, char sep)
+bool is_decimal_int(StringView s)
+{
+	size_t i = (!s.empty() && s[0] == '-')? 1: 0;
+	if(i == s.size())
+		return false;
+	for(; i < s.size(); ++i) {
+		if(s[i] < '0' || s[i] > '9')
+			return false;
+	}
+	return true;
+}
+
+cp::RpcValue value_from_cpon(StringView fld, std::string &err)
 {
-	std::string line;
-	while(in) {
-		auto c = in.get();
-		if(c == std::char_traits<char>::eof())
-			return line;
-		if(c == sep)
-			return line;
-		if(c == 0)
-			continue; // sometimes log file contains zeros, skip them, istream::getline cannot handle this
-		line += std::char_traits<char>::to_char_type(c);
+	err.clear();
+	// fast path for the most common journal values, which need not to go through CponReader
+	if(fld == "true")
+		return true;
+	if(fld == "false")
+		return false;
+	if(fld == "null")
+		return nullptr;
+	if(is_decimal_int(fld)) {
+		long long n;
+		if(auto [ptr, ec] = std::from_chars(fld.data(), fld.data() + fld.size(), n); ec == std::errc() && ptr == fld.data() + fld.size())
+			return n;
 	}
-	return line;
+	return cp::RpcValue::fromCpon(std::string{fld}, &err);
+}
+
+int to_int(StringView fld, bool *ok = nullptr)
+{
+	int n = 0;
+	auto [ptr, ec] = std::from_chars(fld.data(), fld.data() + fld.size(), n);
+	bool is_ok = ec == std::errc() && ptr == fld.data() + fld.size();
+	if(ok)
+		*ok = is_ok;
+	return is_ok? n: 0;
 }
 }
 
 ShvJournalFileReader::ShvJournalFileReader(const std::string &file_name)
 	: m_fileName(file_name)
+	, m_mappedFile(file_name, MemoryMappedFile::AccessPattern::Sequential)
 {
-	m_inputFileStream.open(file_name, std::ios::binary);
-	if(!m_inputFileStream)
-		SHV_EXCEPTION("Cannot open file " + file_name + " for reading.");
 	m_snapshotMsec = fileNameToFileMsec(file_name, !shv::core::Exception::Throw);
-	m_istream = &m_inputFileStream;
 }
 
 ShvJournalFileReader::ShvJournalFileReader(std::istream &istream)
@@ -47,110 +73,151 @@ ShvJournalFileReader::ShvJournalFileReader(std::istream &istream)
 	m_istream = &istream;
 }
 
+bool ShvJournalFileReader::nextLine(StringView &line)
+{
+	if(m_istream) {
+		if(!std::getline(*m_istream, m_lineBuffer, ShvFileJournal::RECORD_SEPARATOR))
+			return false;
+		line = m_lineBuffer;
+	}
+	else {
+		const StringView data = m_mappedFile.data();
+		if(m_dataPos >= data.size())
+			return false;
+		const char *begin = data.data() + m_dataPos;
+		const size_t rest = data.size() - m_dataPos;
+		const auto *end = static_cast<const char*>(std::memchr(begin, ShvFileJournal::RECORD_SEPARATOR, rest));
+		const size_t len = end? static_cast<size_t>(end - begin): rest;
+		line = StringView(begin, len);
+		m_dataPos += end? len + 1: len;
+	}
+	if(std::memchr(line.data(), 0, line.size())) {
+		// sometimes log file contains zeros, skip them
+		std::string s{line};
+		std::erase(s, '\0');
+		m_lineBuffer = std::move(s);
+		line = m_lineBuffer;
+	}
+	return true;
+}
+
 bool ShvJournalFileReader::next()
 {
-	using Column = ShvFileJournal::TxtColumn;
 	while(true) {
 		m_currentEntry = ShvJournalEntry();
-		if(!*m_istream)
+		StringView line;
+		if(!nextLine(line))
 			return false;
-
-		std::string line = getLine(*m_istream, ShvFileJournal::RECORD_SEPARATOR);
 		if(line.empty()) {
 			logDShvJournal() << "skipping empty line";
 			continue; // skip empty line
 		}
-		std::string::size_type ix1 = 0;
-		for(int column = 0; column < ShvFileJournal::TxtColumnCount && ix1 != std::string::npos; ++column) {
-			auto ix2 = line.find(ShvFileJournal::FIELD_SEPARATOR, ix1);
-			StringView fld;
-			if(ix2 == std::string::npos) {
-				fld = StringView(line).substr(ix1);
-				ix1 = ix2;
-			}
-			else {
-				fld = StringView(line).substr(ix1, ix2 - ix1);
-				ix1 = ix2 + 1;
-			}
+		if(parseLine(line)) {
+			if(m_snapshotMsec == 0)
+				m_snapshotMsec = m_currentEntry.epochMsec;
+			return true;
+		}
+		m_currentEntry = {};
+	}
+}
 
-			switch(column) {
-			case Column::Timestamp: {
-				std::string dtstr = std::string{fld};
-				size_t len;
-				cp::RpcValue::DateTime dt = cp::RpcValue::DateTime::fromUtcString(dtstr, &len);
-				if(len == 0) {
-					logWShvJournal().nospace() << "invalid date time string: '" << dtstr << "' line will be ignored: '" << line << "' file: '" << m_fileName << '\'';
-					goto next_line;
-				}
-				if(len >= line.size() || line[len] != ShvFileJournal::FIELD_SEPARATOR) {
-					logWShvJournal().nospace() << "invalid date time string: '" << dtstr << "' correct date time should end with field separator on position: " << len << " , line will be ignored: '" << line << "' file: '" << m_fileName << '\'';
-					goto next_line;
-				}
-				m_currentEntry.epochMsec = dt.msecsSinceEpoch();
-				break;
-			}
-			case Column::Path: {
-				if(fld.empty()) {
-					logWShvJournal().nospace() << "skipping invalid line with empty path, line: '" << line << "' file: '" << m_fileName << '\'';
-					goto next_line;
-				}
-				m_currentEntry.path = std::string{fld};
-				break;
-			}
-			case Column::Value: {
-				std::string err;
-				m_currentEntry.value = cp::RpcValue::fromCpon(std::string{fld}, &err);
-				if(!err.empty()) {
-					logWShvJournal().nospace() << "Invalid CPON value: '" << fld << "' line: '" << line << "' file: '" << m_fileName << '\'';
-					goto next_line;
-				}
-				break;
+bool ShvJournalFileReader::parseLine(StringView line)
+{
+	using Column = ShvFileJournal::TxtColumn;
+	StringView::size_type ix1 = 0;
+	for(int column = 0; column < ShvFileJournal::TxtColumnCount && ix1 != StringView::npos; ++column) {
+		auto ix2 = line.find(ShvFileJournal::FIELD_SEPARATOR, ix1);
+		StringView fld;
+		if(ix2 == StringView::npos) {
+			fld = line.substr(ix1);
+			ix1 = ix2;
+		}
+		else {
+			fld = line.substr(ix1, ix2 - ix1);
+			ix1 = ix2 + 1;
+		}
+
+		switch(column) {
+		case Column::Timestamp: {
+			size_t len;
+			int64_t msec = m_timestampCodec.fromIsoString(fld, &len);
+			if(len == 0) {
+				logWShvJournal().nospace() << "invalid date time string: '" << fld << "' line will be ignored: '" << line << "' file: '" << m_fileName << '\'';
+				return false;
 			}
-			case Column::Domain: {
-				if(fld.empty())
-					m_currentEntry.domain = ShvJournalEntry::DOMAIN_VAL_CHANGE;
-				else
-					m_currentEntry.domain = std::string{fld};
-				break;
+			if(len >= line.size() || line[len] != ShvFileJournal::FIELD_SEPARATOR) {
+				logWShvJournal().nospace() << "invalid date time string: '" << fld << "' correct date time should end with field separator on position: " << len << " , line will be ignored: '" << line << "' file: '" << m_fileName << '\'';
+				return false;
 			}
-			case Column::ShortTime: {
-				if(fld.empty()) {
-					m_currentEntry.shortTime = ShvJournalEntry::NO_SHORT_TIME;
-				}
-				else {
-					bool ok;
-					int short_time = shv::core::utils::toInt(std::string{fld}, &ok);
-					m_currentEntry.shortTime = ok && short_time >= 0? short_time: ShvJournalEntry::NO_SHORT_TIME;
-				}
-				break;
+			m_currentEntry.epochMsec = msec;
+			break;
+		}
+		case Column::Path: {
+			if(fld.empty()) {
+				logWShvJournal().nospace() << "skipping invalid line with empty path, line: '" << line << "' file: '" << m_fileName << '\'';
+				return false;
 			}
-			case Column::ValueFlags: {
-				auto value_flags = fld.empty()? 0: shv::core::utils::toInt(std::string{fld});
-				m_currentEntry.valueFlags = static_cast<unsigned int>(value_flags);
-				break;
+			m_currentEntry.path = std::string{fld};
+			break;
+		}
+		case Column::Value: {
+			std::string err;
+			m_currentEntry.value = value_from_cpon(fld, err);
+			if(!err.empty()) {
+				logWShvJournal().nospace() << "Invalid CPON value: '" << fld << "' line: '" << line << "' file: '" << m_fileName << '\'';
+				return false;
 			}
-			case Column::UserId: {
-				m_currentEntry.userId = std::string{fld};
-				break;
-			default: break;
+			break;
+		}
+		case Column::Domain: {
+			if(fld.empty())
+				m_currentEntry.domain = ShvJournalEntry::DOMAIN_VAL_CHANGE;
+			else
+				m_currentEntry.domain = std::string{fld};
+			break;
+		}
+		case Column::ShortTime: {
+			if(fld.empty()) {
+				m_currentEntry.shortTime = ShvJournalEntry::NO_SHORT_TIME;
 			}
+			else {
+				bool ok;
+				int short_time = to_int(fld, &ok);
+				m_currentEntry.shortTime = ok && short_time >= 0? short_time: ShvJournalEntry::NO_SHORT_TIME;
 			}
+			break;
+		}
+		case Column::ValueFlags: {
+			auto value_flags = fld.empty()? 0: to_int(fld);
+			m_currentEntry.valueFlags = static_cast<unsigned int>(value_flags);
+			break;
+		}
+		case Column::UserId: {
+			m_currentEntry.userId = std::string{fld};
+			break;
+		default: break;
+		}
 		}
-		if(m_snapshotMsec == 0)
-			m_snapshotMsec = m_currentEntry.epochMsec;
-		return true;
-next_line:
-		m_currentEntry = {};
 	}
+	return true;
 }
 
 bool ShvJournalFileReader::last()
 {
-	std::ifstream::pos_type fpos;
-	ShvFileJournal::findLastEntryDateTime(m_fileName, 0, &fpos);
-	if(fpos >= 0) {
-		m_istream->clear();
-		m_istream->seekg(fpos, std::ios::beg);
+	if(m_istream) {
+		ShvJournalEntry last_entry;
+		bool found = false;
+		while(next()) {
+			last_entry = m_currentEntry;
+			found = true;
+		}
+		m_currentEntry = std::move(last_entry);
+		return found;
+	}
+	size_t pos;
+	findLastEntryDateTime(m_mappedFile.data(), &pos);
+	if(pos != std::string::npos) {
+		m_dataPos = pos;
 		return next();
 	}
 
@@ -182,23 +249,23 @@ static constexpr size_t MSEC_SEP_POS = SEC_SEP_POS + 3;
 
 int64_t ShvJournalFileReader::fileNameToFileMsec(const std::string &fn, bool throw_exc)
 {
-	std::string utc_str;
-	auto ix = fn.rfind('/');
-	if(ix != std::string::npos)
-		utc_str = fn.substr(ix + 1);
-	else
-		utc_str = fn;
-	if(MSEC_SEP_POS >= utc_str.size()) {
+	StringView base_name = fn;
+	if(auto ix = base_name.rfind('/'); ix != StringView::npos)
+		base_name = base_name.substr(ix + 1);
+	if(MSEC_SEP_POS >= base_name.size()) {
 		if(throw_exc)
 			SHV_EXCEPTION("fileNameToFileMsec(): File name: '" + fn + "' too short.");
 
 		return -1;
 	}
+	std::array<char, 32> utc_str;
+	auto utc_str_len = std::min(base_name.size(), utc_str.size());
+	std::copy_n(base_name.data(), utc_str_len, utc_str.data());
 	utc_str[MIN_SEP_POS] = ':';
 	utc_str[SEC_SEP_POS] = ':';
 	utc_str[MSEC_SEP_POS] = '.';
 	size_t len;
-	int64_t msec = cp::RpcValue::DateTime::fromUtcString(utc_str, &len).msecsSinceEpoch();
+	int64_t msec = IsoTimestampCodec().fromIsoString(StringView(utc_str.data(), utc_str_len), &len);
 	if(msec == 0 || len == 0) {
 		if(throw_exc)
 			SHV_EXCEPTION("fileNameToFileMsec(): Invalid file name: '" + fn + "' cannot be converted to date time");
@@ -210,11 +277,49 @@ int64_t ShvJournalFileReader::fileNameToFileMsec(const std::string &fn, bool thr
 
 std::string ShvJournalFileReader::msecToBaseFileName(int64_t msec)
 {
-	std::string fn = cp::RpcValue::DateTime::fromMSecsSinceEpoch(msec).toIsoString(cp::RpcValue::DateTime::MsecPolicy::Always, false);
+	std::string fn{IsoTimestampCodec().toIsoString(msec, IsoTimestampCodec::MsecPolicy::Always, !IsoTimestampCodec::IncludeTimeZone)};
 	fn[MIN_SEP_POS] = '-';
 	fn[SEC_SEP_POS] = '-';
 	fn[MSEC_SEP_POS] = '-';
 	return fn;
 }
 
+int64_t ShvJournalFileReader::findLastEntryDateTime(StringView journal_data, size_t *p_line_pos)
+{
+	if(p_line_pos)
+		*p_line_pos = std::string::npos;
+	IsoTimestampCodec timestamp_codec;
+	size_t end = journal_data.size();
+	while(end > 0) {
+		// remove trailing blanks, like trailing '\n' in log file
+		for(; end > 0; --end) {
+			auto c = journal_data[end - 1];
+			if(!(c == '\n' || c == '\t' || c == ' '))
+				break;
+		}
+		if(end == 0)
+			break;
+		size_t line_start = journal_data.rfind(ShvFileJournal::RECORD_SEPARATOR, end - 1);
+		line_start = (line_start == StringView::npos)? 0: line_start + 1;
+		StringView line = journal_data.substr(line_start, end - line_start);
+		if(auto tab_pos = line.find(ShvFileJournal::FIELD_SEPARATOR); tab_pos != StringView::npos) {
+			StringView s = line.substr(0, tab_pos);
+			logDShvJournal() << "\t checking:" << s;
+			size_t len;
+			int64_t dt_msec = timestamp_codec.fromIsoString(s, &len);
+			if(len > 0 && dt_msec > 0) {
+				if(p_line_pos)
+					*p_line_pos = line_start;
+				return dt_msec;
+			}
+			logWShvJournal() << "Malformed shv journal date time:" << s << "will be ignored.";
+		}
+		else {
+			logWShvJournal() << "Truncated shv journal date time:" << line << "will be ignored.";
+		}
+		end = line_start;
+	}
+	return -1;
+}
+
 } // namespace shv
@@ -0,0 +1,183 @@
+#include <shv/core/utils/shvjournalfilesummary.h>
+#include <shv/core/utils/shvjournalfilereader.h>
+#include <shv/core/utils/patternmatcher.h>
+
+#include <shv/core/exception.h>
+#include <shv/core/log.h>
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+#define logWShvJournal() shvCWarning("ShvJournal")
+#define logDShvJournal() shvCDebug("ShvJournal")
+
+namespace cp = shv::chainpack;
+
+namespace shv::core::utils {
+
+const std::string ShvJournalFileSummary::FILE_EXT = ".summary";
+
+namespace {
+int64_t journal_file_size(const std::string &file_name)
+{
+	std::error_code code;
+	auto ret = std::filesystem::file_size(file_name, code);
+	if (code) {
+		return -1;
+	}
+	return static_cast<int64_t>(ret);
+}
+}
+
+bool ShvJournalFileSummary::isValid() const
+{
+	return fileSize >= 0;
+}
+
+void ShvJournalFileSummary::addEntry(const ShvJournalEntry &entry)
+{
+	if (recordCount++ == 0) {
+		sinceMsec = entry.epochMsec;
+	}
+	untilMsec = std::max(untilMsec, entry.epochMsec);
+	paths.insert(entry.path);
+	domains.insert(entry.domain);
+	AbstractShvJournal::addToSnapshot(snapshot, entry);
+}
+
+bool ShvJournalFileSummary::mayContainMatch(const PatternMatcher &pattern_matcher) const
+{
+	if (pattern_matcher.isEmpty()) {
+		return recordCount > 0;
+	}
+	return std::any_of(paths.begin(), paths.end(), [&pattern_matcher](const std::string &path) { return pattern_matcher.matchPath(path); })
+		&& std::any_of(domains.begin(), domains.end(), [&pattern_matcher](const std::string &domain) { return pattern_matcher.matchDomain(domain); });
+}
+
+cp::RpcValue ShvJournalFileSummary::toRpcValue() const
+{
+	cp::RpcValue::Map m;
+	m[KEY_FILE_SIZE] = fileSize;
+	m[KEY_SINCE] = cp::RpcValue::DateTime::fromMSecsSinceEpoch(sinceMsec);
+	m[KEY_UNTIL] = cp::RpcValue::DateTime::fromMSecsSinceEpoch(untilMsec);
+	m[KEY_RECORD_COUNT] = recordCount;
+	cp::RpcValue::List path_list(paths.begin(), paths.end());
+	m[KEY_PATHS] = path_list;
+	cp::RpcValue::List domain_list(domains.begin(), domains.end());
+	m[KEY_DOMAINS] = domain_list;
+	cp::RpcValue::List snapshot_list;
+	for (const auto &kv : snapshot.keyvals) {
+		snapshot_list.push_back(kv.second.toRpcValueMap());
+	}
+	m[KEY_SNAPSHOT] = snapshot_list;
+	return m;
+}
+
+ShvJournalFileSummary ShvJournalFileSummary::fromRpcValue(const cp::RpcValue &rv)
+{
+	ShvJournalFileSummary ret;
+	const auto &m = rv.asMap();
+	ret.fileSize = m.value(KEY_FILE_SIZE, -1).toInt64();
+	ret.sinceMsec = m.value(KEY_SINCE).toDateTime().msecsSinceEpoch();
+	ret.untilMsec = m.value(KEY_UNTIL).toDateTime().msecsSinceEpoch();
+	ret.recordCount = m.value(KEY_RECORD_COUNT).toInt();
+	for (const auto &path : m.value(KEY_PATHS).asList()) {
+		ret.paths.insert(path.asString());
+	}
+	for (const auto &domain : m.value(KEY_DOMAINS).asList()) {
+		ret.domains.insert(domain.asString());
+	}
+	for (const auto &entry : m.value(KEY_SNAPSHOT).asList()) {
+		auto e = ShvJournalEntry::fromRpcValueMap(entry.asMap());
+		ret.snapshot.keyvals[e.path] = e;
+	}
+	return ret;
+}
+
+std::string ShvJournalFileSummary::summaryFilePath(const std::string &journal_file_path)
+{
+	return journal_file_path + FILE_EXT;
+}
+
+ShvJournalFileSummary ShvJournalFileSummary::fromJournalFile(const std::string &journal_file_path)
+{
+	logDShvJournal() << "Creating summary of journal file:" << journal_file_path;
+	ShvJournalFileSummary ret;
+	ret.fileSize = journal_file_size(journal_file_path);
+	if (ret.fileSize <= 0) {
+		return ret;
+	}
+	ShvJournalFileReader reader(journal_file_path);
+	while (reader.next()) {
+		ret.addEntry(reader.entry());
+	}
+	return ret;
+}
+
+ShvJournalFileSummary ShvJournalFileSummary::forJournalFile(const std::string &journal_file_path)
+{
+	const auto summary_file_path = summaryFilePath(journal_file_path);
+	if (std::ifstream in(summary_file_path, std::ios::binary); in) {
+		std::stringstream ss;
+		ss << in.rdbuf();
+		std::string err;
+		auto rv = cp::RpcValue::fromCpon(ss.str(), &err);
+		if (err.empty()) {
+			auto ret = fromRpcValue(rv);
+			if (ret.isValid() && ret.fileSize == journal_file_size(journal_file_path)) {
+				return ret;
+			}
+			logDShvJournal() << "Summary file:" << summary_file_path << "is outdated";
+		}
+		else {
+			logWShvJournal() << "Malformed summary file:" << summary_file_path << err;
+		}
+	}
+	auto ret = fromJournalFile(journal_file_path);
+	if (ret.isValid()) {
+		try {
+			ret.save(journal_file_path);
+		}
+		catch (const shv::core::Exception &e) {
+			// journal dir can be read-only, summary is just not cached then
+			logWShvJournal() << e.message();
+		}
+	}
+	return ret;
+}
+
+int64_t ShvJournalFileSummary::save(const std::string &journal_file_path) const
+{
+	// write to temporary file first, so that concurrent reader never sees incomplete summary,
+	// temporary file name is unique, since summary of the same file can be saved by more getLog workers at once
+	static std::atomic<uint64_t> tmp_file_counter = std::random_device{}();
+	const auto summary_file_path = summaryFilePath(journal_file_path);
+	const auto tmp_file_path = summary_file_path + ".tmp" + std::to_string(tmp_file_counter++);
+	const auto data = toRpcValue().toCpon();
+	{
+		std::ofstream out(tmp_file_path, std::ios::binary | std::ios::trunc);
+		if (!out) {
+			SHV_EXCEPTION("Cannot open file " + tmp_file_path + " for writing");
+		}
+		out << data;
+		if (!out) {
+			out.close();
+			std::error_code code;
+			std::filesystem::remove(tmp_file_path, code);
+			SHV_EXCEPTION("Cannot write file " + tmp_file_path);
+		}
+	}
+	std::error_code code;
+	std::filesystem::rename(tmp_file_path, summary_file_path, code);
+	if (code) {
+		std::filesystem::remove(tmp_file_path, code);
+		SHV_EXCEPTION("Cannot rename file " + tmp_file_path + " to " + summary_file_path);
+	}
+	return static_cast<int64_t>(data.size());
+}
+
+} // namespace shv::core::utils
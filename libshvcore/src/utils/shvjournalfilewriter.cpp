@@ -106,10 +106,10 @@ void ShvJournalFileWriter::appendSnapshot(int64_t msec, const std::map<std::stri
 void ShvJournalFileWriter::append(int64_t msec, int64_t orig_time, const ShvJournalEntry &entry)
 {
 	logDShvJournal() << "ShvJournalFileWriter::append:" << entry.toRpcValue().toCpon();
-	*m_out << cp::RpcValue::DateTime::fromMSecsSinceEpoch(msec).toIsoString();
+	*m_out << m_timestampCodec.toIsoString(msec);
 	*m_out << ShvFileJournal::FIELD_SEPARATOR;
 	if(orig_time != msec)
-		*m_out << cp::RpcValue::DateTime::fromMSecsSinceEpoch(orig_time).toIsoString();
+		*m_out << m_timestampCodec.toIsoString(orig_time);
 	*m_out << ShvFileJournal::FIELD_SEPARATOR;
 	*m_out << entry.path;
 	*m_out << ShvFileJournal::FIELD_SEPARATOR;
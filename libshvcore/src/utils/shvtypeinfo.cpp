@@ -732,32 +732,86 @@ ShvDeviceDescription &ShvDeviceDescription::setPropertyDescription(const ShvProp
 }
 
 //=====================================================================
-// ShvLogTypeInfo
+// ShvTypeInfo
 //=====================================================================
-template<typename T>
-typename std::map<std::string, T>::const_iterator find_longest_prefix(const std::map<std::string, T> &map, const std::string &path)
-{
-	std::string prefix = path;
-	while(true) {
-		auto it = map.find(prefix);
-		if(it == map.end()) {
-			// if not found, cut last path part
-			size_t ix = prefix.find_last_of('/');
-			if(ix == std::string::npos) {
-				if(prefix.empty()) {
-					return map.cend();
-				}
-				prefix = "";
-			}
-			else {
-				prefix = shv::core::utils::mid(prefix, 0, ix);
-			}
-		}
-		else {
-			return it;
-		}
+ShvTypeInfo::PathInfoCache::PathInfoCache(const PathInfoCache &other)
+{
+	std::lock_guard lock(other.m_mutex);
+	m_capacity = other.m_capacity;
+}
+
+ShvTypeInfo::PathInfoCache &ShvTypeInfo::PathInfoCache::operator=(const PathInfoCache &other)
+{
+	if(this != &other) {
+		std::scoped_lock lock(m_mutex, other.m_mutex);
+		m_capacity = other.m_capacity;
+		m_pathInfos.clear();
 	}
-	return map.cend();
+	return *this;
+}
+
+void ShvTypeInfo::PathInfoCache::setCapacity(size_t capacity)
+{
+	std::lock_guard lock(m_mutex);
+	m_capacity = capacity;
+	m_pathInfos.clear();
+}
+
+std::optional<ShvTypeInfo::PathInfo> ShvTypeInfo::PathInfoCache::find(const std::string &shv_path) const
+{
+	std::lock_guard lock(m_mutex);
+	if(auto it = m_pathInfos.find(shv_path); it != m_pathInfos.end())
+		return it->second;
+	return {};
+}
+
+void ShvTypeInfo::PathInfoCache::insert(const std::string &shv_path, const PathInfo &path_info)
+{
+	std::lock_guard lock(m_mutex);
+	if(m_capacity == 0)
+		return;
+	if(m_pathInfos.size() >= m_capacity)
+		m_pathInfos.clear();
+	m_pathInfos.emplace(shv_path, path_info);
+}
+
+void ShvTypeInfo::PathInfoCache::clear()
+{
+	std::lock_guard lock(m_mutex);
+	m_pathInfos.clear();
+}
+
+void ShvTypeInfo::buildPathIndex()
+{
+	m_devicePathIndex.clear();
+	for(const auto &[device_path, device_type] : m_devicePaths) {
+		m_devicePathIndex.insert(device_path, device_type);
+	}
+	m_propertyDeviationIndex.clear();
+	for(const auto &[shv_path, property_descr] : m_propertyDeviations) {
+		m_propertyDeviationIndex.insert(shv_path, property_descr);
+	}
+	m_devicePropertyIndex.clear();
+	for(const auto &kv : m_deviceDescriptions) {
+		buildDevicePropertyIndex(kv.first);
+	}
+	m_pathInfoCache.clear();
+}
+
+void ShvTypeInfo::buildDevicePropertyIndex(const std::string &device_type)
+{
+	auto &index = m_devicePropertyIndex[device_type];
+	index.clear();
+	const auto &properties = m_deviceDescriptions[device_type].properties;
+	for(size_t i = 0; i < properties.size(); ++i) {
+		// the last one wins for duplicate property names
+		index.insert(properties[i].name(), i);
+	}
+}
+
+void ShvTypeInfo::pathIndexChanged()
+{
+	m_pathInfoCache.clear();
 }
 
 bool ShvTypeInfo::isPathBlacklisted(const std::string &shv_path) const
@@ -784,6 +838,8 @@ void ShvTypeInfo::setBlacklist(const std::string &shv_path, const chainpack::Rpc
 void ShvTypeInfo::setPropertyDeviation(const std::string &shv_path, const ShvPropertyDescr &property_descr)
 {
 	m_propertyDeviations[shv_path] = property_descr;
+	m_propertyDeviationIndex.insert(shv_path, property_descr);
+	pathIndexChanged();
 }
 
 ShvTypeInfo ShvTypeInfo::fromVersion2(std::map<std::string, ShvTypeDescr> &&types, const std::map<std::string, ShvPropertyDescr> &node_descriptions)
@@ -797,6 +853,7 @@ ShvTypeInfo ShvTypeInfo::fromVersion2(std::map<std::string, ShvTypeDescr> &&type
 		pd.setName(k);
 		device_descr.properties.push_back(std::move(pd));
 	}
+	ret.buildPathIndex();
 	return ret;
 }
 
@@ -809,6 +866,7 @@ ShvTypeInfo ShvTypeInfo::fromVersion2(std::map<std::string, ShvTypeDescr> &&type
 	for(const auto &pd : property_descriptions) {
 		device_descr.properties.push_back(pd);
 	}
+	ret.buildPathIndex();
 	return ret;
 }
 
@@ -856,19 +914,32 @@ const std::map<std::string, shv::chainpack::RpcValue>& ShvTypeInfo::extraTags()
 ShvTypeInfo &ShvTypeInfo::setDevicePath(const std::string &device_path, const std::string &device_type)
 {
 	m_devicePaths[device_path] = device_type;
+	m_devicePathIndex.insert(device_path, device_type);
+	pathIndexChanged();
 	return *this;
 }
 
 ShvTypeInfo &ShvTypeInfo::setDeviceDescription(const std::string &device_type, const ShvDeviceDescription &device_descr)
 {
 	m_deviceDescriptions[device_type] = device_descr;
+	buildDevicePropertyIndex(device_type);
+	pathIndexChanged();
 	return *this;
 }
 
 ShvTypeInfo &ShvTypeInfo::setPropertyDescription(const std::string &device_type, const ShvPropertyDescr &property_descr)
 {
 	auto &dev_descr = m_deviceDescriptions[device_type];
+	const auto property_count = dev_descr.properties.size();
 	dev_descr.setPropertyDescription(property_descr);
+	if(dev_descr.properties.size() == property_count + 1) {
+		m_devicePropertyIndex[device_type].insert(property_descr.name(), property_count);
+	}
+	else if(dev_descr.properties.size() < property_count) {
+		// property indexes are shifted by removal
+		buildDevicePropertyIndex(device_type);
+	}
+	pathIndexChanged();
 	return *this;
 }
 
@@ -922,14 +993,29 @@ std::string cut_sufix(const std::string &path, const std::string &postfix) {
 }
 
 ShvTypeInfo::PathInfo ShvTypeInfo::pathInfo(const std::string &shv_path) const
+{
+	if(auto path_info = m_pathInfoCache.find(shv_path); path_info) {
+		return *path_info;
+	}
+	auto ret = resolvePathInfo(shv_path);
+	m_pathInfoCache.insert(shv_path, ret);
+	return ret;
+}
+
+void ShvTypeInfo::setPathInfoCacheCapacity(size_t capacity)
+{
+	m_pathInfoCache.setCapacity(capacity);
+}
+
+ShvTypeInfo::PathInfo ShvTypeInfo::resolvePathInfo(const std::string &shv_path) const
 {
 	PathInfo ret;
 	bool deviation_found = false;
-	if(auto it3 = find_longest_prefix(m_propertyDeviations, shv_path); it3 != m_propertyDeviations.cend()) {
+	if(auto [property_descr, prefix_len] = m_propertyDeviationIndex.findLongestPrefix(shv_path); property_descr) {
 		deviation_found = true;
-		const std::string own_property_path = it3->first;
+		const std::string own_property_path = shv_path.substr(0, prefix_len);
 		ret.fieldPath = cut_prefix(shv_path, own_property_path);
-		ret.propertyDescription = it3->second;
+		ret.propertyDescription = *property_descr;
 	}
 	const auto &[device_path, device_type, property_path] = findDeviceType(shv_path);
 	ret.devicePath = device_path;
@@ -957,28 +1043,30 @@ ShvPropertyDescr ShvTypeInfo::propertyDescriptionForPath(const std::string &shv_
 
 std::tuple<std::string, std::string, std::string> ShvTypeInfo::findDeviceType(const std::string &shv_path) const
 {
-	auto it = find_longest_prefix(m_devicePaths, shv_path);
-	if(it == m_devicePaths.cend()) {
+	auto [device_type, prefix_len] = m_devicePathIndex.findLongestPrefix(shv_path);
+	if(!device_type) {
 		return {};
 	}
 
-	const std::string prefix = it->first;
-	const std::string device_type = it->second;
+	const std::string prefix = shv_path.substr(0, prefix_len);
 	const std::string property_path = prefix.empty()? shv_path: shv::core::utils::mid(shv_path, prefix.size() + 1);
-	return make_tuple(prefix, device_type, property_path);
+	return make_tuple(prefix, *device_type, property_path);
 }
 
 std::tuple<ShvPropertyDescr, std::string> ShvTypeInfo::findPropertyDescription(const std::string &device_type, const std::string &property_path) const
 {
-	if(auto it2 = m_deviceDescriptions.find(device_type); it2 != m_deviceDescriptions.end()) {
-		const auto &dev_descr = it2->second;
-		if(auto it3 = dev_descr.findLongestPropertyPrefix(property_path); it3 != dev_descr.properties.cend()) {
-			const std::string own_property_path = it3->name();
-			const std::string field_path = cut_prefix(property_path, own_property_path);
-			return make_tuple(*it3, field_path);
-		}
+	auto it = m_devicePropertyIndex.find(device_type);
+	if(it == m_devicePropertyIndex.end()) {
+		return {};
 	}
-	return {};
+	auto [property_ix, prefix_len] = it->second.findLongestPrefix(property_path);
+	if(!property_ix) {
+		return {};
+	}
+	const auto &property_descr = m_deviceDescriptions.at(device_type).properties.at(*property_ix);
+	const std::string own_property_path = property_descr.name();
+	const std::string field_path = cut_prefix(property_path, own_property_path);
+	return make_tuple(property_descr, field_path);
 }
 
 ShvTypeDescr ShvTypeInfo::findTypeDescription(const std::string &type_name) const
@@ -1160,6 +1248,7 @@ ShvTypeInfo ShvTypeInfo::fromRpcValue(const RpcValue &v)
 	if(ret.m_systemPathsRoots.empty()) {
 		ret.m_systemPathsRoots[""] = "system";
 	}
+	ret.buildPathIndex();
 	return ret;
 }
 
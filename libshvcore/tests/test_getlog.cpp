@@ -7,8 +7,10 @@
 #include <shv/core/utils/shvjournalfilereader.h>
 #include <shv/core/utils/shvjournalfilewriter.h>
 #include <shv/core/log.h>
+#include <shv/core/exception.h>
 
 #include <filesystem>
+#include <tuple>
 
 namespace cp = shv::chainpack;
 using cp::RpcValue;
@@ -622,6 +624,65 @@ DOCTEST_TEST_CASE("getLog")
 		REQUIRE(log.logHeader().sinceCRef() == expected_since);
 		REQUIRE(log.logHeader().untilCRef() == expected_until);
 	}
+
+	DOCTEST_SUBCASE("parallel reading")
+	{
+		std::vector<std::function<shv::core::utils::ShvJournalFileReader()>> readers;
+		constexpr auto file_count = 20;
+		constexpr auto entries_per_file = 30;
+		const auto start_msec = RpcValue::DateTime::fromUtcString("2022-07-07T18:00:00.000Z").msecsSinceEpoch();
+		for (auto file_ix = 0; file_ix < file_count; file_ix++) {
+			std::vector<shv::core::utils::ShvJournalEntry> entries;
+			for (auto entry_ix = 0; entry_ix < entries_per_file; entry_ix++) {
+				auto msec = start_msec + (file_ix * entries_per_file + entry_ix) * 100;
+				entries.push_back(make_entry(RpcValue::DateTime::fromMSecsSinceEpoch(msec).toIsoString(), "node" + std::to_string(entry_ix % 4) + "/value", entry_ix, false));
+			}
+			readers.push_back(create_reader(entries));
+		}
+
+		DOCTEST_SUBCASE("default params")
+		{
+		}
+
+		DOCTEST_SUBCASE("path pattern")
+		{
+			get_log_params.pathPattern = "node1/**";
+		}
+
+		DOCTEST_SUBCASE("since/until with snapshot")
+		{
+			get_log_params.since = RpcValue::DateTime::fromMSecsSinceEpoch(start_msec + 12345);
+			get_log_params.until = RpcValue::DateTime::fromMSecsSinceEpoch(start_msec + 34567);
+			get_log_params.withSnapshot = true;
+		}
+
+		DOCTEST_SUBCASE("record count limit")
+		{
+			get_log_params.recordCountLimit = 77;
+		}
+
+		const auto now = RpcValue::DateTime::fromUtcString("2024-07-07T18:06:20.850");
+		auto sequential = shv::core::utils::ShvLogRpcValueReader(shv::core::utils::getLog(readers, get_log_params, now));
+		auto parallel = shv::core::utils::ShvLogRpcValueReader(shv::core::utils::getLog(readers, get_log_params, now, shv::core::utils::IgnoreRecordCountLimit::No, {.threadCount = 3, .readAheadFileCount = 2}));
+		REQUIRE(sequential.logHeader().recordCount() > 0);
+		REQUIRE(parallel.logHeader().sinceCRef() == sequential.logHeader().sinceCRef());
+		REQUIRE(parallel.logHeader().untilCRef() == sequential.logHeader().untilCRef());
+		REQUIRE(parallel.logHeader().recordCount() == sequential.logHeader().recordCount());
+		REQUIRE(as_vector(parallel) == as_vector(sequential));
+	}
+
+	DOCTEST_SUBCASE("cancelled")
+	{
+		std::vector<std::function<shv::core::utils::ShvJournalFileReader()>> readers;
+		readers.push_back(create_reader({make_entry("2022-07-07T18:06:15.557Z", "value1", 10, false)}));
+		readers.push_back(create_reader({make_entry("2022-07-07T18:06:16.557Z", "value1", 20, false)}));
+		const auto now = RpcValue::DateTime::fromUtcString("2024-07-07T18:06:20.850");
+		std::atomic<bool> cancelled = false;
+		REQUIRE(shv::core::utils::ShvLogRpcValueReader(shv::core::utils::getLog(readers, get_log_params, now, shv::core::utils::IgnoreRecordCountLimit::No, {}, &cancelled)).logHeader().recordCount() == 2);
+		cancelled = true;
+		REQUIRE_THROWS_AS(std::ignore = shv::core::utils::getLog(readers, get_log_params, now, shv::core::utils::IgnoreRecordCountLimit::No, {}, &cancelled), shv::core::Exception);
+		REQUIRE_THROWS_AS(std::ignore = shv::core::utils::getLog(readers, get_log_params, now, shv::core::utils::IgnoreRecordCountLimit::No, {.threadCount = 2}, &cancelled), shv::core::Exception);
+	}
 }
 
 DOCTEST_TEST_CASE("newestMatchingFileIt")
@@ -0,0 +1,84 @@
+#include <shv/core/utils/isotimestampcodec.h>
+#include <shv/core/utils/shvjournalfilereader.h>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <random>
+
+using namespace shv::core::utils;
+using namespace std;
+using shv::chainpack::RpcValue;
+
+namespace {
+std::vector<int64_t> random_timestamps(size_t count)
+{
+	std::mt19937_64 gen(1234);
+	// 1970 - 2200
+	std::uniform_int_distribution<int64_t> dist(0, 7258118400000LL);
+	std::vector<int64_t> ret(count);
+	for(auto &msec : ret)
+		msec = dist(gen);
+	return ret;
+}
+}
+
+DOCTEST_TEST_CASE("IsoTimestampCodec")
+{
+	IsoTimestampCodec codec;
+	DOCTEST_SUBCASE("toIsoString() is identical with RpcDateTime")
+	{
+		for(auto msec : random_timestamps(10000)) {
+			auto dt = RpcValue::DateTime::fromMSecsSinceEpoch(msec);
+			CAPTURE(msec);
+			REQUIRE(codec.toIsoString(msec) == dt.toIsoString());
+			REQUIRE(codec.toIsoString(msec, IsoTimestampCodec::MsecPolicy::Always, false) == dt.toIsoString(RpcValue::DateTime::MsecPolicy::Always, false));
+			REQUIRE(codec.toIsoString(msec - msec % 1000) == RpcValue::DateTime::fromMSecsSinceEpoch(msec - msec % 1000).toIsoString());
+		}
+	}
+	DOCTEST_SUBCASE("fromIsoString() is identical with RpcDateTime")
+	{
+		for(auto msec : random_timestamps(10000)) {
+			auto s = RpcValue::DateTime::fromMSecsSinceEpoch(msec).toIsoString();
+			size_t len;
+			REQUIRE(codec.fromIsoString(s + "\tfoo", &len) == msec);
+			REQUIRE(len == s.size());
+		}
+	}
+	DOCTEST_SUBCASE("fromIsoString() fallback")
+	{
+		for(const std::string s : {"2018-01-10T12:03:56.123+0130", "2018-01-10T12:03:56-02", "2018-01-10T12:03:56.1Z", "2018-01-10 12:03:56", "2018-01-10T12:03:56", "foo", ""}) {
+			CAPTURE(s);
+			size_t len1;
+			size_t len2;
+			auto msec = codec.fromIsoString(s, &len1);
+			auto dt = RpcValue::DateTime::fromUtcString(s, &len2);
+			REQUIRE(len1 == len2);
+			if(len1 > 0)
+				REQUIRE(msec == dt.msecsSinceEpoch());
+		}
+	}
+	DOCTEST_SUBCASE("journal file names")
+	{
+		for(auto msec : random_timestamps(1000)) {
+			auto fn = ShvJournalFileReader::msecToBaseFileName(msec);
+			REQUIRE(fn == RpcValue::DateTime::fromMSecsSinceEpoch(msec).toIsoString(RpcValue::DateTime::MsecPolicy::Always, false).replace(13, 1, "-").replace(16, 1, "-").replace(19, 1, "-"));
+			REQUIRE(ShvJournalFileReader::fileNameToFileMsec("/journal/dir/" + fn + ".log2") == msec);
+		}
+	}
+}
+
+DOCTEST_TEST_CASE("IsoTimestampCodec monotonic sequence")
+{
+	// journal records are mostly monotonic, so the cached date part is reused most of the time,
+	// speed is measured in bench_core_isotimestampcodec
+	IsoTimestampCodec codec;
+	int64_t msec = 1700000000000LL;
+	for(int i = 0; i < 200000; i++) {
+		msec += 3037;
+		auto s = RpcValue::DateTime::fromMSecsSinceEpoch(msec).toIsoString();
+		CAPTURE(msec);
+		REQUIRE(codec.toIsoString(msec) == s);
+		REQUIRE(codec.fromIsoString(s) == msec);
+	}
+}
@@ -1,7 +1,10 @@
 #include <shv/core/utils/shvjournalfilereader.h>
+#include <shv/core/utils/shvfilejournal.h>
 #include <necrolog.h>
 
 #include <chrono>
+#include <fstream>
+#include <sstream>
 
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include <doctest/doctest.h>
@@ -12,6 +15,7 @@ using namespace std;
 
 namespace {
 const std::string FILES_DIR = DEF_FILES_DIR;
+const std::string TEST_DIR = TEST_FILES_DIR;
 }
 
 template <class TimeT  = std::chrono::milliseconds, class ClockT = std::chrono::steady_clock>
@@ -44,3 +48,61 @@ DOCTEST_TEST_CASE("ShvJournalFileReader speed")
 		nError() << "Cannot open file:" << log_file_name << ", consider checking validity of symlink.";
 	}
 }
+
+DOCTEST_TEST_CASE("ShvJournalFileReader mapped file")
+{
+	using namespace std::string_literals;
+	const auto journal_data =
+		"2022-01-01T00:00:00.000Z\t\tfoo/bar\t1\t\t\t0\t\n"
+		"\n"
+		"2022-01-01T00:00:01.000Z\t\tfoo/baz\t\"abc\"\t12\tchng\t2\tuser1\n"
+		"invalid line\n"
+		"2022-01-01T00:00:02.001Z\t\tfoo/bar\ttrue\t\t\t0\t\n"
+		"2022-01-01T00:00:03.002Z\t\tfoo/b\0ar\t[1,2]\t\t\t0\t\n"
+		"2022-01-01T00:00:04.003Z\t\tfoo/bar\t-42\t\t\t0\t\n"
+		"2022-01-0"s;
+	auto fn = TEST_DIR + "/2022-01-01T00-00-00-000.log2";
+	{
+		std::ofstream out(fn, std::ios::binary | std::ios::out | std::ios::trunc);
+		out << journal_data;
+	}
+	std::vector<ShvJournalEntry> entries;
+	{
+		ShvJournalFileReader rd(fn);
+		while(rd.next())
+			entries.push_back(rd.entry());
+		REQUIRE(rd.snapshotMsec() == 1640995200000);
+	}
+	REQUIRE(entries.size() == 5);
+	REQUIRE(entries[1].path == "foo/baz");
+	REQUIRE(entries[1].value == shv::chainpack::RpcValue("abc"));
+	REQUIRE(entries[1].shortTime == 12);
+	REQUIRE(entries[1].domain == "chng");
+	REQUIRE(entries[1].valueFlags == 2);
+	REQUIRE(entries[1].userId == "user1");
+	REQUIRE(entries[2].value == shv::chainpack::RpcValue(true));
+	REQUIRE(entries[3].path == "foo/bar");
+	REQUIRE(entries[3].value == shv::chainpack::RpcValue(shv::chainpack::RpcList{1, 2}));
+	REQUIRE(entries[4].value == shv::chainpack::RpcValue(-42));
+
+	DOCTEST_SUBCASE("stream reader gives same entries")
+	{
+		std::istringstream in(journal_data);
+		ShvJournalFileReader rd(in);
+		size_t i = 0;
+		while(rd.next()) {
+			REQUIRE(i < entries.size());
+			REQUIRE(rd.entry() == entries[i++]);
+		}
+		REQUIRE(i == entries.size());
+	}
+	DOCTEST_SUBCASE("last entry")
+	{
+		ShvJournalFileReader rd(fn);
+		REQUIRE(rd.last());
+		REQUIRE(rd.entry() == entries.back());
+		std::ifstream::pos_type fpos;
+		REQUIRE(ShvFileJournal::findLastEntryDateTime(fn, 0, &fpos) == entries.back().epochMsec);
+		REQUIRE(fpos == static_cast<std::streamoff>(journal_data.find("2022-01-01T00:00:04.003Z")));
+	}
+}
@@ -1,21 +1,26 @@
 #include <shv/core/utils/shvfilejournal.h>
+#include <shv/core/utils/getlog.h>
 #include <shv/core/utils/shvlogheader.h>
 #include <shv/core/utils/shvtypeinfo.h>
 #include <shv/core/utils/shvjournalentry.h>
 #include <shv/core/utils/shvlogfilereader.h>
 #include <shv/core/utils/shvjournalfilewriter.h>
 #include <shv/core/utils/shvjournalfilereader.h>
+#include <shv/core/utils/shvjournalfilesummary.h>
 #include <shv/core/utils/shvmemoryjournal.h>
 #include <shv/core/utils/shvlogfilter.h>
 #include <shv/core/utils/shvlogrpcvaluereader.h>
 
 #include <shv/core/log.h>
+#include <shv/core/exception.h>
 
 #include <shv/chainpack/chainpackwriter.h>
 #include <shv/chainpack/cponwriter.h>
 
+#include <atomic>
 #include <filesystem>
 #include <random>
+#include <tuple>
 
 #define DOCTEST_CONFIG_IMPLEMENT
 #include <doctest/doctest.h>
@@ -28,6 +33,7 @@ using shv::core::utils::ShvPropertyDescr;
 using shv::core::utils::ShvJournalEntry;
 using shv::core::utils::ShvFileJournal;
 using shv::core::utils::ShvGetLogParams;
+using shv::core::utils::ShvJournalFileSummary;
 using shv::core::utils::ShvLogRpcValueReader;
 using shv::core::utils::ShvLogFileReader;
 using shv::core::utils::ShvJournalFileWriter;
@@ -549,6 +555,7 @@ DOCTEST_TEST_CASE("ShvLog")
 		init_file_journal(file_journal);
 
 		int64_t msec = device_stop2_msec + 1000 * 60 * 24;
+		const int64_t first_file_msec = msec;
 
 		for (int i = 0; i < 30000; ++i) {
 			msec += 1234;
@@ -560,7 +567,142 @@ DOCTEST_TEST_CASE("ShvLog")
 			e.setSpontaneous(true);
 			file_journal.append(e);
 		}
-		const auto &ctx = file_journal.checkJournalContext(true);
-		REQUIRE(ctx.files.size() == JOURNAL_FILES_CNT);
+		// catalogue kept by writes and rotation must match the journal dir content
+		const auto ctx = file_journal.checkJournalContext();
+		const auto &scanned_ctx = file_journal.checkJournalContext(ShvFileJournal::Force);
+		REQUIRE(scanned_ctx.files.size() == JOURNAL_FILES_CNT);
+		REQUIRE(ctx.files == scanned_ctx.files);
+		REQUIRE(ctx.journalSize == scanned_ctx.journalSize);
+		REQUIRE(ctx.lastFileSize == scanned_ctx.lastFileSize);
+		size_t catalogued_summary_cnt = 0;
+		for (size_t i = 0; i < ctx.files.size(); ++i) {
+			REQUIRE(ctx.fileInfos[i].size == scanned_ctx.fileInfos[i].size);
+			REQUIRE(ctx.fileInfos[i].summarySize == scanned_ctx.fileInfos[i].summarySize);
+			if (ctx.fileInfos[i].summarySize > 0)
+				catalogued_summary_cnt++;
+			// closed files created by this journal have summary, it is part of journal size,
+			// summary of file created before journal was opened is created by getLog when needed
+			if (ctx.files[i] > first_file_msec)
+				REQUIRE((ctx.fileInfos[i].summarySize > 0) == (i + 1 < ctx.files.size()));
+		}
+		REQUIRE(ctx.fileInfos.back().lastEntryMsec == msec);
+		// summaries of rotated files are deleted together with them
+		size_t summary_cnt = 0;
+		for (const auto &entry : std::filesystem::directory_iterator(ctx.journalDir)) {
+			if (entry.path().string().ends_with(ShvJournalFileSummary::FILE_EXT))
+				summary_cnt++;
+		}
+		REQUIRE(summary_cnt == catalogued_summary_cnt);
+		// summary collected by appends is the same as summary created by parsing the file
+		for (size_t i = 0; i < ctx.files.size(); ++i) {
+			if (ctx.fileInfos[i].summarySize == 0)
+				continue;
+			const auto file_path = ctx.fileMsecToFilePath(ctx.files[i]);
+			const auto saved_summary = ShvJournalFileSummary::forJournalFile(file_path);
+			REQUIRE(saved_summary.snapshot.keyvals.size() > 0);
+			REQUIRE(saved_summary.toRpcValue() == ShvJournalFileSummary::fromJournalFile(file_path).toRpcValue());
+		}
+
+		const auto first_file = scanned_ctx.fileMsecToFilePath(scanned_ctx.files.front());
+		std::filesystem::remove(first_file);
+		REQUIRE(file_journal.checkJournalContext().files.size() == JOURNAL_FILES_CNT - 1);
+		REQUIRE(!std::filesystem::exists(ShvJournalFileSummary::summaryFilePath(first_file)));
+	}
+}
+
+DOCTEST_TEST_CASE("ShvFileJournal asyncGetLog")
+{
+	const std::string journal_dir = TEST_DIR + "/async";
+	std::filesystem::remove_all(journal_dir);
+	ShvFileJournal file_journal;
+	file_journal.setJournalDir(journal_dir);
+	file_journal.setFileSizeLimit(1024);
+	file_journal.setJournalSizeLimit(4 * 1024);
+
+	int64_t msec = RpcValue::DateTime::fromUtcString("2024-01-01T00:00:00Z").msecsSinceEpoch();
+	int record_cnt = 0;
+	auto append_entries = [&](int n) {
+		for (int i = 0; i < n; ++i) {
+			msec += 1000;
+			file_journal.append(ShvJournalEntry("async/test", record_cnt++, ShvJournalEntry::DOMAIN_VAL_CHANGE, ShvJournalEntry::NO_SHORT_TIME, ShvJournalEntry::NO_VALUE_FLAGS, msec));
+		}
+	};
+	append_entries(100);
+	const auto files_before = file_journal.checkJournalContext().files;
+
+	ShvGetLogParams params;
+	params.recordCountLimit = 1000000;
+	auto get_log = file_journal.asyncGetLog(params);
+	REQUIRE(file_journal.activeReaderCount() == 1);
+	const auto first_file = file_journal.checkJournalContext().fileMsecToFilePath(files_before.front());
+
+	// journal grows over its limit, but files read by getLog are not deleted
+	append_entries(200);
+	REQUIRE(std::filesystem::exists(first_file));
+	std::atomic<bool> cancelled = false;
+	const auto log = get_log(cancelled);
+	REQUIRE(ShvLogRpcValueReader(log).logHeader().recordCount() > 0);
+
+	get_log = {};
+	REQUIRE(file_journal.activeReaderCount() == 0);
+	append_entries(1);
+	REQUIRE(!std::filesystem::exists(first_file));
+	REQUIRE(file_journal.checkJournalContext().journalSize <= 4 * 1024);
+
+	cancelled = true;
+	REQUIRE_THROWS_AS(std::ignore = file_journal.asyncGetLog(params)(cancelled), shv::core::Exception);
+	REQUIRE(file_journal.activeReaderCount() == 0);
+}
+
+DOCTEST_TEST_CASE("ShvJournalFileSummary")
+{
+	const std::string journal_dir = TEST_DIR + "/summary";
+	std::filesystem::remove_all(journal_dir);
+	ShvFileJournal file_journal;
+	file_journal.setJournalDir(journal_dir);
+	file_journal.setFileSizeLimit(1024);
+
+	int64_t msec = RpcValue::DateTime::fromUtcString("2022-07-07T18:00:00.000Z").msecsSinceEpoch();
+	auto append = [&](const std::string &path, int count) {
+		for (int i = 0; i < count; ++i) {
+			msec += 100;
+			ShvJournalEntry e;
+			e.epochMsec = msec;
+			e.path = path;
+			e.domain = ShvJournalEntry::DOMAIN_VAL_CHANGE;
+			e.value = i;
+			file_journal.append(e);
+		}
+	};
+	append("node/a", 200);
+	append("node/b", 100);
+	append("node/a", 50);
+	const auto files = file_journal.checkJournalContext(true).files;
+	REQUIRE(files.size() > 2);
+
+	auto first_file = journal_dir + '/' + ShvFileJournal::JournalContext::fileMsecToFileName(files.front());
+	auto summary = ShvJournalFileSummary::fromJournalFile(first_file);
+	REQUIRE(summary.paths == std::set<std::string>{"node/a"});
+	REQUIRE(summary.sinceMsec == files.front());
+	REQUIRE(summary.snapshot.keyvals.count("node/a") == 1);
+	REQUIRE(ShvJournalFileSummary::fromRpcValue(summary.toRpcValue()).toRpcValue() == summary.toRpcValue());
+
+	ShvGetLogParams params;
+	params.pathPattern = "node/b";
+	std::vector<std::function<ShvJournalFileReader()>> all_readers;
+	for (auto file_msec : files) {
+		all_readers.emplace_back([fn = journal_dir + '/' + ShvFileJournal::JournalContext::fileMsecToFileName(file_msec)] { return ShvJournalFileReader(fn); });
+	}
+	const auto now = RpcValue::DateTime::now();
+	auto log = file_journal.getLog(params);
+	auto expected_log = shv::core::utils::getLog(all_readers, params, now);
+	REQUIRE(log.asList() == expected_log.asList());
+	ShvLogRpcValueReader rd(log);
+	while (rd.next()) {
+		REQUIRE(rd.entry().path == "node/b");
 	}
+	// summaries are created when file is closed
+	REQUIRE(std::filesystem::exists(ShvJournalFileSummary::summaryFilePath(first_file)));
+	REQUIRE(!std::filesystem::exists(ShvJournalFileSummary::summaryFilePath(journal_dir + '/' + ShvFileJournal::JournalContext::fileMsecToFileName(files.back()))));
+	REQUIRE(ShvJournalFileSummary::forJournalFile(first_file).toRpcValue() == summary.toRpcValue());
 }
@@ -1,3 +1,4 @@
+#include <shv/core/utils/patternmatcher.h>
 #include <shv/core/utils/shvpath.h>
 #include <shv/core/stringview.h>
 
@@ -128,6 +129,21 @@ DOCTEST_TEST_CASE("ShvPath")
 		for(const Test &t : cases) {
 			REQUIRE(shv::core::utils::ShvPath(t.path).matchWild(t.pattern) == t.result);
 		}
+		DOCTEST_SUBCASE("PatternMatcher")
+		{
+			for(const Test &t : cases) {
+				if(t.pattern.empty())
+					continue;
+				ShvGetLogParams params;
+				params.pathPattern = t.pattern;
+				PatternMatcher matcher(params);
+				CAPTURE(t.path);
+				CAPTURE(t.pattern);
+				REQUIRE(matcher.match(t.path, {}) == t.result);
+				// second lookup is served from match cache
+				REQUIRE(matcher.match(t.path, {}) == t.result);
+			}
+		}
 	}
 
 }
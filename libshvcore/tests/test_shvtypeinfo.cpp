@@ -302,3 +302,62 @@ DOCTEST_TEST_CASE("ShvTypeInfo")
 		}
 	}
 }
+
+DOCTEST_TEST_CASE("ShvTypeInfo path index")
+{
+	ShvTypeInfo type_info;
+	ShvPropertyDescr status;
+	status.setName("status");
+	status.setTypeName("Status");
+	ShvPropertyDescr root_property;
+	root_property.setName("");
+	root_property.setTypeName("Root");
+	type_info.setDevicePath("devices/a", "A");
+	type_info.setDevicePath("devices/a/b", "B");
+	type_info.setPropertyDescription("A", root_property);
+	type_info.setPropertyDescription("A", status);
+	type_info.setPropertyDescription("B", status);
+
+	DOCTEST_SUBCASE("longest device path prefix")
+	{
+		auto pi = type_info.pathInfo("devices/a/b/status/occupied");
+		REQUIRE(pi.devicePath == "devices/a/b");
+		REQUIRE(pi.deviceType == "B");
+		REQUIRE(pi.propertyDescription.name() == "status");
+		REQUIRE(pi.fieldPath == "occupied");
+
+		pi = type_info.pathInfo("devices/a/bb/status");
+		REQUIRE(pi.devicePath == "devices/a");
+		REQUIRE(pi.propertyDescription.typeName() == "Root");
+		REQUIRE(pi.fieldPath == "bb/status");
+
+		pi = type_info.pathInfo("devices/x");
+		REQUIRE(pi.devicePath.empty());
+		REQUIRE(!pi.propertyDescription.isValid());
+	}
+
+	DOCTEST_SUBCASE("memo is invalidated on change")
+	{
+		type_info.setPathInfoCacheCapacity(2);
+		REQUIRE(type_info.pathInfo("devices/a/status").propertyDescription.typeName() == "Status");
+		REQUIRE(type_info.pathInfo("devices/a/status").propertyDescription.typeName() == "Status");
+		status.setTypeName("Status2");
+		type_info.setPropertyDescription("A", status);
+		REQUIRE(type_info.pathInfo("devices/a/status").propertyDescription.typeName() == "Status2");
+		REQUIRE(type_info.pathInfo("devices/a/b/status").deviceType == "B");
+		REQUIRE(type_info.pathInfo("devices/a/foo").propertyDescription.typeName() == "Root");
+		type_info.setDevicePath("devices/a/foo", "B");
+		REQUIRE(type_info.pathInfo("devices/a/foo").deviceType == "B");
+	}
+
+	DOCTEST_SUBCASE("removed property")
+	{
+		ShvPropertyDescr removed;
+		removed.setName("");
+		type_info.setPropertyDescription("A", removed);
+		auto pi = type_info.pathInfo("devices/a/status/occupied");
+		REQUIRE(pi.propertyDescription.typeName() == "Status");
+		pi = type_info.pathInfo("devices/a/foo");
+		REQUIRE(!pi.propertyDescription.isValid());
+	}
+}
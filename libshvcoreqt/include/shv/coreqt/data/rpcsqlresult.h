@@ -4,10 +4,13 @@
 
 #include <shv/chainpack/rpcvalue.h>
 
+#include <QHash>
 #include <QVector>
 #include <QVariantList>
 
 #include <optional>
+#include <variant>
+#include <vector>
 
 namespace shv::chainpack { class RpcResponse; }
 
@@ -29,30 +32,83 @@ public:
 	static RpcSqlField fromVariant(const QVariant &v);
 };
 
+/// Column values stored in vector of the column type,
+/// column type is set by first not-null value and falls back to RpcValue
+/// when value of other type is stored later
+class SHVCOREQT_DECL_EXPORT RpcSqlColumn
+{
+public:
+	/// order matches alternatives of Data
+	enum class Type {Null = 0, Int, UInt, Double, Bool, String, DateTime, RpcValue};
+
+	Type type() const { return static_cast<Type>(m_data.index()); }
+	qsizetype size() const { return static_cast<qsizetype>(m_nulls.size()); }
+	void reserve(qsizetype size);
+	bool isNull(qsizetype row) const { return m_nulls[static_cast<size_t>(row)]; }
+
+	shv::chainpack::RpcValue rpcValue(qsizetype row) const;
+	QVariant value(qsizetype row) const;
+	void append(const shv::chainpack::RpcValue &val);
+	void setValue(qsizetype row, const shv::chainpack::RpcValue &val);
+private:
+	static Type typeOf(const shv::chainpack::RpcValue &val);
+	void ensureType(Type type);
+private:
+	using Data = std::variant<
+		std::monostate,
+		std::vector<int64_t>,
+		std::vector<uint64_t>,
+		std::vector<double>,
+		std::vector<bool>,
+		std::vector<std::string>,
+		std::vector<shv::chainpack::RpcValue::DateTime>,
+		std::vector<shv::chainpack::RpcValue>
+	>;
+	Data m_data;
+	std::vector<bool> m_nulls;
+};
+
 class SHVCOREQT_DECL_EXPORT RpcSqlResult
 {
 public:
 	int numRowsAffected = 0;
 	int lastInsertId = 0;
 	QString lastError;
-	QVector<RpcSqlField> fields;
 	using Row = QVariantList;
-	QVariantList rows;
 public:
 	explicit RpcSqlResult() = default;
 	explicit RpcSqlResult(const shv::chainpack::RpcResponse &resp);
 
+	const QVector<RpcSqlField>& fields() const { return m_fields; }
+	/// removes all rows
+	void setFields(const QVector<RpcSqlField> &fields);
+	const RpcSqlColumn& column(qsizetype col) const { return m_columns[static_cast<size_t>(col)]; }
+	qsizetype columnCount() const { return m_fields.size(); }
+	qsizetype rowCount() const { return m_rowCount; }
+	Row row(qsizetype row) const;
+	/// missing values are set to NULL
+	void appendRow(const Row &row);
+	void appendRow(const shv::chainpack::RpcValue::List &row);
+
+	/// column names are case insensitive
 	std::optional<qsizetype> columnIndex(const QString &name) const;
 	QVariant value(qsizetype row, qsizetype col) const;
 	QVariant value(qsizetype row, const QString &name) const;
 	void setValue(qsizetype row, qsizetype col, const QVariant &val);
 	void setValue(qsizetype row, const QString &name, const QVariant &val);
 
-	bool isSelect() const {return !fields.isEmpty();}
+	bool isSelect() const {return !m_fields.isEmpty();}
 	shv::chainpack::RpcValue toRpcValue() const;
 	QVariant toVariant() const;
 	static RpcSqlResult fromVariant(const QVariant &v);
 	static RpcSqlResult fromRpcValue(const shv::chainpack::RpcValue &rv);
+private:
+	void loadRpcValue(const shv::chainpack::RpcValue::Map &map);
+private:
+	QVector<RpcSqlField> m_fields;
+	QHash<QString, qsizetype> m_columnIndexes;
+	std::vector<RpcSqlColumn> m_columns;
+	qsizetype m_rowCount = 0;
 };
 
 }
@@ -51,57 +51,204 @@ RpcSqlField RpcSqlField::fromVariant(const QVariant &v)
 	return ret;
 }
 
-RpcSqlResult::RpcSqlResult(const shv::chainpack::RpcResponse &resp)
+//======================================================
+// RpcSqlColumn
+//======================================================
+namespace {
+template<typename T>
+T cell_value(const RpcValue &val)
 {
-	if(resp.isSuccess()) {
-		const RpcValue::Map result = resp.result().asMap();
-		for(const RpcValue &rv : result.valref("fields").asList()) {
-			RpcSqlField fld;
-			fld.name = QString::fromStdString(rv.asMap().value("name").toString());
-			fld.type = rv.asMap().value("type").toInt();
-			fields.append(fld);
+	if constexpr (std::is_same_v<T, int64_t>)
+		return val.toInt64();
+	else if constexpr (std::is_same_v<T, uint64_t>)
+		return val.toUInt64();
+	else if constexpr (std::is_same_v<T, double>)
+		return val.toDouble();
+	else if constexpr (std::is_same_v<T, bool>)
+		return val.toBool();
+	else if constexpr (std::is_same_v<T, std::string>)
+		return val.asString();
+	else if constexpr (std::is_same_v<T, RpcValue::DateTime>)
+		return val.toDateTime();
+	else
+		return val;
+}
+}
+
+void RpcSqlColumn::reserve(qsizetype size)
+{
+	m_nulls.reserve(static_cast<size_t>(size));
+	std::visit([size](auto &v) {
+		if constexpr (!std::is_same_v<std::decay_t<decltype(v)>, std::monostate>)
+			v.reserve(static_cast<size_t>(size));
+	}, m_data);
+}
+
+RpcValue RpcSqlColumn::rpcValue(qsizetype row) const
+{
+	if(isNull(row))
+		return RpcValue(nullptr);
+	return std::visit([row](const auto &v) -> RpcValue {
+		if constexpr (std::is_same_v<std::decay_t<decltype(v)>, std::monostate>)
+			return RpcValue(nullptr);
+		else
+			return RpcValue(v[static_cast<size_t>(row)]);
+	}, m_data);
+}
+
+QVariant RpcSqlColumn::value(qsizetype row) const
+{
+	if(isNull(row))
+		return QVariant::fromValue(nullptr);
+	if(const auto *strings = std::get_if<std::vector<std::string>>(&m_data))
+		return QString::fromStdString((*strings)[static_cast<size_t>(row)]);
+	return shv::coreqt::rpc::rpcValueToQVariant(rpcValue(row));
+}
+
+void RpcSqlColumn::append(const RpcValue &val)
+{
+	const bool is_null = !val.isValid() || val.isNull();
+	if(!is_null)
+		ensureType(typeOf(val));
+	m_nulls.push_back(is_null);
+	std::visit([&val, is_null](auto &v) {
+		using Vector = std::decay_t<decltype(v)>;
+		if constexpr (!std::is_same_v<Vector, std::monostate>) {
+			if(is_null)
+				v.emplace_back();
+			else
+				v.push_back(cell_value<typename Vector::value_type>(val));
 		}
-		for(const RpcValue &rowv : result.valref("rows").asList()) {
-			Row row;
-			for(const RpcValue &rv : rowv.asList()) {
-				bool ok;
-				QVariant v = shv::coreqt::rpc::rpcValueToQVariant(rv, &ok);
-				if (!ok) {
-					shvError() << "Cannot convert:" << rv.toCpon() << "to QVariant";
-				}
-				row.append(v);
-			}
-			rows.insert(rows.count(), row);
+	}, m_data);
+}
+
+void RpcSqlColumn::setValue(qsizetype row, const RpcValue &val)
+{
+	const bool is_null = !val.isValid() || val.isNull();
+	if(!is_null)
+		ensureType(typeOf(val));
+	const auto ix = static_cast<size_t>(row);
+	m_nulls[ix] = is_null;
+	std::visit([&val, is_null, ix](auto &v) {
+		using Vector = std::decay_t<decltype(v)>;
+		if constexpr (!std::is_same_v<Vector, std::monostate>)
+			v[ix] = is_null? typename Vector::value_type{}: cell_value<typename Vector::value_type>(val);
+	}, m_data);
+}
+
+RpcSqlColumn::Type RpcSqlColumn::typeOf(const RpcValue &val)
+{
+	switch (val.type()) {
+	case RpcValue::Type::Int: return Type::Int;
+	case RpcValue::Type::UInt: return Type::UInt;
+	case RpcValue::Type::Double: return Type::Double;
+	case RpcValue::Type::Bool: return Type::Bool;
+	case RpcValue::Type::String: return Type::String;
+	case RpcValue::Type::DateTime: return Type::DateTime;
+	default: return Type::RpcValue;
+	}
+}
+
+void RpcSqlColumn::ensureType(Type type)
+{
+	const auto current_type = this->type();
+	if(current_type == type || current_type == Type::RpcValue)
+		return;
+	const auto n = m_nulls.size();
+	if(current_type == Type::Null) {
+		// all values stored so far are NULL
+		switch (type) {
+		case Type::Null: break;
+		case Type::Int: m_data.emplace<std::vector<int64_t>>(n); break;
+		case Type::UInt: m_data.emplace<std::vector<uint64_t>>(n); break;
+		case Type::Double: m_data.emplace<std::vector<double>>(n); break;
+		case Type::Bool: m_data.emplace<std::vector<bool>>(n); break;
+		case Type::String: m_data.emplace<std::vector<std::string>>(n); break;
+		case Type::DateTime: m_data.emplace<std::vector<RpcValue::DateTime>>(n); break;
+		case Type::RpcValue: m_data.emplace<std::vector<RpcValue>>(n); break;
 		}
-		numRowsAffected = result.value("numRowsAffected").toInt();
-		lastInsertId = result.value("lastInserId").toInt();
+		return;
+	}
+	// mixed types, column falls back to generic values
+	std::vector<RpcValue> values;
+	values.reserve(n);
+	for(size_t i = 0; i < n; ++i)
+		values.push_back(rpcValue(static_cast<qsizetype>(i)));
+	m_data = std::move(values);
+}
+
+//======================================================
+// RpcSqlResult
+//======================================================
+RpcSqlResult::RpcSqlResult(const shv::chainpack::RpcResponse &resp)
+{
+	if(resp.isSuccess()) {
+		loadRpcValue(resp.result().asMap());
 	}
 	else {
 		lastError = QString::fromStdString(resp.errorString());
 	}
 }
 
+void RpcSqlResult::setFields(const QVector<RpcSqlField> &fields)
+{
+	m_fields = fields;
+	m_columnIndexes.clear();
+	for (qsizetype col = m_fields.size() - 1; col >= 0; --col) {
+		// first of duplicate column names wins
+		m_columnIndexes.insert(m_fields[col].name.toCaseFolded(), col);
+	}
+	m_columns.assign(static_cast<size_t>(m_fields.size()), {});
+	m_rowCount = 0;
+}
+
+RpcSqlResult::Row RpcSqlResult::row(qsizetype row) const
+{
+	Row ret;
+	if (row >= 0 && row < m_rowCount) {
+		ret.reserve(columnCount());
+		for (const auto &column : m_columns)
+			ret.append(column.value(row));
+	}
+	return ret;
+}
+
+void RpcSqlResult::appendRow(const Row &row)
+{
+	for (qsizetype col = 0; col < columnCount(); ++col) {
+		m_columns[static_cast<size_t>(col)].append(col < row.size()? shv::coreqt::rpc::qVariantToRpcValue(row[col]): RpcValue(nullptr));
+	}
+	m_rowCount++;
+}
+
+void RpcSqlResult::appendRow(const shv::chainpack::RpcValue::List &row)
+{
+	for (size_t col = 0; col < m_columns.size(); ++col) {
+		m_columns[col].append(col < row.size()? row[col]: RpcValue(nullptr));
+	}
+	m_rowCount++;
+}
+
 QVariant RpcSqlResult::value(qsizetype row, qsizetype col) const
 {
-	return rows.value(row).toList().value(col);
+	if (row >= 0 && row < m_rowCount && col >= 0 && col < columnCount()) {
+		return m_columns[static_cast<size_t>(col)].value(row);
+	}
+	return {};
 }
 
 QVariant RpcSqlResult::value(qsizetype row, const QString &name) const
 {
 	if (auto ix = columnIndex(name); ix.has_value()) {
-		return rows.value(row).toList().value(ix.value());
+		return value(row, ix.value());
 	}
 	return {};
 }
 
 void RpcSqlResult::setValue(qsizetype row, qsizetype col, const QVariant &val)
 {
-	if (row >= 0 && row < rows.count()) {
-		auto r = rows[row].toList();
-		if (col >= 0 && col < r.count()) {
-			r[col] = val;
-			rows[row] = r;
-		}
+	if (row >= 0 && row < m_rowCount && col >= 0 && col < columnCount()) {
+		m_columns[static_cast<size_t>(col)].setValue(row, shv::coreqt::rpc::qVariantToRpcValue(val));
 	}
 }
 
@@ -114,18 +261,36 @@ void RpcSqlResult::setValue(qsizetype row, const QString &name, const QVariant &
 
 std::optional<qsizetype> RpcSqlResult::columnIndex(const QString &name) const
 {
-	for (auto col = 0; col < fields.size(); ++col) {
-		const auto &fld = fields[col];
-		if (fld.name.compare(name, Qt::CaseInsensitive) == 0) {
-			return col;
-		}
+	if (auto it = m_columnIndexes.constFind(name.toCaseFolded()); it != m_columnIndexes.cend()) {
+		return it.value();
 	}
 	return {};
 }
 
 RpcValue RpcSqlResult::toRpcValue() const
 {
-	return shv::coreqt::rpc::qVariantToRpcValue(toVariant());
+	RpcValue::Map ret;
+	if(isSelect()) {
+		RpcValue::List flds;
+		for(const auto &fld : m_fields)
+			flds.push_back(fld.toRpcValue());
+		ret["fields"] = std::move(flds);
+		RpcValue::List rows;
+		rows.reserve(static_cast<size_t>(m_rowCount));
+		for (qsizetype row = 0; row < m_rowCount; ++row) {
+			RpcValue::List r;
+			r.reserve(m_columns.size());
+			for (const auto &column : m_columns)
+				r.push_back(column.rpcValue(row));
+			rows.push_back(std::move(r));
+		}
+		ret["rows"] = std::move(rows);
+	}
+	else {
+		ret["numRowsAffected"] = numRowsAffected;
+		ret["lastInsertId"] = lastInsertId;
+	}
+	return RpcValue(std::move(ret));
 }
 
 QVariant RpcSqlResult::toVariant() const
@@ -133,9 +298,13 @@ QVariant RpcSqlResult::toVariant() const
 	QVariantMap ret;
 	if(isSelect()) {
 		QVariantList flds;
-		for(const auto &fld : this->fields)
+		for(const auto &fld : m_fields)
 			flds.push_back(fld.toVariant());
 		ret["fields"] = flds;
+		QVariantList rows;
+		rows.reserve(m_rowCount);
+		for (qsizetype r = 0; r < m_rowCount; ++r)
+			rows.push_back(row(r));
 		ret["rows"] = rows;
 	}
 	else {
@@ -155,17 +324,43 @@ RpcSqlResult RpcSqlResult::fromVariant(const QVariant &v)
 		ret.lastInsertId = map.value("lastInsertId").toInt();
 	}
 	else {
+		QVector<RpcSqlField> fields;
 		for(const QVariant &fv : flds)
-			ret.fields.append(RpcSqlField::fromVariant(fv));
-		ret.rows = map.value("rows").toList();
+			fields.append(RpcSqlField::fromVariant(fv));
+		ret.setFields(fields);
+		const QVariantList rows = map.value("rows").toList();
+		for (auto &column : ret.m_columns)
+			column.reserve(rows.size());
+		for(const QVariant &row : rows)
+			ret.appendRow(row.toList());
 	}
 	return ret;
 }
 
 RpcSqlResult RpcSqlResult::fromRpcValue(const shv::chainpack::RpcValue &rv)
 {
-	auto v = shv::coreqt::rpc::rpcValueToQVariant(rv);
-	return fromVariant(v);
+	RpcSqlResult ret;
+	ret.loadRpcValue(rv.asMap());
+	return ret;
+}
+
+void RpcSqlResult::loadRpcValue(const shv::chainpack::RpcValue::Map &map)
+{
+	const auto &flds = map.valref("fields").asList();
+	if(flds.empty()) {
+		numRowsAffected = map.value("numRowsAffected").toInt();
+		lastInsertId = map.value("lastInsertId").toInt();
+		return;
+	}
+	QVector<RpcSqlField> fields;
+	for(const auto &fv : flds)
+		fields.append(RpcSqlField::fromRpcValue(fv));
+	setFields(fields);
+	const auto &rows = map.valref("rows").asList();
+	for (auto &column : m_columns)
+		column.reserve(static_cast<qsizetype>(rows.size()));
+	for(const auto &row : rows)
+		appendRow(row.asList());
 }
 
 }
@@ -0,0 +1,89 @@
+#include <shv/coreqt/data/rpcsqlresult.h>
+
+#include <QVariant>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+using namespace shv::coreqt::data;
+using namespace shv::chainpack;
+using namespace std;
+
+namespace {
+RpcValue select_result()
+{
+	return RpcValue::Map {
+		{"fields", RpcValue::List {
+			RpcValue::Map{{"name", "id"}, {"type", QMetaType::Int}},
+			RpcValue::Map{{"name", "Name"}, {"type", QMetaType::QString}},
+			RpcValue::Map{{"name", "value"}, {"type", QMetaType::Double}},
+		}},
+		{"rows", RpcValue::List {
+			RpcValue::List{1, "foo", 1.5},
+			RpcValue::List{2, nullptr, 2},
+			RpcValue::List{3, "baz"},
+		}},
+	};
+}
+}
+
+DOCTEST_TEST_CASE("RpcSqlResult")
+{
+	auto result = RpcSqlResult::fromRpcValue(select_result());
+	REQUIRE(result.isSelect());
+	REQUIRE(result.rowCount() == 3);
+	REQUIRE(result.columnCount() == 3);
+
+	DOCTEST_SUBCASE("typed columns")
+	{
+		REQUIRE(result.column(0).type() == RpcSqlColumn::Type::Int);
+		REQUIRE(result.column(1).type() == RpcSqlColumn::Type::String);
+		// Int value in Double column
+		REQUIRE(result.column(2).type() == RpcSqlColumn::Type::RpcValue);
+		REQUIRE(result.column(1).isNull(1));
+		REQUIRE(result.column(2).isNull(2));
+	}
+
+	DOCTEST_SUBCASE("value access")
+	{
+		REQUIRE(result.columnIndex("name") == 1);
+		REQUIRE(result.columnIndex("NAME") == 1);
+		REQUIRE(!result.columnIndex("foo").has_value());
+		REQUIRE(result.value(0, "name").toString() == "foo");
+		REQUIRE(result.value(2, 0).toInt() == 3);
+		REQUIRE(result.value(1, "value").toDouble() == 2);
+		REQUIRE(!result.value(3, 0).isValid());
+		REQUIRE(result.row(0) == QVariantList{1, "foo", 1.5});
+
+		result.setValue(1, "name", "bar");
+		REQUIRE(result.value(1, 1).toString() == "bar");
+		result.setValue(0, "id", QVariant::fromValue(nullptr));
+		REQUIRE(result.column(0).isNull(0));
+	}
+
+	DOCTEST_SUBCASE("round trip")
+	{
+		auto rv = result.toRpcValue();
+		REQUIRE(rv.asMap().valref("rows").asList().at(2) == RpcValue(RpcValue::List{3, "baz", nullptr}));
+		auto result2 = RpcSqlResult::fromRpcValue(rv);
+		REQUIRE(result2.toRpcValue() == rv);
+		auto result3 = RpcSqlResult::fromVariant(result.toVariant());
+		REQUIRE(result3.toRpcValue() == rv);
+	}
+
+	DOCTEST_SUBCASE("append row")
+	{
+		result.appendRow(RpcSqlResult::Row{4, "qux", 4.5});
+		REQUIRE(result.rowCount() == 4);
+		REQUIRE(result.value(3, "name").toString() == "qux");
+	}
+}
+
+DOCTEST_TEST_CASE("RpcSqlResult of non-select query")
+{
+	auto result = RpcSqlResult::fromRpcValue(RpcValue::Map{{"numRowsAffected", 5}, {"lastInsertId", 7}});
+	REQUIRE(!result.isSelect());
+	REQUIRE(result.numRowsAffected == 5);
+	REQUIRE(result.lastInsertId == 7);
+	REQUIRE(result.toRpcValue() == RpcValue(RpcValue::Map{{"numRowsAffected", 5}, {"lastInsertId", 7}}));
+}
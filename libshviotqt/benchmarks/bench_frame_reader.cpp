@@ -0,0 +1,81 @@
+#include <shv/iotqt/rpc/socket.h>
+#include <shv/iotqt/rpc/serialportsocket.h>
+
+#include <benchmark/benchmark.h>
+
+#include <QBuffer>
+
+#include <random>
+
+using namespace shv::iotqt::rpc;
+using namespace shv::chainpack;
+
+namespace {
+// typical TCP segment payload, socket data arrive in chunks of this size
+constexpr size_t READ_CHUNK_SIZE = 1460;
+
+std::string make_blob_frame_data(size_t blob_size)
+{
+	std::mt19937 gen(blob_size);
+	std::uniform_int_distribution<int> dist(0, 255);
+	RpcValue::Blob blob(blob_size);
+	for(auto &b : blob)
+		b = static_cast<uint8_t>(dist(gen));
+	RpcResponse resp;
+	resp.setRequestId(1);
+	resp.setResult(blob);
+	return resp.toRpcFrame().toFrameData();
+}
+
+std::string write_frames(FrameWriter &wr, const std::string &frame_data, int64_t frame_count)
+{
+	for(int64_t i = 0; i < frame_count; ++i)
+		wr.addFrame(frame_data);
+	QByteArray ba;
+	QBuffer buffer(&ba);
+	buffer.open(QIODevice::WriteOnly);
+	wr.flushToDevice(&buffer);
+	return std::string(ba.constData(), static_cast<size_t>(ba.size()));
+}
+
+void read_frames(benchmark::State &state, FrameReader &rd, const std::string &data)
+{
+	for(auto _ : state) {
+		for(size_t pos = 0; pos < data.size(); pos += READ_CHUNK_SIZE)
+			rd.addData(std::string_view(data).substr(pos, READ_CHUNK_SIZE));
+		auto frames = rd.takeFrames();
+		benchmark::DoNotOptimize(frames);
+	}
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data.size()));
+}
+
+void BM_StreamFrameReader_addData(benchmark::State &state)
+{
+	StreamFrameWriter wr;
+	const auto data = write_frames(wr, make_blob_frame_data(static_cast<size_t>(state.range(0))), 16);
+	StreamFrameReader rd;
+	read_frames(state, rd, data);
+}
+BENCHMARK(BM_StreamFrameReader_addData)->Arg(64)->Arg(64 * 1024);
+
+void BM_SerialFrameReader_addData(benchmark::State &state)
+{
+	SerialFrameWriter wr(SerialFrameWriter::CrcCheck::Yes);
+	const auto data = write_frames(wr, make_blob_frame_data(static_cast<size_t>(state.range(0))), 16);
+	SerialFrameReader rd(SerialFrameReader::CrcCheck::Yes);
+	read_frames(state, rd, data);
+}
+BENCHMARK(BM_SerialFrameReader_addData)->Arg(64)->Arg(64 * 1024);
+
+void BM_SerialFrameWriter_addFrame(benchmark::State &state)
+{
+	const auto frame_data = make_blob_frame_data(static_cast<size_t>(state.range(0)));
+	SerialFrameWriter wr(SerialFrameWriter::CrcCheck::Yes);
+	for(auto _ : state) {
+		wr.addFrame(frame_data);
+		wr.clear();
+	}
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * frame_data.size()));
+}
+BENCHMARK(BM_SerialFrameWriter_addFrame)->Arg(64)->Arg(64 * 1024);
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <shv/iotqt/shviotqtglobal.h>
+
+#include <shv/chainpack/rpcmessage.h>
+
+#include <QObject>
+#include <QThreadPool>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+
+namespace shv::core::utils { class ShvFileJournal; }
+
+namespace shv::iotqt::node {
+
+/// Executes long running methods like getLog on worker threads, so that reading of journal files
+/// does not stall heartbeats, signals and other requests served by the event loop.
+/// Only the final response is posted back to runner's thread and emitted by responseReady().
+///
+/// Typical use in ShvNode::processRpcRequest(), response is not sent when invalid value is returned:
+/// @code
+/// if(rq.method() == Rpc::METH_GET_LOG) {
+/// 	m_asyncRunner->runGetLog(rq, m_journal);
+/// 	return {};
+/// }
+/// @endcode
+class SHVIOTQT_DECL_EXPORT AsyncMethodRunner : public QObject
+{
+	Q_OBJECT
+public:
+	/// method runs on worker thread, so it must not touch objects living in runner's thread,
+	/// it should check cancelled flag periodically and throw or return when it is set
+	using Method = std::function<chainpack::RpcValue (const std::atomic<bool> &cancelled)>;
+	static constexpr std::chrono::milliseconds DEFAULT_TIMEOUT = std::chrono::minutes(1);
+
+	explicit AsyncMethodRunner(QObject *parent = nullptr);
+	/// cancels pending methods and waits for worker threads
+	~AsyncMethodRunner() override;
+
+	void setMaxThreadCount(int n);
+	/// method not finished in time is cancelled and MethodCallTimeout error is sent, 0 disables the timeout
+	void setTimeout(std::chrono::milliseconds timeout);
+
+	void run(const chainpack::RpcRequest &rq, Method method);
+	/// serves getLog request from journal files, rotation of journal is postponed until the request is finished
+	void runGetLog(const chainpack::RpcRequest &rq, core::utils::ShvFileJournal &journal);
+	/// cancels methods requested by caller, for example when broker client with caller_id disconnects,
+	/// no response is sent for them
+	void cancelCaller(int caller_id);
+	/// cancels all pending methods, for example when connection to the broker is lost
+	void cancelAll();
+	size_t pendingCount() const { return m_pendingCalls.size(); }
+
+	Q_SIGNAL void responseReady(const shv::chainpack::RpcResponse &resp);
+private:
+	struct PendingCall;
+	void onCallFinished(int call_id, const chainpack::RpcResponse &resp);
+	void onCallTimeout(int call_id);
+private:
+	QThreadPool m_threadPool;
+	std::chrono::milliseconds m_timeout = DEFAULT_TIMEOUT;
+	int m_lastCallId = 0;
+	std::map<int, std::shared_ptr<PendingCall>> m_pendingCalls;
+};
+
+}
@@ -15,6 +15,11 @@ class SHVIOTQT_DECL_EXPORT FileNode : public ShvNode
 
 public:
 	static const std::vector<shv::chainpack::MetaMethod> meta_methods_file_base;
+	/// read and readCompressed return at most this many bytes when size param is set,
+	/// bigger files have to be read in chunks using offset and size params, read without size fails for them
+	static constexpr int64_t MAX_READ_SIZE = 16 * 1024 * 1024;
+	/// hash and default size implementation read file content in chunks of this size
+	static constexpr int64_t READ_CHUNK_SIZE = 1024 * 1024;
 public:
 	FileNode(const std::string &node_id, Super *parent = nullptr);
 
@@ -24,11 +29,16 @@ public:
 	const shv::chainpack::MetaMethod* metaMethod(const StringViewList &shv_path, size_t ix) override;
 protected:
 	virtual std::string fileName(const ShvNode::StringViewList &shv_path) const;
+	/// default implementation reads whole file in chunks, descendants should take size from file metadata
 	virtual shv::chainpack::RpcValue size(const ShvNode::StringViewList &shv_path) const;
 	virtual shv::chainpack::RpcValue readContent(const ShvNode::StringViewList &shv_path, int64_t offset, int64_t size) const = 0;
 
 private:
+	/// content range requested by offset and size params
+	shv::chainpack::RpcValue readRange(const ShvNode::StringViewList &shv_path, const chainpack::RpcValue &params) const;
 	shv::chainpack::RpcValue read(const ShvNode::StringViewList &shv_path, const chainpack::RpcValue &params) const;
+	shv::chainpack::RpcValue hash(const ShvNode::StringViewList &shv_path, const chainpack::RpcValue &params) const;
 	shv::chainpack::RpcValue readFileCompressed(const ShvNode::StringViewList &shv_path, const shv::chainpack::RpcValue &params) const;
+	shv::chainpack::RpcValue sizeCompressed(const ShvNode::StringViewList &shv_path, const shv::chainpack::RpcValue &params) const;
 };
 }
@@ -13,6 +13,8 @@
 #include <QMetaProperty>
 
 #include <cstddef>
+#include <optional>
+#include <unordered_map>
 
 namespace shv::chainpack { struct AccessGrant; }
 namespace shv::core::utils { class ShvJournalEntry; }
@@ -37,6 +39,8 @@ public:
 	ShvNode* parentNode() const;
 	QList<ShvNode*> ownChildren() const;
 	virtual ShvNode* childNode(const String &name, bool throw_exc = true) const;
+	/// returns nullptr if direct child node with node_id does not exist
+	ShvNode* findChildNode(StringView node_id) const;
 	virtual void setParentNode(ShvNode *parent);
 	virtual String nodeId() const;
 	void setNodeId(String &&n);
@@ -49,12 +53,24 @@ public:
 	void emitLogUserCommand(const shv::core::utils::ShvJournalEntry &e);
 
 	void setSortedChildren(bool b);
+	/// Results of dir and ls on node own path are cached, ls cache is invalidated when children change
+	/// by ShvNode constructor, destructor, setParentNode() or setNodeId().
+	/// Enable it only for nodes which do not override childNames() for own path
+	/// and which call invalidateDirCache() when their methods change.
+	void setDirLsCacheEnabled(bool b);
+	bool isDirLsCacheEnabled() const { return m_isDirLsCacheEnabled; }
 
 	void deleteIfEmptyWithParents();
 
 	bool isRootNode() const;
 
+	/// Frame is passed down through child nodes with fast routing enabled without calling their handleRpcFrame(),
+	/// path is rewritten only once, for the node which gets the frame.
 	virtual void handleRpcFrame(chainpack::RpcFrame &&frame);
+	/// Node with fast routing promises that it does not override childNode() and handleRpcFrame(),
+	/// so that frames and child lookups can pass it by without virtual calls. Disabled by default.
+	void setFastRouting(bool b);
+	bool isFastRouting() const { return m_isFastRouting; }
 	virtual void handleRpcRequest(const chainpack::RpcRequest &rq);
 	virtual chainpack::RpcValue handleRpcRequestImpl(const chainpack::RpcRequest &rq);
 	virtual chainpack::RpcValue processRpcRequest(const shv::chainpack::RpcRequest &rq);
@@ -84,11 +100,36 @@ public:
 public:
 	Q_SIGNAL void sendRpcMessage(const shv::chainpack::RpcMessage &msg);
 	Q_SIGNAL void logUserCommand(const shv::core::utils::ShvJournalEntry &e);
+protected:
+	void childEvent(QChildEvent *event) override;
+	/// child index and cached child names are rebuilt on next access
+	void invalidateChildIndex();
+	void invalidateDirCache();
 protected:
 	bool m_isRootNode = false;
+private:
+	void updateChildIndex() const;
+	/// findChildNode() for fast routing node, virtual childNode() otherwise
+	ShvNode* routingChildNode(StringView node_id) const;
 private:
 	String m_nodeId;
 	bool m_isSortedChildren = true;
+	bool m_isFastRouting = false;
+
+	mutable bool m_isChildIndexValid = false;
+	struct StringViewHash
+	{
+		using is_transparent = void;
+		size_t operator()(StringView sv) const { return std::hash<StringView>{}(sv); }
+	};
+	mutable std::unordered_map<String, ShvNode*, StringViewHash, std::equal_to<>> m_childIndex;
+	mutable std::optional<StringList> m_childNamesCache;
+	bool m_isDirLsCacheEnabled = false;
+	/// results of dir and ls without params, invalid when not cached
+	chainpack::RpcValue m_dirCache;
+	chainpack::RpcValue m_lsCache;
+	/// method name -> index of methods on node own path, every hit is validated against current method table
+	std::unordered_map<String, size_t> m_methodIndexCache;
 };
 
 /// helper class to save lines when creating root node
@@ -110,8 +151,12 @@ public:
 
 	size_t methodCount(const StringViewList &shv_path) override;
 	const shv::chainpack::MetaMethod* metaMethod(const StringViewList &shv_path, size_t ix) override;
+	/// cached dir result is invalidated when m_methods table is switched
+	shv::chainpack::RpcValue dir(const StringViewList &shv_path, const shv::chainpack::RpcValue &methods_params) override;
 protected:
 	const std::vector<shv::chainpack::MetaMethod> *m_methods = nullptr;
+private:
+	const std::vector<shv::chainpack::MetaMethod> *m_dirCacheMethods = nullptr;
 };
 
 
@@ -23,6 +23,7 @@ public:
 	CLIOPTION_GETTER_SETTER2(int, "rpc.rpcTimeout", r, setR, pcTimeout)
 	CLIOPTION_GETTER_SETTER2(int, "rpc.reconnectInterval", r, setR, econnectInterval)
 	CLIOPTION_GETTER_SETTER2(int, "rpc.heartbeatInterval", h, setH, eartBeatInterval)
+	CLIOPTION_GETTER_SETTER2(bool, "rpc.frameCompression", f, setF, rameCompression)
 };
 
 }
@@ -13,6 +13,8 @@
 #include <QObject>
 #include <QUrl>
 
+#include <unordered_map>
+
 class QTimer;
 
 namespace shv::iotqt::rpc {
@@ -33,6 +35,8 @@ public:
 	SHV_FIELD_IMPL(shv::chainpack::IRpcConnection::LoginType, l, L, oginType)
 	SHV_FIELD_IMPL2(shv::chainpack::RpcValue, c, C, onnectionOptions, shv::chainpack::RpcValue::Map())
 	SHV_FIELD_IMPL2(int, h, H, eartBeatInterval, 60)
+	/// offer frame compression to broker during login
+	SHV_FIELD_BOOL_IMPL2(f, F, rameCompressionEnabled, false)
 
 public:
 	explicit ClientConnection(QObject *parent = nullptr);
@@ -109,6 +113,8 @@ private:
 	bool isAutoConnect() const;
 	void restartIfAutoConnect();
 	const std::string& pingShvPath() const;
+	void muteResponseInLog(int64_t request_id);
+	bool takeResponseMutedInLog(int64_t request_id);
 
 	static void tst_connectionUrlFromString();
 private:
@@ -121,7 +127,10 @@ private:
 		std::string methodPattern;
 	};
 	std::vector<MutedPath> m_mutedShvPathsInLog;
-	std::vector<std::tuple<int64_t, QElapsedTimer>> m_responseIdsMutedInLog;
+	/// request id -> msec of m_mutedInLogClock when request was sent
+	std::unordered_map<int64_t, qint64> m_responseIdsMutedInLog;
+	QElapsedTimer m_mutedInLogClock;
+	qint64 m_mutedInLogPrunedMsec = 0;
 	bool m_rawRpcMessageLog = false;
 };
 
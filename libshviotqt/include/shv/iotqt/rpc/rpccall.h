@@ -12,6 +12,8 @@
 #include <QPointer>
 
 #include <functional>
+#include <unordered_map>
+#include <vector>
 
 class QTimer;
 
@@ -92,6 +94,61 @@ private:
 	int m_requestId = 0;
 };
 
+/// Sends many requests at once without waiting for responses and matches the responses
+/// with single message handler and single timeout timer instead of callback object per request.
+/// Requests are ordinary RPC requests, so broker routes each of them and checks its ACL.
+class SHVIOTQT_DECL_EXPORT RpcCallBatch : public QObject
+{
+	Q_OBJECT
+public:
+	static RpcCallBatch* create(::shv::iotqt::rpc::ClientConnection *connection);
+
+	/// returns index of call in batch
+	int addCall(const std::string &shv_path, const std::string &method, const ::shv::chainpack::RpcValue &params = {}, const ::shv::chainpack::RpcValue &user_id = {});
+	/// batch times out when no response arrives for timeout msec
+	RpcCallBatch* setTimeout(int timeout);
+
+	int callCount() const;
+	const ::shv::chainpack::RpcValue& result(int index) const;
+	const ::shv::chainpack::RpcError& error(int index) const;
+
+	/// sends all requests, repeated calls are ignored
+	void start();
+	void abort();
+
+	/// emitted for every call as its response arrives
+	Q_SIGNAL void itemFinished(int index, const ::shv::chainpack::RpcValue &result, const ::shv::chainpack::RpcError &error);
+	/// emitted when all calls are finished, results can be read by result() and error(), batch is deleted later
+	Q_SIGNAL void finished();
+private:
+	RpcCallBatch(::shv::iotqt::rpc::ClientConnection *connection);
+
+	void onRpcMessageReceived(const ::shv::chainpack::RpcMessage &msg);
+	void onResponseMetaReceived(int request_id);
+	void setItemResult(int index, const ::shv::chainpack::RpcValue &result, const ::shv::chainpack::RpcError &error);
+	/// finishes all pending calls with error
+	void finishPending(const ::shv::chainpack::RpcError &error);
+private:
+	struct Call
+	{
+		std::string shvPath;
+		std::string method;
+		shv::chainpack::RpcValue params;
+		shv::chainpack::RpcValue userId;
+		shv::chainpack::RpcValue result;
+		shv::chainpack::RpcError error;
+		bool isFinished = false;
+	};
+	QPointer<::shv::iotqt::rpc::ClientConnection> m_rpcConnection;
+	std::vector<Call> m_calls;
+	/// request id -> index of call waiting for response
+	std::unordered_map<int, int> m_pendingCalls;
+	QTimer *m_timeoutTimer = nullptr;
+	int m_timeout = 0;
+	bool m_isStarted = false;
+	bool m_isFinished = false;
+};
+
 } // namespace iotqt::rpc
 
 } // namespace shv
@@ -53,6 +53,8 @@ protected:
 
 	virtual void processLoginPhase();
 	virtual void setLoginResult(const shv::chainpack::UserLoginResult &result);
+	/// returns first compression from client login options supported by this build
+	chainpack::RpcFrame::Compression selectFrameCompression() const;
 
 protected:
 	std::string m_connectionName;
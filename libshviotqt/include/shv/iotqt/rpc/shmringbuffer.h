@@ -0,0 +1,58 @@
+#pragma once
+
+#include <shv/iotqt/shviotqtglobal.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace shv::iotqt::rpc {
+
+/// Single producer, single consumer byte queue placed in memory shared by two processes.
+/// Buffer does not block, producer and consumer use waiting flags to find out
+/// when the other side has to be woken up.
+/// Shared header is not trusted, capacity is cached on attach and functions accessing
+/// the data throw when head and tail indices are inconsistent.
+class SHVIOTQT_DECL_EXPORT ShmRingBuffer
+{
+public:
+	/// size of memory needed to place buffer of capacity bytes, capacity must be power of 2
+	static size_t requiredMemorySize(size_t capacity);
+	/// initializes empty buffer in memory of requiredMemorySize(capacity) bytes
+	static ShmRingBuffer create(void *memory, size_t capacity);
+	/// attaches buffer created by other process, throws if memory does not contain valid buffer
+	static ShmRingBuffer attach(void *memory, size_t memory_size);
+
+	ShmRingBuffer() = default;
+
+	bool isValid() const { return m_header != nullptr; }
+	size_t capacity() const;
+	size_t readableSize() const;
+	size_t writableSize() const;
+
+	/// writes as much of data as fits, returns number of bytes written
+	size_t write(std::string_view data);
+	/// reads at most size bytes to dest, returns number of bytes read
+	size_t read(char *dest, size_t size);
+
+	/// consumer announces that it is going to sleep,
+	/// returns false if data arrived meanwhile and consumer should continue reading
+	bool setReaderWaiting();
+	/// returns true if consumer is sleeping and producer has to wake it up, clears the flag
+	bool takeReaderWaiting();
+	/// producer announces that it is going to sleep until at least required_size bytes is free,
+	/// returns false if space is available already
+	bool setWriterWaiting(size_t required_size = 1);
+	/// returns true if producer is sleeping and consumer has to wake it up, clears the flag
+	bool takeWriterWaiting();
+private:
+	struct Header;
+	ShmRingBuffer(Header *header, uint32_t capacity);
+	uint32_t usedSize(uint32_t head, uint32_t tail) const;
+private:
+	Header *m_header = nullptr;
+	char *m_data = nullptr;
+	uint32_t m_capacity = 0;
+};
+
+} // namespace shv::iotqt::rpc
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <shv/iotqt/rpc/socket.h>
+#include <shv/iotqt/rpc/shmringbuffer.h>
+
+#include <optional>
+
+class QLocalSocket;
+
+namespace shv::iotqt::rpc {
+
+/// Frames are passed whole, RPC meta is parsed once per frame
+class SHVIOTQT_DECL_EXPORT ShmFrameReader : public FrameReader
+{
+public:
+	QList<int> addData(std::string_view frame_data) override;
+	std::optional<int> addFrame(const std::string &frame_data);
+};
+
+class SHVIOTQT_DECL_EXPORT ShmFrameWriter : public FrameWriter
+{
+public:
+	/// throws when frame is longer than ShmSocket::MAX_FRAME_SIZE
+	void addFrame(const std::string &frame_data) override;
+	bool hasPendingData() const { return !m_messageDataToWrite.isEmpty(); }
+	/// bytes needed in ring to make progress, frame length is never split
+	size_t requiredSpace() const;
+	size_t flushToRing(ShmRingBuffer &ring);
+private:
+	qsizetype m_writtenSize = 0;
+};
+
+/// Same host transport, frames are passed through pair of shared memory ring buffers.
+/// Local socket is used to exchange shared memory segment name, to wake up sleeping peer
+/// and to detect that peer has gone. Client creates the segment, server unlinks it
+/// after attaching, so it disappears when both peers unmap it.
+/// Segment is created with owner only permissions, client and server must run as the same user,
+/// server refuses segments of peer with different uid.
+/// Shared memory is writable by the peer, connection is dropped when it contains
+/// inconsistent ring indices or frame longer than MAX_FRAME_SIZE.
+class SHVIOTQT_DECL_EXPORT ShmSocket : public Socket
+{
+	Q_OBJECT
+
+	using Super = Socket;
+public:
+	enum class Role {Client, Server};
+	static constexpr size_t DEFAULT_RING_CAPACITY = 1 << 20;
+	static constexpr size_t MAX_FRAME_SIZE = 64 * 1024 * 1024;
+
+	ShmSocket(QLocalSocket *socket, Role role, QObject *parent = nullptr);
+	~ShmSocket() override;
+
+	void connectToHost(const QUrl &url) override;
+	void close() override;
+	void abort() override;
+
+	QAbstractSocket::SocketState state() const override;
+	QString errorString() const override;
+	QHostAddress peerAddress() const override;
+	quint16 peerPort() const override;
+	void ignoreSslErrors() override;
+protected:
+	void flushWriteBuffer() override;
+private:
+	void onControlSocketConnected();
+	void onControlSocketReadyRead();
+	void createSegment();
+	void attachSegment(const std::string &segment_name);
+	void releaseSegment();
+	void readFrames();
+	void wakeUpPeer();
+	void setSegmentError(const QString &error_string);
+private:
+	QLocalSocket *m_socket = nullptr;
+	Role m_role;
+	QString m_errorString;
+	std::string m_segmentName;
+	void *m_segment = nullptr;
+	size_t m_segmentSize = 0;
+	ShmRingBuffer m_rxRing;
+	ShmRingBuffer m_txRing;
+	/// server receives segment name terminated by '\n'
+	std::string m_handshakeData;
+	std::string m_rxFrame;
+	size_t m_rxFrameReadSize = 0;
+	bool m_rxFrameStarted = false;
+};
+
+} // namespace shv::iotqt::rpc
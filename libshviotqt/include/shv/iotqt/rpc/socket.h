@@ -80,7 +80,7 @@ class SHVIOTQT_DECL_EXPORT Socket : public QObject
 {
 	Q_OBJECT
 public:
-	enum class Scheme { Tcp = 0, Ssl, WebSocket, WebSocketSecure, SerialPort, LocalSocket, LocalSocketSerial };
+	enum class Scheme { Tcp = 0, Ssl, WebSocket, WebSocketSecure, SerialPort, LocalSocket, LocalSocketSerial, SharedMemory };
 public:
 	explicit Socket(QObject *parent = nullptr);
 	~Socket() override;
@@ -0,0 +1,143 @@
+#include <shv/iotqt/node/asyncmethodrunner.h>
+
+#include <shv/coreqt/log.h>
+#include <shv/core/utils/shvfilejournal.h>
+
+#include <QTimer>
+
+namespace cp = shv::chainpack;
+
+namespace shv::iotqt::node {
+
+struct AsyncMethodRunner::PendingCall
+{
+	cp::RpcRequest request;
+	std::atomic<bool> cancelled = false;
+	QTimer *timer = nullptr;
+};
+
+AsyncMethodRunner::AsyncMethodRunner(QObject *parent)
+	: QObject(parent)
+{
+}
+
+AsyncMethodRunner::~AsyncMethodRunner()
+{
+	cancelAll();
+	// finished calls post responses to this object, they are discarded when it is deleted
+	m_threadPool.waitForDone();
+}
+
+void AsyncMethodRunner::setMaxThreadCount(int n)
+{
+	m_threadPool.setMaxThreadCount(n);
+}
+
+void AsyncMethodRunner::setTimeout(std::chrono::milliseconds timeout)
+{
+	m_timeout = timeout;
+}
+
+void AsyncMethodRunner::run(const chainpack::RpcRequest &rq, Method method)
+{
+	auto call_id = ++m_lastCallId;
+	auto call = std::make_shared<PendingCall>();
+	call->request = rq;
+	if(m_timeout.count() > 0) {
+		call->timer = new QTimer(this);
+		call->timer->setSingleShot(true);
+		connect(call->timer, &QTimer::timeout, this, [this, call_id]() { onCallTimeout(call_id); });
+		call->timer->start(m_timeout);
+	}
+	m_pendingCalls[call_id] = call;
+	m_threadPool.start([this, call_id, call, method = std::move(method)]() {
+		if(call->cancelled)
+			return;
+		auto resp = call->request.makeResponse();
+		try {
+			resp.setResult(method(call->cancelled));
+		}
+		catch (const cp::RpcException &e) {
+			resp.setError(cp::RpcResponse::Error(e.message(), e.errorCode(), e.data()));
+		}
+		catch (const cp::Exception &e) {
+			resp.setError(cp::RpcResponse::Error(e.message(), cp::RpcResponse::Error::MethodCallException, e.data()));
+		}
+		catch (const std::exception &e) {
+			resp.setError(cp::RpcResponse::Error(e.what(), cp::RpcResponse::Error::MethodCallException));
+		}
+		if(call->cancelled)
+			return;
+		QMetaObject::invokeMethod(this, [this, call_id, resp]() { onCallFinished(call_id, resp); }, Qt::QueuedConnection);
+	});
+}
+
+void AsyncMethodRunner::runGetLog(const chainpack::RpcRequest &rq, core::utils::ShvFileJournal &journal)
+{
+	core::utils::ShvFileJournal::AsyncGetLog get_log;
+	try {
+		get_log = journal.asyncGetLog(core::utils::ShvGetLogParams(rq.params()));
+	}
+	catch (const std::exception &e) {
+		// journal dir cannot be read, there is nothing to run
+		auto resp = rq.makeResponse();
+		resp.setError(cp::RpcResponse::Error(e.what(), cp::RpcResponse::Error::MethodCallException));
+		emit responseReady(resp);
+		return;
+	}
+	run(rq, std::move(get_log));
+}
+
+void AsyncMethodRunner::cancelCaller(int caller_id)
+{
+	for(auto it = m_pendingCalls.begin(); it != m_pendingCalls.end(); ) {
+		const auto &call = it->second;
+		if(call->request.peekCallerId() == caller_id) {
+			shvDebug() << "Cancelling method:" << call->request.method().asString() << "of disconnected caller:" << caller_id;
+			call->cancelled = true;
+			delete call->timer;
+			it = m_pendingCalls.erase(it);
+		}
+		else {
+			++it;
+		}
+	}
+}
+
+void AsyncMethodRunner::cancelAll()
+{
+	for(const auto &[call_id, call] : m_pendingCalls) {
+		call->cancelled = true;
+		delete call->timer;
+	}
+	m_pendingCalls.clear();
+}
+
+void AsyncMethodRunner::onCallFinished(int call_id, const chainpack::RpcResponse &resp)
+{
+	auto it = m_pendingCalls.find(call_id);
+	if(it == m_pendingCalls.end()) {
+		// cancelled or timed out meanwhile
+		return;
+	}
+	delete it->second->timer;
+	m_pendingCalls.erase(it);
+	emit responseReady(resp);
+}
+
+void AsyncMethodRunner::onCallTimeout(int call_id)
+{
+	auto it = m_pendingCalls.find(call_id);
+	if(it == m_pendingCalls.end())
+		return;
+	auto call = it->second;
+	m_pendingCalls.erase(it);
+	call->cancelled = true;
+	call->timer->deleteLater();
+	shvWarning() << "Method:" << call->request.method().asString() << "on path:" << call->request.shvPath().asString() << "timed out";
+	auto resp = call->request.makeResponse();
+	resp.setError(cp::RpcResponse::Error::create(cp::RpcResponse::Error::MethodCallTimeout, "Method call timeout"));
+	emit responseReady(resp);
+}
+
+}
@@ -24,22 +24,30 @@ const auto M_READ_COMPRESSED = "readCompressed";
 const std::vector<shv::chainpack::MetaMethod> FileNode::meta_methods_file_base = {
 	shv::chainpack::methods::DIR,
 	shv::chainpack::methods::LS,
-	{M_HASH, cp::MetaMethod::Flag::None, "Map", "String", cp::AccessLevel::Read},
+	{M_HASH, cp::MetaMethod::Flag::None, "Map", "String", cp::AccessLevel::Read, {}
+	 , "Parameters\n"
+	   "  offset: file offset to start hashing, default is 0\n"
+	   "  size: number of bytes to hash starting on offset, default is till end of file\n"
+	},
 	{M_SIZE, cp::MetaMethod::Flag::LargeResultHint, "", "UInt", cp::AccessLevel::Browse},
 	{M_SIZE_COMPRESSED, cp::MetaMethod::Flag::None, "Map", "UInt", cp::AccessLevel::Browse , {}
 	 , "Parameters\n"
 	   "  read() parameters\n"
-	   "  compressionType: gzip (default) | qcompress"
+	   "  compressionType: gzip (default) | qcompress\n"
+	   "  without size, it is sum of readCompressed() results when the rest of file is read in 16MB chunks"
 	},
 	{M_READ, cp::MetaMethod::Flag::LargeResultHint, "Map", "Blob", cp::AccessLevel::Read, {}
 	 , "Parameters\n"
 	 "  offset: file offset to start read, default is 0\n"
 	 "  size: number of bytes to read starting on offset, default is till end of file\n"
+	 "  at most 16MB is returned when size is set, result meta contains real size of the chunk\n"
+	 "  without size, error is returned when rest of file is bigger than 16MB\n"
 	},
 	{M_READ_COMPRESSED, cp::MetaMethod::Flag::None, "Map", "Blob", cp::AccessLevel::Read, {}
 	 , "Parameters\n"
 	   "  read() parameters\n"
-	   "  compressionType: gzip (default) | qcompress"
+	   "  compressionType: gzip (default) | qcompress\n"
+	   "  gzip chunks of bigger file can be concatenated"
 	},
 };
 
@@ -61,6 +69,25 @@ CompressionType compression_type_from_string(const std::string &type_str, Compre
 
 	return CompressionType::Invalid;
 }
+
+CompressionType compression_type_param(const cp::RpcValue &params)
+{
+	const auto compression_type_str = params.asMap().value("compressionType").toString();
+	const auto compression_type = compression_type_from_string(compression_type_str, CompressionType::GZip);
+	if (compression_type == CompressionType::Invalid) {
+		SHV_EXCEPTION("Invalid compression type: " + compression_type_str);
+	}
+	return compression_type;
+}
+
+cp::RpcValue::Blob compress(const cp::RpcValue::Blob &blob, CompressionType compression_type)
+{
+	if (compression_type == CompressionType::QCompress) {
+		const auto compressed_blob = qCompress(blob.data(), static_cast<int>(blob.size()));
+		return cp::RpcValue::Blob(compressed_blob.cbegin(), compressed_blob.cend());
+	}
+	return shv::coreqt::Utils::compressGZip(blob);
+}
 }
 
 FileNode::FileNode(const std::string &node_id, shv::iotqt::node::FileNode::Super *parent)
@@ -77,20 +104,13 @@ cp::RpcValue FileNode::callMethod(const shv::iotqt::node::ShvNode::StringViewLis
 		return readFileCompressed(shv_path, params);
 	}
 	if(method == M_HASH) {
-		shv::chainpack::RpcValue::Blob bytes = read(shv_path, params).asBlob();
-		QCryptographicHash h(QCryptographicHash::Sha1);
-#if QT_VERSION_MAJOR >= 6 && QT_VERSION_MINOR >= 3
-		h.addData(QByteArrayView(reinterpret_cast<const char*>(bytes.data()), static_cast<int>(bytes.size())));
-#else
-		h.addData(reinterpret_cast<const char*>(bytes.data()), static_cast<int>(bytes.size()));
-#endif
-		return h.result().toHex().toStdString();
+		return hash(shv_path, params);
 	}
 	if(method == M_SIZE) {
 		return size(shv_path);
 	}
 	if(method == M_SIZE_COMPRESSED) {
-		return static_cast<unsigned>(readFileCompressed(shv_path, params).asBlob().size());
+		return sizeCompressed(shv_path, params);
 	}
 
 	return Super::callMethod(shv_path, method, params, user_id);
@@ -120,21 +140,35 @@ std::string FileNode::fileName(const ShvNode::StringViewList &shv_path) const
 
 chainpack::RpcValue FileNode::size(const StringViewList &shv_path) const
 {
-#if defined __GNUC__ && !defined(__clang__)
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wuseless-cast"
-#endif
-	return static_cast<uint64_t>(readContent(shv_path, 0, std::numeric_limits<int64_t>::max()).asBlob().size());
-#if defined __GNUC__ && !defined(__clang__)
-#pragma GCC diagnostic pop
-#endif
+	uint64_t file_size = 0;
+	while(true) {
+		const cp::RpcValue chunk = readContent(shv_path, static_cast<int64_t>(file_size), READ_CHUNK_SIZE);
+		const auto chunk_size = chunk.asBlob().size();
+		file_size += chunk_size;
+		if(chunk_size < static_cast<size_t>(READ_CHUNK_SIZE))
+			break;
+	}
+	return file_size;
+}
+
+chainpack::RpcValue FileNode::readRange(const ShvNode::StringViewList &shv_path, const chainpack::RpcValue &params) const
+{
+	const auto &m = params.asMap();
+	int64_t offset = m.value("offset").toInt64();
+	if(m.hasKey("size"))
+		return readContent(shv_path, offset, std::min(m.value("size").toInt64(), MAX_READ_SIZE));
+	// caller wants the rest of file, it is never truncated silently
+	cp::RpcValue content = readContent(shv_path, offset, MAX_READ_SIZE + 1);
+	if(content.asBlob().size() > static_cast<size_t>(MAX_READ_SIZE))
+		SHV_EXCEPTION("File: " + fileName(shv_path) + " is bigger than " + std::to_string(MAX_READ_SIZE)
+					  + " bytes, it must be read in chunks using offset and size parameters");
+	return content;
 }
 
 chainpack::RpcValue FileNode::read(const ShvNode::StringViewList &shv_path, const chainpack::RpcValue &params) const
 {
 	int64_t offset = params.asMap().value("offset").toInt64();
-	int64_t size = params.asMap().value("size", std::numeric_limits<int64_t>::max()).toInt64();
-	cp::RpcValue ret_value = readContent(shv_path, offset, size);
+	cp::RpcValue ret_value = readRange(shv_path, params);
 	ret_value.setMetaValue("fileName", fileName(shv_path));
 	ret_value.setMetaValue("offset", offset);
 #if defined __GNUC__ && !defined(__clang__)
@@ -148,27 +182,40 @@ chainpack::RpcValue FileNode::read(const ShvNode::StringViewList &shv_path, cons
 	return ret_value;
 }
 
-chainpack::RpcValue FileNode::readFileCompressed(const ShvNode::StringViewList &shv_path, const chainpack::RpcValue &params) const
+chainpack::RpcValue FileNode::hash(const ShvNode::StringViewList &shv_path, const chainpack::RpcValue &params) const
 {
-	const auto compression_type_str = params.asMap().value("compressionType").toString();
-	const auto compression_type = compression_type_from_string(compression_type_str, CompressionType::GZip);
-	if (compression_type == CompressionType::Invalid) {
-		SHV_EXCEPTION("Invalid compression type: " + compression_type_str);
+	int64_t offset = params.asMap().value("offset").toInt64();
+	int64_t size = params.asMap().value("size", std::numeric_limits<int64_t>::max()).toInt64();
+	QCryptographicHash h(QCryptographicHash::Sha1);
+	while(size > 0) {
+		const int64_t chunk_size = std::min(size, READ_CHUNK_SIZE);
+		const cp::RpcValue chunk = readContent(shv_path, offset, chunk_size);
+		const cp::RpcValue::Blob &bytes = chunk.asBlob();
+#if QT_VERSION_MAJOR >= 6 && QT_VERSION_MINOR >= 3
+		h.addData(QByteArrayView(reinterpret_cast<const char*>(bytes.data()), static_cast<qsizetype>(bytes.size())));
+#else
+		h.addData(reinterpret_cast<const char*>(bytes.data()), static_cast<int>(bytes.size()));
+#endif
+		const auto read_size = static_cast<int64_t>(bytes.size());
+		if(read_size < chunk_size)
+			break;
+		offset += read_size;
+		size -= read_size;
 	}
+	return h.result().toHex().toStdString();
+}
 
-	cp::RpcValue result;
+chainpack::RpcValue FileNode::readFileCompressed(const ShvNode::StringViewList &shv_path, const chainpack::RpcValue &params) const
+{
+	const auto compression_type = compression_type_param(params);
 	int64_t offset = params.asMap().value("offset").toInt64();
-	int64_t size = params.asMap().value("size", std::numeric_limits<int64_t>::max()).toInt64();
-	const cp::RpcValue::Blob blob = readContent(shv_path, offset, size).asBlob();
+	const cp::RpcValue content = readRange(shv_path, params);
+	cp::RpcValue result = compress(content.asBlob(), compression_type);
 	if (compression_type == CompressionType::QCompress) {
-		const auto compressed_blob = qCompress(blob.data(), static_cast<int>(blob.size()));
-		result = shv::chainpack::RpcValue::Blob(compressed_blob.cbegin(), compressed_blob.cend());
-
 		result.setMetaValue("compressionType", "qcompress");
 		result.setMetaValue("fileName", fileName(shv_path) + ".qcompress");
 	}
 	else if (compression_type == CompressionType::GZip) {
-		result = shv::coreqt::Utils::compressGZip(blob);
 		result.setMetaValue("compressionType", "gzip");
 		result.setMetaValue("fileName", fileName(shv_path) + ".gz");
 	}
@@ -185,4 +232,26 @@ chainpack::RpcValue FileNode::readFileCompressed(const ShvNode::StringViewList &
 	return result;
 }
 
+chainpack::RpcValue FileNode::sizeCompressed(const ShvNode::StringViewList &shv_path, const chainpack::RpcValue &params) const
+{
+	const auto compression_type = compression_type_param(params);
+	const auto &m = params.asMap();
+	int64_t offset = m.value("offset").toInt64();
+	if(m.hasKey("size")) {
+		const cp::RpcValue content = readContent(shv_path, offset, std::min(m.value("size").toInt64(), MAX_READ_SIZE));
+		return static_cast<uint64_t>(compress(content.asBlob(), compression_type).size());
+	}
+	// whole rest of file, compressed in the same chunks as client has to read it, so that memory use is bounded
+	uint64_t ret = 0;
+	while(true) {
+		const cp::RpcValue chunk = readContent(shv_path, offset, MAX_READ_SIZE);
+		const auto chunk_size = chunk.asBlob().size();
+		ret += compress(chunk.asBlob(), compression_type).size();
+		if(chunk_size < static_cast<size_t>(MAX_READ_SIZE))
+			break;
+		offset += static_cast<int64_t>(chunk_size);
+	}
+	return ret;
+}
+
 }
@@ -181,7 +181,7 @@ QFileInfo LocalFSNode::ndFileInfo(const QString &path) const
 
 RpcValue LocalFSNode::ndSize(const QString &path) const
 {
-	return static_cast<unsigned>(ndFileInfo(path).size());
+	return static_cast<uint64_t>(ndFileInfo(path).size());
 }
 
 chainpack::RpcValue LocalFSNode::ndRead(const QString &path, qint64 offset, qint64 size) const
@@ -15,6 +15,7 @@
 #include <shv/core/utils.h>
 #include <shv/core/utils/shvpath.h>
 
+#include <QChildEvent>
 #include <QTimer>
 #include <QFile>
 #include <cstring>
@@ -36,6 +37,9 @@ ShvNode::ShvNode(ShvNode *parent)
 	: QObject(parent)
 {
 	shvDebug() << __FUNCTION__ << this;
+	// QChildEvent is not delivered without QCoreApplication instance, parent index is invalidated explicitly
+	if(parent)
+		parent->invalidateChildIndex();
 }
 
 ShvNode::ShvNode(const std::string &node_id, ShvNode *parent)
@@ -44,7 +48,12 @@ ShvNode::ShvNode(const std::string &node_id, ShvNode *parent)
 	setNodeId(node_id);
 }
 
-ShvNode::~ShvNode() = default;
+ShvNode::~ShvNode()
+{
+	// parent being destroyed is not ShvNode anymore here, its index does not matter then
+	if(auto *parent_nd = parentNode())
+		parent_nd->invalidateChildIndex();
+}
 
 ShvNode *ShvNode::parentNode() const
 {
@@ -53,15 +62,64 @@ ShvNode *ShvNode::parentNode() const
 
 ShvNode *ShvNode::childNode(const ShvNode::String &name, bool throw_exc) const
 {
-	auto *nd = findChild<ShvNode*>(QString::fromStdString(name), Qt::FindDirectChildrenOnly);
+	ShvNode *nd = findChildNode(name);
 	if(throw_exc && !nd)
 		SHV_EXCEPTION("Child node id: " + name + " doesn't exist, parent node: " + shvPath().asString());
 	return nd;
 }
 
+ShvNode *ShvNode::findChildNode(StringView node_id) const
+{
+	updateChildIndex();
+	if(auto it = m_childIndex.find(node_id); it != m_childIndex.end())
+		return it->second;
+	return nullptr;
+}
+
+void ShvNode::childEvent(QChildEvent *event)
+{
+	// ShvNode constructor, destructor and setParentNode() invalidate the index explicitly,
+	// this catches QObject::setParent() calls when QCoreApplication exists.
+	// ChildAdded is sent from QObject constructor of the child, before it is fully constructed,
+	// so the index is just invalidated here and rebuilt on next lookup
+	if(event->added() || event->removed())
+		invalidateChildIndex();
+	QObject::childEvent(event);
+}
+
+void ShvNode::invalidateChildIndex()
+{
+	m_isChildIndexValid = false;
+	m_childIndex.clear();
+	m_childNamesCache.reset();
+	m_lsCache = {};
+}
+
+void ShvNode::invalidateDirCache()
+{
+	m_dirCache = {};
+}
+
+void ShvNode::updateChildIndex() const
+{
+	if(m_isChildIndexValid)
+		return;
+	for(QObject *o : children()) {
+		if(auto *nd = qobject_cast<ShvNode*>(o)) {
+			// first child with the same name wins, the same as QObject::findChild() does
+			m_childIndex.try_emplace(nd->nodeId(), nd);
+		}
+	}
+	m_isChildIndexValid = true;
+}
+
 void ShvNode::setParentNode(ShvNode *parent)
 {
+	if(auto *old_parent_nd = parentNode())
+		old_parent_nd->invalidateChildIndex();
 	setParent(parent);
+	if(parent)
+		parent->invalidateChildIndex();
 }
 
 ShvNode::String ShvNode::nodeId() const
@@ -74,6 +132,8 @@ void ShvNode::setNodeId(ShvNode::String &&n)
 	setObjectName(QString::fromStdString(n));
 	shvDebug() << __FUNCTION__ << this << n;
 	m_nodeId = std::move(n);
+	if(auto *parent_nd = parentNode())
+		parent_nd->invalidateChildIndex();
 }
 
 void ShvNode::setNodeId(const ShvNode::String &n)
@@ -81,6 +141,8 @@ void ShvNode::setNodeId(const ShvNode::String &n)
 	setObjectName(QString::fromStdString(n));
 	shvDebug() << __FUNCTION__ << this << n;
 	m_nodeId = n;
+	if(auto *parent_nd = parentNode())
+		parent_nd->invalidateChildIndex();
 }
 
 shv::core::utils::ShvPath ShvNode::shvPath() const
@@ -104,6 +166,15 @@ shv::core::utils::ShvPath ShvNode::shvPath() const
 void ShvNode::setSortedChildren(bool b)
 {
 	m_isSortedChildren = b;
+	m_childNamesCache.reset();
+	m_lsCache = {};
+}
+
+void ShvNode::setDirLsCacheEnabled(bool b)
+{
+	m_isDirLsCacheEnabled = b;
+	m_dirCache = {};
+	m_lsCache = {};
 }
 
 void ShvNode::deleteIfEmptyWithParents()
@@ -129,28 +200,50 @@ void ShvNode::handleRpcFrame(RpcFrame &&frame)
 {
 	shvLogFuncFrame() << "node:" << nodeId() << "meta:" << frame.meta.toPrettyString();
 	using ShvPath = shv::core::utils::ShvPath;
-	using namespace std;
-	using namespace shv::core::utils;
-	const chainpack::RpcValue::String method = RpcMessage::method(frame.meta).toString();
-	const chainpack::RpcValue::String shv_path_str = RpcMessage::shvPath(frame.meta).toString();
-	auto shv_path = RpcMessage::shvPath(frame.meta).asString();
-	core::StringViewList shv_path_list = ShvPath::split(shv_path);
+	// path and method values are shared with frame meta, routing is done on views into them
+	const chainpack::RpcValue shv_path_value = RpcMessage::shvPath(frame.meta);
+	const chainpack::RpcValue method_value = RpcMessage::method(frame.meta);
+	const chainpack::RpcValue::String &method = method_value.asString();
+	const chainpack::RpcValue::String &shv_path_str = shv_path_value.asString();
+	auto skip_delims = [](StringView &path) {
+		while(!path.empty() && path[0] == ShvPath::SHV_PATH_DELIM)
+			path.remove_prefix(1);
+	};
+	StringView shv_path = shv_path_str;
+	skip_delims(shv_path);
+	ShvNode *nd = this;
+	while(!shv_path.empty()) {
+		// node which may override childNode() or handleRpcFrame() must get the frame itself
+		if(nd != this && !nd->isFastRouting())
+			break;
+		size_t next_dir_pos;
+		StringView dir = ShvPath::firstDir(shv_path, &next_dir_pos);
+		ShvNode *child_nd = nd->routingChildNode(dir);
+		if(!child_nd)
+			break;
+		shvDebug() << "Child node:" << dir << "on path:" << shv_path_str << "FOUND";
+		nd = child_nd;
+		shv_path.remove_prefix(next_dir_pos);
+		skip_delims(shv_path);
+	}
+	if(nd != this) {
+		RpcMessage::setShvPath(frame.meta, RpcValue::String{shv_path});
+		nd->handleRpcFrame(std::move(frame));
+		return;
+	}
 	const bool ls_hook = frame.meta.hasKey(ADD_LOCAL_TO_LS_RESULT_HACK_META_KEY);
 	RpcResponse resp = RpcResponse::forRequest(frame.meta);
 	try {
-		if(!shv_path_list.empty()) {
-			ShvNode *nd = childNode(std::string{shv_path_list.at(0)}, !shv::core::Exception::Throw);
-			if(nd) {
-				shvDebug() << "Child node:" << shv_path_list.at(0) << "on path:" << shv_path_list.join('/') << "FOUND";
-				ShvPath new_path = ShvPath::joinDirs(++shv_path_list.begin(), shv_path_list.end());
-				RpcMessage::setShvPath(frame.meta, new_path.asString());
-				nd->handleRpcFrame(std::move(frame));
-				return;
-			}
-		}
+		core::StringViewList shv_path_list = ShvPath::split(shv_path);
 		const chainpack::MetaMethod *mm = metaMethod(shv_path_list, method);
 		if(mm) {
-			shvDebug() << "Metamethod:" << method << "on path:" << ShvPath::joinDirs(shv_path_list).asString() << "FOUND";
+			shvDebug() << "Metamethod:" << method << "on path:" << shv_path_str << "FOUND";
+			// reject request before the params are decoded
+			auto rq_grant = RpcMessage::accessGrant(frame.meta);
+			if(mm->accessLevel() > rq_grant.accessLevel)
+				SHV_EXCEPTION(std::string("Call method: '") + method + "' on path '" + shvPath().asString() + '/' + shv_path_str
+							  + "' permission denied, grant: " + rq_grant.toPrettyString()
+							  + " required: " + accessLevelToAccessString(mm->accessLevel()));
 			std::string errmsg;
 			RpcMessage rpc_msg = frame.toRpcMessage(&errmsg);
 			if(!errmsg.empty())
@@ -197,6 +290,18 @@ void ShvNode::handleRpcFrame(RpcFrame &&frame)
 	}
 }
 
+void ShvNode::setFastRouting(bool b)
+{
+	m_isFastRouting = b;
+}
+
+ShvNode *ShvNode::routingChildNode(StringView node_id) const
+{
+	if(m_isFastRouting)
+		return findChildNode(node_id);
+	return childNode(String{node_id}, !shv::core::Exception::Throw);
+}
+
 void ShvNode::handleRpcRequest(const chainpack::RpcRequest &rq)
 {
 	shvLogFuncFrame() << "node:" << nodeId() << metaObject()->className();
@@ -239,7 +344,7 @@ chainpack::RpcValue ShvNode::handleRpcRequestImpl(const chainpack::RpcRequest &r
 	const chainpack::RpcValue::String shv_path_str = rq.shvPath().asString();
 	core::StringViewList shv_path = ShvPath::split(shv_path_str);
 	if(!shv_path.empty()) {
-		ShvNode *nd = childNode(std::string{shv_path.at(0)}, !shv::core::Exception::Throw);
+		ShvNode *nd = routingChildNode(shv_path.at(0));
 		if(nd) {
 			shvDebug() << "Child node:" << shv_path.at(0) << "on path:" << ShvPath::joinDirs(shv_path).asString() << "FOUND";
 			ShvPath new_path = ShvPath::joinDirs(++shv_path.begin(), shv_path.end());
@@ -311,14 +416,19 @@ ShvNode::StringList ShvNode::childNames(const StringViewList &shv_path)
 	shvLogFuncFrame() << "node:" << nodeId() << "shv_path:" << shv_path.join('/');
 	ShvNode::StringList ret;
 	if(shv_path.empty()) {
-		for (ShvNode *nd : ownChildren()) {
-			ret.push_back(nd->nodeId());
+		if(!m_childNamesCache) {
+			ShvNode::StringList names;
+			for (ShvNode *nd : ownChildren()) {
+				names.push_back(nd->nodeId());
+			}
 			if(m_isSortedChildren)
-				std::sort(ret.begin(), ret.end());
+				std::sort(names.begin(), names.end());
+			m_childNamesCache = std::move(names);
 		}
+		ret = *m_childNamesCache;
 	}
 	else if(shv_path.size() == 1) {
-		ShvNode *nd = childNode(std::string{shv_path.at(0)}, !shv::core::Exception::Throw);
+		ShvNode *nd = routingChildNode(shv_path.at(0));
 		if(nd)
 			ret = nd->childNames(StringViewList());
 	}
@@ -330,7 +440,7 @@ chainpack::RpcValue ShvNode::hasChildren(const StringViewList &shv_path)
 {
 	shvLogFuncFrame() << "node:" << nodeId() << "shv_path:" << shv_path.join('/');
 	if(shv_path.size() == 1) {
-		ShvNode *nd = childNode(std::string{shv_path.at(0)}, !shv::core::Exception::Throw);
+		ShvNode *nd = routingChildNode(shv_path.at(0));
 		if(nd) {
 			return nd->hasChildren(StringViewList());
 		}
@@ -394,20 +504,25 @@ void ShvNode::treeWalk_helper(std::function<void (ShvNode *, const ShvNode::Stri
 chainpack::RpcValue ShvNode::dir(const StringViewList &shv_path, const chainpack::RpcValue &methods_params)
 {
 	auto method_name = methods_params.asString();
-	size_t cnt = methodCount(shv_path);
 	if(method_name.empty()) {
+		const bool use_cache = m_isDirLsCacheEnabled && shv_path.empty();
+		if(use_cache && m_dirCache.isValid())
+			return m_dirCache;
+		size_t cnt = methodCount(shv_path);
 		RpcList ret;
+		ret.reserve(cnt);
 		for (size_t ix = 0; ix < cnt; ++ix) {
 			const chainpack::MetaMethod *mm = metaMethod(shv_path, ix);
 			ret.push_back(mm->toRpcValue());
 		}
-		return RpcValue{ret};
+		// RpcValue is implicitly shared, cached result is not copied
+		RpcValue rv{std::move(ret)};
+		if(use_cache)
+			m_dirCache = rv;
+		return rv;
 	}
-	for (size_t ix = 0; ix < cnt; ++ix) {
-		const chainpack::MetaMethod *mm = metaMethod(shv_path, ix);
-		if(mm->name() == method_name) {
-			return RpcValue{mm->toRpcValue()};
-		}
+	if(const chainpack::MetaMethod *mm = metaMethod(shv_path, method_name)) {
+		return RpcValue{mm->toRpcValue()};
 	}
 	return RpcValue{nullptr};
 }
@@ -415,13 +530,21 @@ chainpack::RpcValue ShvNode::dir(const StringViewList &shv_path, const chainpack
 chainpack::RpcValue ShvNode::ls(const StringViewList &shv_path, const chainpack::RpcValue &methods_params)
 {
 	const std::string &child_name = methods_params.asString();
+	const bool use_cache = m_isDirLsCacheEnabled && shv_path.empty();
 	if(child_name.empty()) {
+		if(use_cache && m_lsCache.isValid())
+			return m_lsCache;
 		RpcList ret;
 		for(const std::string &ch_name : childNames(shv_path)) {
 			ret.push_back(ch_name);
 		}
-		return chainpack::RpcValue{ret};
+		RpcValue rv{std::move(ret)};
+		if(use_cache)
+			m_lsCache = rv;
+		return rv;
 	}
+	if(use_cache)
+		return findChildNode(child_name) != nullptr;
 	for(const std::string &ch_name : childNames(shv_path)) {
 		if(ch_name == child_name)
 			return true;
@@ -451,10 +574,21 @@ const chainpack::MetaMethod *ShvNode::metaMethod(const StringViewList &shv_path,
 const chainpack::MetaMethod *ShvNode::metaMethod(const ShvNode::StringViewList &shv_path, const std::string &name)
 {
 	size_t cnt = methodCount(shv_path);
+	if(shv_path.empty()) {
+		// method tables can be dynamic, so cached index is used only if it still points to the same method name
+		if(auto it = m_methodIndexCache.find(name); it != m_methodIndexCache.end() && it->second < cnt) {
+			const chainpack::MetaMethod *mm = metaMethod(shv_path, it->second);
+			if(mm && name == mm->name())
+				return mm;
+		}
+	}
 	for (size_t i = 0; i < cnt; ++i) {
 		const chainpack::MetaMethod *mm = metaMethod(shv_path, i);
-		if(mm && name == mm->name())
+		if(mm && name == mm->name()) {
+			if(shv_path.empty())
+				m_methodIndexCache[name] = i;
 			return mm;
+		}
 	}
 	return nullptr;
 }
@@ -573,6 +707,15 @@ const shv::chainpack::MetaMethod *MethodsTableNode::metaMethod(const shv::iotqt:
 	return Super::metaMethod(shv_path, ix);
 }
 
+shv::chainpack::RpcValue MethodsTableNode::dir(const StringViewList &shv_path, const shv::chainpack::RpcValue &methods_params)
+{
+	if(m_dirCacheMethods != m_methods) {
+		m_dirCacheMethods = m_methods;
+		invalidateDirCache();
+	}
+	return Super::dir(shv_path, methods_params);
+}
+
 
 //===========================================================
 // RpcValueMapNode
@@ -78,6 +78,9 @@ ShvNode *ShvNodeTree::mdcd(const ShvNode::StringViewList &path, bool create_dirs
 			if(create_dirs) {
 				ret = new ShvNode(ret);
 				ret->setNodeId(std::string{path[ix]});
+				// plain directory node, its methods and children change only through ShvNode API
+				ret->setDirLsCacheEnabled(true);
+				ret->setFastRouting(true);
 			}
 			else {
 				break;
@@ -19,6 +19,7 @@ ClientAppCliOptions::ClientAppCliOptions()
 	addOption("rpc.rpcTimeout").setType(cp::RpcValue::Type::Int).setNames("--rto", "--rpc-time-out").setComment("Set default RPC calls timeout [sec].").setDefaultValue(shv::chainpack::RpcDriver::defaultRpcTimeoutMsec() / 1000);
 	addOption("rpc.reconnectInterval").setType(cp::RpcValue::Type::Int).setNames("--rci", "--rpc-reconnect-interval").setComment("Reconnect to broker if connection lost at least after reconnect-interval seconds. Disabled when set to 0").setDefaultValue(10);
 	addOption("rpc.heartbeatInterval").setType(cp::RpcValue::Type::Int).setNames("--hbi", "--rpc-heartbeat-interval").setComment("Send heart beat to broker every n sec. Disabled when set to 0").setDefaultValue(60);
+	addOption("rpc.frameCompression").setType(cp::RpcValue::Type::Bool).setNames("--rpc-frame-compression").setComment("Negotiate compression of big RPC frames with broker").setDefaultValue(false);
 }
 
 } // namespace shv
@@ -3,6 +3,9 @@
 #include <shv/iotqt/rpc/clientappclioptions.h>
 #include <shv/iotqt/rpc/socket.h>
 #include <shv/iotqt/rpc/localsocket.h>
+#ifdef WITH_SHV_SHM_SOCKET
+#include <shv/iotqt/rpc/shmsocket.h>
+#endif
 #include <shv/iotqt/rpc/socketrpcconnection.h>
 #include <shv/iotqt/rpc/websocket.h>
 
@@ -48,6 +51,7 @@ ClientConnection::ClientConnection(QObject *parent)
 {
 	connect(this, &SocketRpcConnection::socketConnectedChanged, this, &ClientConnection::onSocketConnectedChanged);
 	setProtocolType(cp::Rpc::ProtocolType::ChainPack);
+	m_mutedInLogClock.start();
 }
 
 ClientConnection::~ClientConnection()
@@ -101,6 +105,7 @@ QUrl ClientConnection::connectionUrlFromString(const QString &url_str)
 		Socket::schemeToString(Socket::Scheme::SerialPort),
 		Socket::schemeToString(Socket::Scheme::LocalSocket),
 		Socket::schemeToString(Socket::Scheme::LocalSocketSerial),
+		Socket::schemeToString(Socket::Scheme::SharedMemory),
 	};
 	QUrl url(url_str);
 	if(!known_schemes.contains(url.scheme())) {
@@ -188,6 +193,7 @@ void ClientConnection::setCliOptions(const ClientAppCliOptions *cli_opts)
 	setLoginType(shv::chainpack::UserLogin::loginTypeFromString(cli_opts->loginType()));
 
 	setHeartBeatInterval(cli_opts->heartBeatInterval());
+	setFrameCompressionEnabled(cli_opts->frameCompression());
 	{
 		cp::RpcValue::Map opts;
 		opts[cp::Rpc::OPT_IDLE_WD_TIMEOUT] = 3 * heartBeatInterval();
@@ -226,6 +232,13 @@ void ClientConnection::open()
 		else if(scheme == Socket::Scheme::LocalSocketSerial) {
 			socket = new LocalSocket(new QLocalSocket(), LocalSocket::Protocol::Serial);
 		}
+		else if(scheme == Socket::Scheme::SharedMemory) {
+#ifdef WITH_SHV_SHM_SOCKET
+			socket = new ShmSocket(new QLocalSocket(), ShmSocket::Role::Client);
+#else
+			SHV_EXCEPTION("Shared memory socket support is not part of this build.");
+#endif
+		}
 #ifdef QT_SERIALPORT_LIB
 		else if(scheme == Socket::Scheme::SerialPort) {
 			socket = new SerialPortSocket(new QSerialPort());
@@ -291,24 +304,46 @@ bool ClientConnection::isBrokerConnected() const
 	return m_socket && m_socket->isOpen() && state() == State::BrokerConnected;
 }
 
-static constexpr std::string_view::size_type MAX_LOG_LEN = 1024;
+static constexpr size_t MAX_LOG_LEN = 1024;
+static constexpr qint64 MUTED_RESPONSE_TIMEOUT_MSEC = 10000;
+
+void ClientConnection::muteResponseInLog(int64_t request_id)
+{
+	const auto now = m_mutedInLogClock.elapsed();
+	if(now - m_mutedInLogPrunedMsec > MUTED_RESPONSE_TIMEOUT_MSEC) {
+		// responses which never came are dropped in one pass per timeout interval
+		std::erase_if(m_responseIdsMutedInLog, [now](const auto &kv) {
+			return now - kv.second > MUTED_RESPONSE_TIMEOUT_MSEC;
+		});
+		m_mutedInLogPrunedMsec = now;
+	}
+	m_responseIdsMutedInLog[request_id] = now;
+}
+
+bool ClientConnection::takeResponseMutedInLog(int64_t request_id)
+{
+	if(m_responseIdsMutedInLog.empty())
+		return false;
+	auto it = m_responseIdsMutedInLog.find(request_id);
+	if(it == m_responseIdsMutedInLog.end())
+		return false;
+	const bool is_expired = m_mutedInLogClock.elapsed() - it->second > MUTED_RESPONSE_TIMEOUT_MSEC;
+	m_responseIdsMutedInLog.erase(it);
+	return !is_expired;
+}
 
 void ClientConnection::sendRpcMessage(const cp::RpcMessage &rpc_msg)
 {
 	if(NecroLog::shouldLog(NecroLog::Level::Message, NecroLog::LogContext(__FILE__, __LINE__, chainpack::Rpc::TOPIC_RPC_MSG))) {
 		if(isShvPathMutedInLog(rpc_msg.shvPath().asString(), rpc_msg.method().asString())) {
-			if(rpc_msg.isRequest()) {
-				auto rq_id = rpc_msg.requestId().toInt64();
-				QElapsedTimer tm;
-				tm.start();
-				m_responseIdsMutedInLog.emplace_back(rq_id, tm);
-			}
+			if(rpc_msg.isRequest())
+				muteResponseInLog(rpc_msg.requestId().toInt64());
 		}
 		else {
 			NecroLog::create(NecroLog::Level::Message, NecroLog::LogContext(__FILE__, __LINE__, chainpack::Rpc::TOPIC_RPC_MSG))
 				<< chainpack::Rpc::SND_LOG_ARROW
 				<< "client id:" << connectionId()
-				<< std::string_view(m_rawRpcMessageLog? rpc_msg.toCpon(): rpc_msg.toPrettyString()).substr(0, MAX_LOG_LEN);
+				<< (m_rawRpcMessageLog? rpc_msg.toCpon(MAX_LOG_LEN): rpc_msg.toPrettyString(MAX_LOG_LEN));
 		}
 	}
 	Super::sendRpcMessage(rpc_msg);
@@ -317,33 +352,14 @@ void ClientConnection::sendRpcMessage(const cp::RpcMessage &rpc_msg)
 void ClientConnection::onRpcMessageReceived(const chainpack::RpcMessage &rpc_msg)
 {
 	if(NecroLog::shouldLog(NecroLog::Level::Message, NecroLog::LogContext(__FILE__, __LINE__, chainpack::Rpc::TOPIC_RPC_MSG))) {
-		bool skip_log = false;
-		if(rpc_msg.isResponse()) {
-			QElapsedTimer now;
-			now.start();
-			for (auto iter = m_responseIdsMutedInLog.begin(); iter != m_responseIdsMutedInLog.end(); ) {
-				const auto &[rq_id, elapsed_tm] = *iter;
-				//shvError() << rq_id << "vs" << msg.requestId().toInt64();
-				if(rq_id == rpc_msg.requestId().toInt64()) {
-					iter = m_responseIdsMutedInLog.erase(iter);
-					skip_log = true;
-				}
-				else if(elapsed_tm.msecsTo(now) > 10000) {
-					iter = m_responseIdsMutedInLog.erase(iter);
-				}
-				else {
-					++iter;
-				}
-			}
-		}
-		else {
-			skip_log = isShvPathMutedInLog(rpc_msg.shvPath().asString(), rpc_msg.method().asString());
-		}
+		const bool skip_log = rpc_msg.isResponse()
+				? takeResponseMutedInLog(rpc_msg.requestId().toInt64())
+				: isShvPathMutedInLog(rpc_msg.shvPath().asString(), rpc_msg.method().asString());
 		if(!skip_log) {
 			NecroLog::create(NecroLog::Level::Message, NecroLog::LogContext(__FILE__, __LINE__, chainpack::Rpc::TOPIC_RPC_MSG))
 				<< chainpack::Rpc::RCV_LOG_ARROW
 				<< "client id:" << connectionId()
-				<< std::string_view(m_rawRpcMessageLog? rpc_msg.toCpon(): rpc_msg.toPrettyString()).substr(0, MAX_LOG_LEN);
+				<< (m_rawRpcMessageLog? rpc_msg.toCpon(MAX_LOG_LEN): rpc_msg.toPrettyString(MAX_LOG_LEN));
 		}
 	}
 	if(isLoginPhase()) {
@@ -377,6 +393,8 @@ void ClientConnection::setState(ClientConnection::State state)
 
 void ClientConnection::sendHello()
 {
+	// compression is negotiated again on every login
+	setFrameCompression(cp::RpcFrame::Compression::None);
 	m_connectionState.helloRequestId = callShvMethod({}, cp::Rpc::METH_HELLO);
 }
 
@@ -498,6 +516,12 @@ chainpack::RpcValue ClientConnection::createLoginParams(const chainpack::RpcValu
 	else {
 		shvError() << "Login type:" << chainpack::UserLogin::loginTypeToString(loginType()) << "not supported";
 	}
+	cp::RpcValue login_options = connectionOptions();
+	if(isFrameCompressionEnabled() && cp::RpcFrame::isCompressionSupported(cp::RpcFrame::Compression::Deflate)) {
+		auto opts = login_options.asMap();
+		opts[cp::Rpc::OPT_COMPRESSION] = cp::RpcValue::List{cp::RpcFrame::compressionToString(cp::RpcFrame::Compression::Deflate)};
+		login_options = opts;
+	}
 	return cp::RpcValue::Map {
 		{"login", cp::RpcValue::Map {
 			{"user", user_name},
@@ -505,7 +529,7 @@ chainpack::RpcValue ClientConnection::createLoginParams(const chainpack::RpcValu
 			{"type", chainpack::UserLogin::loginTypeToString(loginType())},
 		 },
 		},
-		{"options", connectionOptions()},
+		{"options", login_options},
 	};
 }
 
@@ -606,6 +630,7 @@ void ClientConnection::processLoginPhase(const chainpack::RpcMessage &msg)
 		}
 		if(m_connectionState.loginRequestId == id) {
 			m_connectionState.loginResult = resp.result();
+			setFrameCompression(cp::RpcFrame::compressionFromString(loginResult().value(cp::Rpc::OPT_COMPRESSION).asString()));
 			setState(State::BrokerConnected);
 			return;
 		}
@@ -267,4 +267,135 @@ int RpcCall::start()
 	return rq_id;
 }
 
+//===================================================
+// RpcCallBatch
+//===================================================
+RpcCallBatch::RpcCallBatch(ClientConnection *connection)
+	: m_rpcConnection(connection)
+	, m_timeout(ClientConnection::defaultRpcTimeoutMsec())
+{
+}
+
+RpcCallBatch *RpcCallBatch::create(ClientConnection *connection)
+{
+	return new RpcCallBatch(connection);
+}
+
+int RpcCallBatch::addCall(const std::string &shv_path, const std::string &method, const chainpack::RpcValue &params, const chainpack::RpcValue &user_id)
+{
+	m_calls.push_back(Call{.shvPath = shv_path, .method = method, .params = params, .userId = user_id, .result = {}, .error = {}, .isFinished = false});
+	return static_cast<int>(m_calls.size()) - 1;
+}
+
+RpcCallBatch *RpcCallBatch::setTimeout(int timeout)
+{
+	m_timeout = timeout;
+	return this;
+}
+
+int RpcCallBatch::callCount() const
+{
+	return static_cast<int>(m_calls.size());
+}
+
+const chainpack::RpcValue &RpcCallBatch::result(int index) const
+{
+	return m_calls.at(static_cast<size_t>(index)).result;
+}
+
+const chainpack::RpcError &RpcCallBatch::error(int index) const
+{
+	return m_calls.at(static_cast<size_t>(index)).error;
+}
+
+void RpcCallBatch::start()
+{
+	// requests must not be sent twice, batch can be also finished already by abort()
+	if(m_isStarted || m_isFinished)
+		return;
+	m_isStarted = true;
+	if(m_rpcConnection.isNull() || !m_rpcConnection->isBrokerConnected()) {
+		finishPending(RpcError(m_rpcConnection.isNull()? "RPC connection is NULL": "RPC connection is not open"));
+		return;
+	}
+	connect(m_rpcConnection, &ClientConnection::rpcMessageReceived, this, &RpcCallBatch::onRpcMessageReceived);
+	connect(m_rpcConnection, &ClientConnection::responseMetaReceived, this, &RpcCallBatch::onResponseMetaReceived);
+	m_timeoutTimer = new QTimer(this);
+	m_timeoutTimer->setSingleShot(true);
+	connect(m_timeoutTimer, &QTimer::timeout, this, [this]() {
+		finishPending(RpcResponse::Error::create(RpcResponse::Error::MethodCallTimeout, "Shv call timeout after: " + std::to_string(m_timeoutTimer->interval()) + " msec."));
+	});
+	// all requests are written in one event loop iteration, so socket sends them in as few packets as possible
+	for (size_t i = 0; i < m_calls.size(); ++i) {
+		const auto &call = m_calls[i];
+		int rq_id = m_rpcConnection->nextRequestId();
+		m_pendingCalls[rq_id] = static_cast<int>(i);
+		m_rpcConnection->callShvMethod(rq_id, call.shvPath, call.method, call.params, call.userId);
+	}
+	if(m_pendingCalls.empty())
+		finishPending({});
+	else
+		m_timeoutTimer->start(m_timeout);
+}
+
+void RpcCallBatch::abort()
+{
+	finishPending(RpcResponse::Error::create(RpcResponse::Error::MethodCallCancelled, "Shv call aborted"));
+}
+
+void RpcCallBatch::onRpcMessageReceived(const chainpack::RpcMessage &msg)
+{
+	if(m_isFinished || !msg.isResponse())
+		return;
+	RpcResponse rsp(msg);
+	if(rsp.peekCallerId() != 0)
+		return;
+	auto it = m_pendingCalls.find(rsp.requestId().toInt());
+	if(it == m_pendingCalls.end())
+		return;
+	int index = it->second;
+	m_pendingCalls.erase(it);
+	if(rsp.isSuccess())
+		setItemResult(index, rsp.result(), {});
+	else
+		setItemResult(index, {}, rsp.error());
+	if(m_pendingCalls.empty())
+		finishPending({});
+	else
+		m_timeoutTimer->start();
+}
+
+void RpcCallBatch::onResponseMetaReceived(int request_id)
+{
+	if(!m_isFinished && m_pendingCalls.contains(request_id)) {
+		// response is being received
+		m_timeoutTimer->start();
+	}
+}
+
+void RpcCallBatch::setItemResult(int index, const chainpack::RpcValue &result, const chainpack::RpcError &error)
+{
+	auto &call = m_calls[static_cast<size_t>(index)];
+	call.result = result;
+	call.error = error;
+	call.isFinished = true;
+	emit itemFinished(index, result, error);
+}
+
+void RpcCallBatch::finishPending(const chainpack::RpcError &error)
+{
+	if(m_isFinished)
+		return;
+	m_isFinished = true;
+	if(m_timeoutTimer)
+		m_timeoutTimer->stop();
+	m_pendingCalls.clear();
+	for (size_t i = 0; i < m_calls.size(); ++i) {
+		if(!m_calls[i].isFinished)
+			setItemResult(static_cast<int>(i), {}, error);
+	}
+	emit finished();
+	deleteLater();
+}
+
 } // namespace shv
@@ -8,6 +8,8 @@
 #include <QUrl>
 #include <QTimer>
 
+#include <cstring>
+
 #define logSerialPortSocketD() nCDebug("SerialPortSocket")
 #define logSerialPortSocketM() nCMessage("SerialPortSocket")
 #define logSerialPortSocketW() nCWarning("SerialPortSocket")
@@ -32,6 +34,36 @@ enum EscCodes: uint8_t {
 	EESC = 0x0A,
 };
 
+namespace {
+/// returns position of first STX, ETX, ATX or ESC byte in data starting on pos, data.size() if there is none
+size_t find_control_byte(std::string_view data, size_t pos)
+{
+	// test 8 bytes at once, word containing a control byte is rescanned bytewise then
+	constexpr uint64_t ONES = 0x0101010101010101;
+	constexpr uint64_t HIGHS = 0x8080808080808080;
+	auto has_byte = [](uint64_t word, uint8_t b) {
+		const auto x = word ^ (ONES * b);
+		return (x - ONES) & ~x & HIGHS;
+	};
+	auto is_control_byte = [](uint8_t b) {
+		return b == STX || b == ETX || b == ATX || b == ESC;
+	};
+	for (; pos + sizeof(uint64_t) <= data.size(); pos += sizeof(uint64_t)) {
+		uint64_t word;
+		std::memcpy(&word, data.data() + pos, sizeof(word));
+		if (has_byte(word, STX) | has_byte(word, ETX) | has_byte(word, ATX) | has_byte(word, ESC)) {
+			break;
+		}
+	}
+	for (; pos < data.size(); ++pos) {
+		if (is_control_byte(static_cast<uint8_t>(data[pos]))) {
+			return pos;
+		}
+	}
+	return data.size();
+}
+}
+
 SerialFrameReader::SerialFrameReader(CrcCheck crc)
 	: m_withCrcCheck(crc == CrcCheck::Yes)
 {
@@ -64,16 +96,16 @@ QList<int> SerialFrameReader::addData(std::string_view data)
 			}
 		}
 	};
-	for (uint8_t b : data) {
+	auto process_byte = [&](uint8_t b) {
 		if (b == STX) {
 			setState(ReadState::WaitingForEtx);
 			m_recentByte = b;
-			continue;
+			return;
 		}
 		if (b == ATX) {
 			setState(ReadState::WaitingForStx);
 			m_recentByte = b;
-			continue;
+			return;
 		}
 		switch (m_readState) {
 		case ReadState::WaitingForStx: {
@@ -81,7 +113,7 @@ QList<int> SerialFrameReader::addData(std::string_view data)
 				setState(ReadState::WaitingForEtx);
 			}
 			m_recentByte = b;
-			continue;
+			return;
 		}
 		case ReadState::WaitingForEtx: {
 			if (b == ETX) {
@@ -92,12 +124,12 @@ QList<int> SerialFrameReader::addData(std::string_view data)
 					check_response_id();
 					finishFrame();
 				}
-				continue;
+				return;
 			}
 			m_crcDigest.add(b);
 			add_byte(m_readBuffer, b);
 			m_recentByte = b;
-			continue;
+			return;
 		}
 		case ReadState::WaitingForCrc: {
 			add_byte(m_crcBuffer, b);
@@ -106,9 +138,27 @@ QList<int> SerialFrameReader::addData(std::string_view data)
 				check_response_id();
 				finishFrame();
 			}
-			continue;
+			return;
+		}
 		}
+	};
+	size_t pos = 0;
+	while (pos < data.size()) {
+		if (m_readState != ReadState::WaitingForCrc && !inEscape()) {
+			// ordinary bytes are skipped or copied in bulk, only control bytes go through the state machine
+			const auto run_end = find_control_byte(data, pos);
+			if (run_end > pos) {
+				const auto run = data.substr(pos, run_end - pos);
+				if (m_readState == ReadState::WaitingForEtx) {
+					m_crcDigest.add(run.data(), run.size());
+					m_readBuffer += run;
+				}
+				m_recentByte = static_cast<uint8_t>(run.back());
+				pos = run_end;
+				continue;
+			}
 		}
+		process_byte(static_cast<uint8_t>(data[pos++]));
 	}
 	check_response_id();
 	return response_request_ids;
@@ -180,6 +230,7 @@ SerialFrameWriter::SerialFrameWriter(CrcCheck crc)
 void SerialFrameWriter::addFrame(const std::string &frame_data)
 {
 	QByteArray data_to_write;
+	data_to_write.reserve(static_cast<int>(frame_data.size()) + 16);
 	auto write_escaped = [&data_to_write](uint8_t b) {
 		switch (b) {
 		case STX: data_to_write += static_cast<char>(ESC); data_to_write += static_cast<char>(ESTX); break;
@@ -190,8 +241,14 @@ void SerialFrameWriter::addFrame(const std::string &frame_data)
 		}
 	};
 	data_to_write += static_cast<char>(STX);
-	for(uint8_t b : frame_data) {
-		write_escaped(b);
+	for (size_t pos = 0; pos < frame_data.size(); ) {
+		const auto run_end = find_control_byte(frame_data, pos);
+		data_to_write.append(frame_data.data() + pos, static_cast<int>(run_end - pos));
+		if (run_end == frame_data.size()) {
+			break;
+		}
+		write_escaped(static_cast<uint8_t>(frame_data[run_end]));
+		pos = run_end + 1;
 	}
 	data_to_write += static_cast<char>(ETX);
 	if (m_withCrcCheck) {
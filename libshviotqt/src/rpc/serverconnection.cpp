@@ -96,7 +96,13 @@ bool ServerConnection::isSlaveBrokerConnection() const
 void ServerConnection::onRpcFrameReceived(chainpack::RpcFrame &&frame)
 {
 	if(isLoginPhase()) {
-		auto msg = frame.toRpcMessage();
+		std::string errmsg;
+		auto msg = frame.toRpcMessage(&errmsg);
+		if(!errmsg.empty()) {
+			shvError() << "Invalid login frame, dropping client connection." << connectionName() << errmsg;
+			abort();
+			return;
+		}
 		processLoginPhase(msg);
 		return;
 	}
@@ -159,9 +165,15 @@ void ServerConnection::setLoginResult(const chainpack::UserLoginResult &result)
 {
 	m_loginOk = result.passwordOk;
 	auto resp = cp::RpcResponse::forRequest(m_userLoginContext.loginRequest);
+	auto compression = cp::RpcFrame::Compression::None;
 	if(result.passwordOk) {
 		shvInfo().nospace() << "Client logged in user: " << m_userLogin.user << " from: " << peerAddress() << ':' << peerPort();
-		resp.setResult(result.toRpcValue());
+		auto login_result = result.toRpcValue().asMap();
+		compression = selectFrameCompression();
+		if(compression != cp::RpcFrame::Compression::None) {
+			login_result[cp::Rpc::OPT_COMPRESSION] = cp::RpcFrame::compressionToString(compression);
+		}
+		resp.setResult(login_result);
 	}
 	else {
 		shvWarning().nospace() << "Invalid authentication for user: " << m_userLogin.user
@@ -172,6 +184,19 @@ void ServerConnection::setLoginResult(const chainpack::UserLoginResult &result)
 																			 + " at: " + connectionName()));
 	}
 	sendRpcMessage(resp);
+	// login response itself is sent uncompressed
+	setFrameCompression(compression);
+}
+
+chainpack::RpcFrame::Compression ServerConnection::selectFrameCompression() const
+{
+	for(const auto &name : connectionOptions().value(cp::Rpc::OPT_COMPRESSION).asList()) {
+		// unknown names are mapped to None, skip them to let the client list further alternatives
+		if(auto compression = cp::RpcFrame::compressionFromString(name.asString()); compression != cp::RpcFrame::Compression::None && cp::RpcFrame::isCompressionSupported(compression)) {
+			return compression;
+		}
+	}
+	return cp::RpcFrame::Compression::None;
 }
 
 }
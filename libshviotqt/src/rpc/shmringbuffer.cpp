@@ -0,0 +1,144 @@
+#include <shv/iotqt/rpc/shmringbuffer.h>
+
+#include <shv/core/exception.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+namespace shv::iotqt::rpc {
+
+namespace {
+constexpr uint32_t MAGIC = 0x52564853; // "SHVR"
+constexpr size_t CACHE_LINE_SIZE = 64;
+}
+
+/// head and tail are free running counters masked by capacity - 1 on access,
+/// 32 bits are enough for capacity up to 2^31 and work for 32 and 64 bit peers
+struct ShmRingBuffer::Header
+{
+	uint32_t magic;
+	uint32_t capacity;
+	alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> head;
+	alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> tail;
+	alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> readerWaiting;
+	std::atomic<uint32_t> writerWaiting;
+};
+
+// both processes must see the same atomics without any process local lock
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+
+ShmRingBuffer::ShmRingBuffer(Header *header, uint32_t capacity)
+	: m_header(header)
+	, m_data(reinterpret_cast<char*>(header) + sizeof(Header))
+	, m_capacity(capacity)
+{
+}
+
+size_t ShmRingBuffer::requiredMemorySize(size_t capacity)
+{
+	return sizeof(Header) + capacity;
+}
+
+ShmRingBuffer ShmRingBuffer::create(void *memory, size_t capacity)
+{
+	if(capacity == 0 || (capacity & (capacity - 1)) != 0 || capacity > (1u << 31))
+		SHV_EXCEPTION("Invalid ring buffer capacity: " + std::to_string(capacity));
+	if(reinterpret_cast<uintptr_t>(memory) % CACHE_LINE_SIZE != 0)
+		SHV_EXCEPTION("Ring buffer memory is not aligned");
+	auto *header = new (memory) Header{};
+	header->magic = MAGIC;
+	header->capacity = static_cast<uint32_t>(capacity);
+	// consumer sleeps until first data is written
+	header->readerWaiting.store(1);
+	return ShmRingBuffer(header, static_cast<uint32_t>(capacity));
+}
+
+ShmRingBuffer ShmRingBuffer::attach(void *memory, size_t memory_size)
+{
+	if(memory_size < sizeof(Header) || reinterpret_cast<uintptr_t>(memory) % CACHE_LINE_SIZE != 0)
+		SHV_EXCEPTION("Invalid ring buffer memory");
+	auto *header = static_cast<Header*>(memory);
+	// peer can rewrite the header any time, capacity is read once and never again
+	const uint32_t capacity = std::atomic_ref<uint32_t>(header->capacity).load();
+	if(header->magic != MAGIC || capacity == 0 || (capacity & (capacity - 1)) != 0 || requiredMemorySize(capacity) > memory_size)
+		SHV_EXCEPTION("Invalid ring buffer header");
+	return ShmRingBuffer(header, capacity);
+}
+
+size_t ShmRingBuffer::capacity() const
+{
+	return m_capacity;
+}
+
+uint32_t ShmRingBuffer::usedSize(uint32_t head, uint32_t tail) const
+{
+	const uint32_t n = head - tail;
+	if(n > m_capacity)
+		SHV_EXCEPTION("Ring buffer indices are corrupted, head: " + std::to_string(head) + " tail: " + std::to_string(tail));
+	return n;
+}
+
+size_t ShmRingBuffer::readableSize() const
+{
+	return usedSize(m_header->head.load(std::memory_order_acquire), m_header->tail.load(std::memory_order_relaxed));
+}
+
+size_t ShmRingBuffer::writableSize() const
+{
+	return m_capacity - usedSize(m_header->head.load(std::memory_order_relaxed), m_header->tail.load(std::memory_order_acquire));
+}
+
+size_t ShmRingBuffer::write(std::string_view data)
+{
+	// each index is loaded once, so that all bounds below are computed from validated values
+	const auto head = m_header->head.load(std::memory_order_relaxed);
+	const auto tail = m_header->tail.load(std::memory_order_acquire);
+	const auto n = std::min<size_t>(data.size(), m_capacity - usedSize(head, tail));
+	const size_t pos = head & (m_capacity - 1);
+	const auto n1 = std::min<size_t>(n, m_capacity - pos);
+	std::memcpy(m_data + pos, data.data(), n1);
+	std::memcpy(m_data, data.data() + n1, n - n1);
+	// seq_cst store pairs with load of waiting flag, so that sleeping consumer cannot be missed
+	m_header->head.store(head + static_cast<uint32_t>(n));
+	return n;
+}
+
+size_t ShmRingBuffer::read(char *dest, size_t size)
+{
+	const auto tail = m_header->tail.load(std::memory_order_relaxed);
+	const auto head = m_header->head.load(std::memory_order_acquire);
+	const auto n = std::min<size_t>(size, usedSize(head, tail));
+	const size_t pos = tail & (m_capacity - 1);
+	const auto n1 = std::min<size_t>(n, m_capacity - pos);
+	std::memcpy(dest, m_data + pos, n1);
+	std::memcpy(dest + n1, m_data, n - n1);
+	m_header->tail.store(tail + static_cast<uint32_t>(n));
+	return n;
+}
+
+bool ShmRingBuffer::setReaderWaiting()
+{
+	m_header->readerWaiting.store(1);
+	return readableSize() == 0;
+}
+
+bool ShmRingBuffer::takeReaderWaiting()
+{
+	return m_header->readerWaiting.exchange(0) != 0;
+}
+
+bool ShmRingBuffer::setWriterWaiting(size_t required_size)
+{
+	m_header->writerWaiting.store(1);
+	return writableSize() < required_size;
+}
+
+bool ShmRingBuffer::takeWriterWaiting()
+{
+	return m_header->writerWaiting.exchange(0) != 0;
+}
+
+} // namespace shv::iotqt::rpc
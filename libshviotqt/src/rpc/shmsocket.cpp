@@ -0,0 +1,413 @@
+#include <shv/iotqt/rpc/shmsocket.h>
+
+#include <shv/coreqt/log.h>
+#include <shv/core/exception.h>
+#include <shv/chainpack/utils.h>
+
+#include <QLocalSocket>
+#include <QHostAddress>
+#include <QUrl>
+
+#include <atomic>
+#include <cstring>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace shv::iotqt::rpc {
+
+namespace {
+constexpr auto SEGMENT_NAME_PREFIX = "/shv-";
+constexpr size_t MAX_SEGMENT_NAME_LENGTH = 200;
+constexpr size_t MAX_SEGMENT_SIZE = 64 * 1024 * 1024;
+constexpr char WAKE_UP_BYTE = 1;
+using FrameLength = uint32_t;
+
+size_t ring_memory_size(size_t capacity)
+{
+	// keep second ring header cache line aligned
+	constexpr size_t ALIGNMENT = 64;
+	return (ShmRingBuffer::requiredMemorySize(capacity) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+bool peer_uid(int socket_fd, uid_t &uid)
+{
+#if defined(SO_PEERCRED)
+	struct ucred cred;
+	socklen_t cred_len = sizeof(cred);
+	if(::getsockopt(socket_fd, SOL_SOCKET, SO_PEERCRED, &cred, &cred_len) != 0)
+		return false;
+	uid = cred.uid;
+	return true;
+#elif defined(SHV_HAVE_GETPEEREID)
+	gid_t gid;
+	return ::getpeereid(socket_fd, &uid, &gid) == 0;
+#else
+#error "Shared memory socket requires peer credentials check"
+#endif
+}
+}
+
+//======================================================
+// ShmFrameReader
+//======================================================
+QList<int> ShmFrameReader::addData(std::string_view frame_data)
+{
+	QList<int> ret;
+	if(auto rqid = addFrame(std::string(frame_data)); rqid.has_value())
+		ret << rqid.value();
+	return ret;
+}
+
+std::optional<int> ShmFrameReader::addFrame(const std::string &frame_data)
+{
+	auto frame = chainpack::RpcFrame::fromFrameData(frame_data);
+	std::optional<int> ret;
+	if(chainpack::RpcMessage::isResponse(frame.meta)) {
+		if(auto rqid = chainpack::RpcMessage::requestId(frame.meta).toInt(); rqid > 0)
+			ret = rqid;
+	}
+	m_frames.push_back(std::move(frame));
+	return ret;
+}
+
+//======================================================
+// ShmFrameWriter
+//======================================================
+void ShmFrameWriter::addFrame(const std::string &frame_data)
+{
+	// peer would drop the connection when receiving it
+	if(frame_data.size() > ShmSocket::MAX_FRAME_SIZE)
+		SHV_EXCEPTION("Frame size " + std::to_string(frame_data.size()) + " exceeds shared memory socket limit " + std::to_string(ShmSocket::MAX_FRAME_SIZE));
+	const auto len = static_cast<FrameLength>(frame_data.size());
+	QByteArray data(static_cast<qsizetype>(sizeof(len) + frame_data.size()), Qt::Uninitialized);
+	std::memcpy(data.data(), &len, sizeof(len));
+	std::memcpy(data.data() + sizeof(len), frame_data.data(), frame_data.size());
+	m_messageDataToWrite.append(data);
+}
+
+size_t ShmFrameWriter::requiredSpace() const
+{
+	return m_writtenSize == 0? sizeof(FrameLength): 1;
+}
+
+size_t ShmFrameWriter::flushToRing(ShmRingBuffer &ring)
+{
+	size_t ret = 0;
+	while (!m_messageDataToWrite.isEmpty() && ring.writableSize() >= requiredSpace()) {
+		const auto &data = m_messageDataToWrite.first();
+		auto n = ring.write(std::string_view(data.constData() + m_writtenSize, static_cast<size_t>(data.size() - m_writtenSize)));
+		ret += n;
+		m_writtenSize += static_cast<qsizetype>(n);
+		if(m_writtenSize == data.size()) {
+			m_messageDataToWrite.removeFirst();
+			m_writtenSize = 0;
+		}
+	}
+	return ret;
+}
+
+//======================================================
+// ShmSocket
+//======================================================
+ShmSocket::ShmSocket(QLocalSocket *socket, Role role, QObject *parent)
+	: Super(parent)
+	, m_socket(socket)
+	, m_role(role)
+{
+	m_frameReader = new ShmFrameReader();
+	m_frameWriter = new ShmFrameWriter();
+	m_socket->setParent(this);
+
+	if(m_role == Role::Client)
+		connect(m_socket, &QLocalSocket::connected, this, &ShmSocket::onControlSocketConnected);
+	connect(m_socket, &QLocalSocket::disconnected, this, &Socket::disconnected);
+	connect(m_socket, &QLocalSocket::readyRead, this, &ShmSocket::onControlSocketReadyRead);
+	// QLocalSocket states and errors are defined as aliases of QAbstractSocket ones
+	connect(m_socket, &QLocalSocket::stateChanged, this, [this](QLocalSocket::LocalSocketState state) {
+		emit stateChanged(static_cast<QAbstractSocket::SocketState>(state));
+	});
+	connect(m_socket, &QLocalSocket::errorOccurred, this, [this](QLocalSocket::LocalSocketError socket_error) {
+		emit error(static_cast<QAbstractSocket::SocketError>(socket_error));
+	});
+}
+
+ShmSocket::~ShmSocket()
+{
+	releaseSegment();
+}
+
+void ShmSocket::connectToHost(const QUrl &url)
+{
+	m_errorString.clear();
+	m_socket->connectToServer(url.path());
+}
+
+void ShmSocket::close()
+{
+	Super::close();
+	m_socket->close();
+	releaseSegment();
+}
+
+void ShmSocket::abort()
+{
+	Super::abort();
+	m_socket->abort();
+	releaseSegment();
+}
+
+QAbstractSocket::SocketState ShmSocket::state() const
+{
+	auto state = static_cast<QAbstractSocket::SocketState>(m_socket->state());
+	if(state == QAbstractSocket::ConnectedState && !m_segment) {
+		// frames cannot be sent until both sides have the segment mapped
+		return QAbstractSocket::ConnectingState;
+	}
+	return state;
+}
+
+QString ShmSocket::errorString() const
+{
+	return m_errorString.isEmpty()? m_socket->errorString(): m_errorString;
+}
+
+QHostAddress ShmSocket::peerAddress() const
+{
+	return QHostAddress(m_socket->serverName());
+}
+
+quint16 ShmSocket::peerPort() const
+{
+	return 0;
+}
+
+void ShmSocket::ignoreSslErrors()
+{
+}
+
+void ShmSocket::onControlSocketConnected()
+{
+	createSegment();
+	if(m_segment) {
+		// segment name is the first message on control socket
+		m_socket->write(m_segmentName.data(), static_cast<qint64>(m_segmentName.size()));
+		m_socket->write("\n", 1);
+		m_socket->flush();
+		emit connected();
+	}
+}
+
+void ShmSocket::onControlSocketReadyRead()
+{
+	auto ba = m_socket->readAll();
+	if(m_role == Role::Server && !m_segment) {
+		m_handshakeData.append(ba.constData(), static_cast<size_t>(ba.size()));
+		auto pos = m_handshakeData.find('\n');
+		if(pos == std::string::npos) {
+			if(m_handshakeData.size() > MAX_SEGMENT_NAME_LENGTH)
+				setSegmentError(tr("Invalid shared memory handshake"));
+			return;
+		}
+		attachSegment(m_handshakeData.substr(0, pos));
+		m_handshakeData = {};
+		if(!m_segment)
+			return;
+	}
+	// all other data on control socket are wake up bytes, peer has written frames or freed space in ring
+	readFrames();
+	flushWriteBuffer();
+}
+
+void ShmSocket::createSegment()
+{
+	static std::atomic<unsigned> segment_counter = 0;
+	m_segmentName = SEGMENT_NAME_PREFIX + std::to_string(::getpid()) + '-' + std::to_string(++segment_counter);
+	const auto ring_size = ring_memory_size(DEFAULT_RING_CAPACITY);
+	const auto segment_size = 2 * ring_size;
+	int fd = ::shm_open(m_segmentName.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+	if(fd < 0) {
+		const auto open_errno = errno;
+		// segment name might belong to somebody else, it must not be unlinked
+		const auto segment_name = std::exchange(m_segmentName, {});
+		setSegmentError(tr("Cannot create shared memory segment %1: %2").arg(QString::fromStdString(segment_name), QString::fromLocal8Bit(std::strerror(open_errno))));
+		return;
+	}
+	void *segment = MAP_FAILED;
+	if(::ftruncate(fd, static_cast<off_t>(segment_size)) == 0)
+		segment = ::mmap(nullptr, segment_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	const auto map_errno = errno;
+	::close(fd);
+	if(segment == MAP_FAILED) {
+		setSegmentError(tr("Cannot map shared memory segment %1: %2").arg(QString::fromStdString(m_segmentName), QString::fromLocal8Bit(std::strerror(map_errno))));
+		return;
+	}
+	m_segment = segment;
+	m_segmentSize = segment_size;
+	m_txRing = ShmRingBuffer::create(m_segment, DEFAULT_RING_CAPACITY);
+	m_rxRing = ShmRingBuffer::create(static_cast<char*>(m_segment) + ring_size, DEFAULT_RING_CAPACITY);
+	shvDebug() << "shared memory segment created:" << m_segmentName;
+}
+
+void ShmSocket::attachSegment(const std::string &segment_name)
+{
+	if(segment_name.rfind(SEGMENT_NAME_PREFIX, 0) != 0 || segment_name.find('/', 1) != std::string::npos) {
+		setSegmentError(tr("Invalid shared memory segment name"));
+		return;
+	}
+	int fd = ::shm_open(segment_name.c_str(), O_RDWR, 0);
+	if(fd < 0) {
+		setSegmentError(tr("Cannot open shared memory segment %1: %2").arg(QString::fromStdString(segment_name), QString::fromLocal8Bit(std::strerror(errno))));
+		return;
+	}
+	struct stat st;
+	if(::fstat(fd, &st) != 0) {
+		::close(fd);
+		setSegmentError(tr("Cannot stat shared memory segment %1: %2").arg(QString::fromStdString(segment_name), QString::fromLocal8Bit(std::strerror(errno))));
+		return;
+	}
+	// only segments created by peer running as the same user as this process are accepted,
+	// ownership is checked before unlinking, so foreign segment names cannot be removed
+	if(uid_t uid; !peer_uid(static_cast<int>(m_socket->socketDescriptor()), uid) || uid != ::geteuid() || uid != st.st_uid) {
+		::close(fd);
+		setSegmentError(tr("Shared memory segment is not owned by peer or peer runs as different user"));
+		return;
+	}
+	// segment name is unlinked immediately, it cannot be attached twice then
+	::shm_unlink(segment_name.c_str());
+	if(st.st_size <= 0 || static_cast<size_t>(st.st_size) > MAX_SEGMENT_SIZE) {
+		::close(fd);
+		setSegmentError(tr("Invalid shared memory segment size"));
+		return;
+	}
+	const auto segment_size = static_cast<size_t>(st.st_size);
+	void *segment = ::mmap(nullptr, segment_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	const auto map_errno = errno;
+	::close(fd);
+	if(segment == MAP_FAILED) {
+		setSegmentError(tr("Cannot map shared memory segment %1: %2").arg(QString::fromStdString(segment_name), QString::fromLocal8Bit(std::strerror(map_errno))));
+		return;
+	}
+	try {
+		m_rxRing = ShmRingBuffer::attach(segment, segment_size);
+		const auto ring_size = ring_memory_size(m_rxRing.capacity());
+		m_txRing = ShmRingBuffer::attach(static_cast<char*>(segment) + ring_size, segment_size - std::min(ring_size, segment_size));
+	}
+	catch (const std::exception &e) {
+		::munmap(segment, segment_size);
+		m_rxRing = {};
+		m_txRing = {};
+		setSegmentError(QString::fromStdString(e.what()));
+		return;
+	}
+	m_segment = segment;
+	m_segmentSize = segment_size;
+	shvDebug() << "shared memory segment attached:" << segment_name;
+}
+
+void ShmSocket::releaseSegment()
+{
+	m_rxRing = {};
+	m_txRing = {};
+	if(m_segment) {
+		::munmap(m_segment, m_segmentSize);
+		m_segment = nullptr;
+		m_segmentSize = 0;
+	}
+	if(m_role == Role::Client && !m_segmentName.empty()) {
+		// server might not have attached the segment
+		::shm_unlink(m_segmentName.c_str());
+		m_segmentName.clear();
+	}
+	m_rxFrame = {};
+	m_rxFrameReadSize = 0;
+	m_rxFrameStarted = false;
+}
+
+void ShmSocket::readFrames()
+{
+	if(!m_rxRing.isValid())
+		return;
+	auto *frame_reader = static_cast<ShmFrameReader*>(m_frameReader);
+	bool frame_received = false;
+	try {
+		do {
+			while(true) {
+				if(!m_rxFrameStarted) {
+					// frame length is never split by writer
+					FrameLength len;
+					if(m_rxRing.readableSize() < sizeof(len))
+						break;
+					m_rxRing.read(reinterpret_cast<char*>(&len), sizeof(len));
+					if(len > MAX_FRAME_SIZE)
+						SHV_EXCEPTION("Frame size " + std::to_string(len) + " exceeds limit " + std::to_string(MAX_FRAME_SIZE));
+					m_rxFrame.resize(len);
+					m_rxFrameReadSize = 0;
+					m_rxFrameStarted = true;
+				}
+				m_rxFrameReadSize += m_rxRing.read(m_rxFrame.data() + m_rxFrameReadSize, m_rxFrame.size() - m_rxFrameReadSize);
+				if(m_rxFrameReadSize < m_rxFrame.size())
+					break;
+				m_rxFrameStarted = false;
+				if(auto rqid = frame_reader->addFrame(m_rxFrame); rqid.has_value())
+					emit responseMetaReceived(rqid.value());
+				frame_received = true;
+			}
+			if(m_rxRing.takeWriterWaiting())
+				wakeUpPeer();
+		} while(!m_rxRing.setReaderWaiting());
+	}
+	catch (const std::exception &e) {
+		shvWarning() << "Corrupted frame received:" << shv::chainpack::utils::hexDump(std::string_view(m_rxFrame).substr(0, 64));
+		// peer does not follow the protocol or it has tampered the shared memory, it cannot be trusted anymore
+		setSegmentError(QString::fromStdString(e.what()));
+		return;
+	}
+	if(frame_received) {
+		emit dataChunkReceived();
+		emit readyRead();
+	}
+}
+
+void ShmSocket::flushWriteBuffer()
+{
+	if(!m_txRing.isValid())
+		return;
+	auto *frame_writer = static_cast<ShmFrameWriter*>(m_frameWriter);
+	size_t written = 0;
+	try {
+		while(true) {
+			written += frame_writer->flushToRing(m_txRing);
+			// wait for peer to free space in ring, it sends wake up byte then
+			if(!frame_writer->hasPendingData() || m_txRing.setWriterWaiting(frame_writer->requiredSpace()))
+				break;
+		}
+	}
+	catch (const std::exception &e) {
+		setSegmentError(QString::fromStdString(e.what()));
+		return;
+	}
+	if(written > 0 && m_txRing.takeReaderWaiting())
+		wakeUpPeer();
+}
+
+void ShmSocket::wakeUpPeer()
+{
+	m_socket->write(&WAKE_UP_BYTE, 1);
+	m_socket->flush();
+}
+
+void ShmSocket::setSegmentError(const QString &error_string)
+{
+	shvWarning() << error_string;
+	m_errorString = error_string;
+	releaseSegment();
+	m_socket->abort();
+	emit error(QAbstractSocket::SocketResourceError);
+}
+
+} // namespace shv::iotqt::rpc
@@ -199,6 +199,7 @@ const char * Socket::schemeToString(Scheme schema)
 	case Scheme::SerialPort: return "serial";
 	case Scheme::LocalSocket: return "unix";
 	case Scheme::LocalSocketSerial: return "unixs";
+	case Scheme::SharedMemory: return "shm";
 	}
 	return "";
 }
@@ -212,6 +213,7 @@ Socket::Scheme Socket::schemeFromString(const std::string &schema)
 	if(schema == "serialport" || schema == "serial") return Scheme::SerialPort;
 	if(schema == "localsocket" || schema == "unix") return Scheme::LocalSocket;
 	if(schema == "unixs") return Scheme::LocalSocketSerial;
+	if(schema == "shm") return Scheme::SharedMemory;
 	return Scheme::Tcp;
 }
 
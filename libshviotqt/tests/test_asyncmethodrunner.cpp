@@ -0,0 +1,225 @@
+#include <shv/iotqt/node/asyncmethodrunner.h>
+
+#include <shv/core/utils/shvfilejournal.h>
+#include <shv/core/utils/shvgetlogparams.h>
+#include <shv/core/utils/shvlogrpcvaluereader.h>
+
+#include <shv/chainpack/rpc.h>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+using namespace shv::iotqt::node;
+using namespace shv::chainpack;
+using namespace std;
+using shv::core::utils::ShvFileJournal;
+using shv::core::utils::ShvGetLogParams;
+using shv::core::utils::ShvJournalEntry;
+using shv::core::utils::ShvLogRpcValueReader;
+
+namespace {
+
+template<typename Predicate>
+bool wait_for(Predicate predicate)
+{
+	QElapsedTimer timer;
+	timer.start();
+	while(!predicate()) {
+		if(timer.elapsed() > 5000)
+			return false;
+		QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+	}
+	return true;
+}
+
+void process_events_for(int msec)
+{
+	QElapsedTimer timer;
+	timer.start();
+	while(timer.elapsed() < msec)
+		QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+}
+
+RpcRequest create_request(int request_id, const std::string &method = "foo", const RpcValue &params = {})
+{
+	RpcRequest rq;
+	rq.setRequestId(request_id);
+	rq.setShvPath("test");
+	rq.setMethod(method);
+	if(params.isValid())
+		rq.setParams(params);
+	return rq;
+}
+
+/// runs until it is cancelled
+AsyncMethodRunner::Method wait_for_cancel(std::atomic<int> &cancelled_count)
+{
+	return [&cancelled_count](const std::atomic<bool> &cancelled) {
+		while(!cancelled)
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		++cancelled_count;
+		return RpcValue();
+	};
+}
+
+const std::string JOURNAL_DIR = std::filesystem::temp_directory_path().string() + "/test_AsyncMethodRunner";
+}
+
+DOCTEST_TEST_CASE("AsyncMethodRunner")
+{
+	int argc = 1;
+	char arg0[] = "test_asyncmethodrunner";
+	char *argv[] = {arg0, nullptr};
+	QCoreApplication app(argc, argv);
+
+	AsyncMethodRunner runner;
+	runner.setMaxThreadCount(4);
+	std::vector<RpcResponse> responses;
+	QObject::connect(&runner, &AsyncMethodRunner::responseReady, [&responses](const RpcResponse &resp) {
+		responses.push_back(resp);
+	});
+	std::atomic<int> cancelled_count = 0;
+
+	DOCTEST_SUBCASE("concurrent requests")
+	{
+		static constexpr int REQUEST_COUNT = 4;
+		// every method waits until all of them are running, they cannot finish unless executed concurrently
+		std::atomic<int> running_count = 0;
+		for(int i = 1; i <= REQUEST_COUNT; ++i) {
+			runner.run(create_request(i), [i, &running_count](const std::atomic<bool> &cancelled) {
+				++running_count;
+				while(running_count < REQUEST_COUNT && !cancelled)
+					std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				return RpcValue(i * 10);
+			});
+		}
+		REQUIRE(runner.pendingCount() == REQUEST_COUNT);
+		REQUIRE(wait_for([&responses]() { return responses.size() == REQUEST_COUNT; }));
+		REQUIRE(runner.pendingCount() == 0);
+		for(const auto &resp : responses) {
+			REQUIRE(resp.isSuccess());
+			REQUIRE(resp.result().toInt() == resp.requestId().toInt() * 10);
+		}
+	}
+
+	DOCTEST_SUBCASE("method error is sent")
+	{
+		runner.run(create_request(1), [](const std::atomic<bool> &) -> RpcValue {
+			throw RpcException(RpcResponse::Error::InvalidParams, "bad params");
+		});
+		REQUIRE(wait_for([&responses]() { return !responses.empty(); }));
+		REQUIRE(responses[0].error().code() == RpcResponse::Error::InvalidParams);
+	}
+
+	DOCTEST_SUBCASE("caller disconnects")
+	{
+		auto rq1 = create_request(1);
+		rq1.setCallerIds(1);
+		auto rq2 = create_request(2);
+		rq2.setCallerIds(2);
+		runner.run(rq1, wait_for_cancel(cancelled_count));
+		runner.run(rq2, wait_for_cancel(cancelled_count));
+		runner.cancelCaller(1);
+		REQUIRE(runner.pendingCount() == 1);
+		REQUIRE(wait_for([&cancelled_count]() { return cancelled_count == 1; }));
+		runner.cancelCaller(2);
+		REQUIRE(runner.pendingCount() == 0);
+		REQUIRE(wait_for([&cancelled_count]() { return cancelled_count == 2; }));
+		process_events_for(50);
+		REQUIRE(responses.empty());
+	}
+
+	DOCTEST_SUBCASE("connection is lost")
+	{
+		for(int i = 1; i <= 3; ++i)
+			runner.run(create_request(i), wait_for_cancel(cancelled_count));
+		runner.cancelAll();
+		REQUIRE(runner.pendingCount() == 0);
+		REQUIRE(wait_for([&cancelled_count]() { return cancelled_count == 3; }));
+		process_events_for(50);
+		REQUIRE(responses.empty());
+	}
+
+	DOCTEST_SUBCASE("timeout")
+	{
+		runner.setTimeout(std::chrono::milliseconds(50));
+		runner.run(create_request(1), wait_for_cancel(cancelled_count));
+		REQUIRE(wait_for([&responses]() { return !responses.empty(); }));
+		REQUIRE(responses[0].requestId().toInt() == 1);
+		REQUIRE(responses[0].error().code() == RpcResponse::Error::MethodCallTimeout);
+		REQUIRE(wait_for([&cancelled_count]() { return cancelled_count == 1; }));
+		process_events_for(50);
+		REQUIRE(responses.size() == 1);
+	}
+
+	DOCTEST_SUBCASE("getLog")
+	{
+		std::filesystem::remove_all(JOURNAL_DIR);
+		ShvFileJournal journal;
+		journal.setJournalDir(JOURNAL_DIR);
+		journal.setFileSizeLimit(1024);
+		journal.setJournalSizeLimit(32 * 1024);
+		int64_t msec = RpcValue::DateTime::fromUtcString("2024-01-01T00:00:00Z").msecsSinceEpoch();
+		int value = 0;
+		auto append_entries = [&journal, &msec, &value](int n) {
+			for(int i = 0; i < n; ++i) {
+				msec += 1000;
+				journal.append(ShvJournalEntry("getlog/test", value++, ShvJournalEntry::DOMAIN_VAL_CHANGE, ShvJournalEntry::NO_SHORT_TIME, ShvJournalEntry::NO_VALUE_FLAGS, msec));
+			}
+		};
+		append_entries(200);
+		ShvGetLogParams params;
+		params.recordCountLimit = 100000;
+
+		DOCTEST_SUBCASE("concurrent requests while journal is written")
+		{
+			static constexpr int REQUEST_COUNT = 8;
+			for(int i = 1; i <= REQUEST_COUNT; ++i)
+				runner.runGetLog(create_request(i, Rpc::METH_GET_LOG, params.toRpcValue()), journal);
+			// files read by workers are not deleted by rotation meanwhile
+			while(responses.size() < REQUEST_COUNT) {
+				append_entries(10);
+				QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+			}
+			for(const auto &resp : responses) {
+				REQUIRE(resp.isSuccess());
+				REQUIRE(ShvLogRpcValueReader(resp.result()).logHeader().recordCount() >= 200);
+			}
+			REQUIRE(wait_for([&journal]() { return journal.activeReaderCount() == 0; }));
+			append_entries(1);
+			REQUIRE(journal.checkJournalContext().journalSize <= 32 * 1024);
+		}
+
+		DOCTEST_SUBCASE("cancelled getLog releases journal")
+		{
+			runner.runGetLog(create_request(1, Rpc::METH_GET_LOG, params.toRpcValue()), journal);
+			runner.cancelAll();
+			REQUIRE(wait_for([&journal]() { return journal.activeReaderCount() == 0; }));
+			process_events_for(50);
+			REQUIRE(responses.empty());
+		}
+	}
+
+	DOCTEST_SUBCASE("getLog from journal which cannot be read")
+	{
+		// journal dir cannot be created under regular file
+		std::filesystem::remove_all(JOURNAL_DIR);
+		std::filesystem::create_directories(JOURNAL_DIR);
+		std::ofstream(JOURNAL_DIR + "/file") << "foo";
+		ShvFileJournal journal;
+		journal.setJournalDir(JOURNAL_DIR + "/file/journal");
+		runner.runGetLog(create_request(1, Rpc::METH_GET_LOG), journal);
+		REQUIRE(responses.size() == 1);
+		REQUIRE(responses[0].error().code() == RpcResponse::Error::MethodCallException);
+		REQUIRE(journal.activeReaderCount() == 0);
+	}
+}
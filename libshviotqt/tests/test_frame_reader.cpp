@@ -180,3 +180,72 @@ DOCTEST_TEST_CASE("Serial FrameReader without CRC check")
 	}
 }
 
+
+DOCTEST_TEST_CASE("Serial FrameReader with blob frames")
+{
+	auto crc_check_wr = SerialFrameWriter::CrcCheck::Yes;
+	auto crc_check_rd = SerialFrameReader::CrcCheck::Yes;
+	RpcValue::Blob blob;
+	for (int i = 0; i < 4096; ++i) {
+		// all byte values including control ones, in runs of different length
+		blob.push_back(static_cast<uint8_t>((i * 7 + i / 13) % 256));
+	}
+	RpcRequest rq;
+	rq.setRequestId(1);
+	rq.setShvPath("shv");
+	rq.setMethod("write");
+	rq.setParams(blob);
+	const auto frame_data = rq.toRpcFrame().toFrameData();
+
+	SerialFrameWriter wr(crc_check_wr);
+	wr.addFrame(frame_data);
+	QByteArray ba;
+	{
+		QBuffer buffer(&ba);
+		buffer.open(QIODevice::WriteOnly);
+		wr.flushToDevice(&buffer);
+	}
+	const string raw_data(ba.constData(), ba.size());
+
+	DOCTEST_SUBCASE("Writer escapes all control bytes")
+	{
+		string escaped;
+		for (uint8_t b : frame_data) {
+			switch (b) {
+			case 0xA2: escaped += "\xAA\x02"; break;
+			case 0xA3: escaped += "\xAA\x03"; break;
+			case 0xA4: escaped += "\xAA\x04"; break;
+			case 0xAA: escaped += "\xAA\x0A"; break;
+			default: escaped += static_cast<char>(b); break;
+			}
+		}
+		REQUIRE(raw_data.substr(1, escaped.size()) == escaped);
+		REQUIRE(static_cast<uint8_t>(raw_data[escaped.size() + 1]) == 0xA3);
+	}
+	DOCTEST_SUBCASE("Frame split across reads")
+	{
+		for (size_t chunk_size : {1, 2, 3, 7, 8, 9, 64, 1000}) {
+			SerialFrameReader rd(crc_check_rd);
+			for (size_t pos = 0; pos < raw_data.size(); pos += chunk_size) {
+				rd.addData(std::string_view(raw_data).substr(pos, chunk_size));
+			}
+			auto frames = rd.takeFrames();
+			CAPTURE(chunk_size);
+			REQUIRE(frames.size() == 1);
+			auto msg = frames[0].toRpcMessage();
+			REQUIRE(msg.value().asBlob() == blob);
+		}
+	}
+	DOCTEST_SUBCASE("Frame after garbage")
+	{
+		auto half = raw_data.size() / 2;
+		while (static_cast<uint8_t>(raw_data[half - 1]) == 0xAA) {
+			++half;
+		}
+		SerialFrameReader rd(crc_check_rd);
+		rd.addData(raw_data.substr(0, half) + "garbage" + raw_data);
+		auto frames = rd.takeFrames();
+		REQUIRE(frames.size() == 1);
+		REQUIRE(frames[0].toRpcMessage().value().asBlob() == blob);
+	}
+}
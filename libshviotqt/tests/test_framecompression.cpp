@@ -0,0 +1,222 @@
+#include <shv/iotqt/rpc/clientconnection.h>
+#include <shv/iotqt/rpc/serverconnection.h>
+#include <shv/iotqt/rpc/socket.h>
+
+#include <shv/chainpack/accessgrant.h>
+#include <shv/chainpack/rpc.h>
+#include <shv/chainpack/rpcmessage.h>
+
+#include <QTcpSocket>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <deque>
+#include <vector>
+
+using namespace shv::iotqt::rpc;
+using namespace shv::chainpack;
+using namespace std;
+
+namespace {
+
+/// frames written by connection are kept in outbox until test delivers them to the peer,
+/// so that request id is known to sender before response is received
+class TestServerConnection : public ServerConnection
+{
+	using Super = ServerConnection;
+public:
+	TestServerConnection() : Super(new TcpSocket(new QTcpSocket())) {}
+
+	using Super::selectFrameCompression;
+	using Super::isLoginPhase;
+	using Super::processLoginPhase;
+
+	void setClientOptions(const RpcValue &options) { m_connectionOptions = options; }
+	void receiveFrameData(const std::string &frame_data) { onRpcFrameReceived(RpcFrame::fromFrameData(frame_data)); }
+
+	bool ignoreClientOptions = false;
+	std::deque<std::string> outbox;
+	std::vector<RpcFrame> writtenFrames;
+protected:
+	void writeFrameData(const std::string &frame_data) override
+	{
+		writtenFrames.push_back(RpcFrame::fromFrameData(frame_data));
+		outbox.push_back(frame_data);
+	}
+	void processLoginPhase() override
+	{
+		Super::processLoginPhase();
+		if(ignoreClientOptions)
+			m_connectionOptions = RpcValue();
+		setLoginResult(UserLoginResult(true));
+	}
+};
+
+class TestClientConnection : public ClientConnection
+{
+	using Super = ClientConnection;
+public:
+	TestClientConnection()
+	{
+		setHeartBeatInterval(0);
+		setUser("test");
+		setPassword("test");
+	}
+
+	void login()
+	{
+		setState(State::SocketConnected);
+		sendHello();
+	}
+	void receiveFrameData(const std::string &frame_data) { onRpcFrameReceived(RpcFrame::fromFrameData(frame_data)); }
+
+	std::deque<std::string> outbox;
+	std::vector<RpcFrame> writtenFrames;
+protected:
+	void writeFrameData(const std::string &frame_data) override
+	{
+		writtenFrames.push_back(RpcFrame::fromFrameData(frame_data));
+		outbox.push_back(frame_data);
+	}
+};
+
+void deliver_frames(TestClientConnection &client, TestServerConnection &server)
+{
+	while(!client.outbox.empty() || !server.outbox.empty()) {
+		if(!client.outbox.empty()) {
+			auto frame_data = client.outbox.front();
+			client.outbox.pop_front();
+			server.receiveFrameData(frame_data);
+		}
+		if(!server.outbox.empty()) {
+			auto frame_data = server.outbox.front();
+			server.outbox.pop_front();
+			client.receiveFrameData(frame_data);
+		}
+	}
+}
+
+RpcValue login_options(const TestClientConnection &client)
+{
+	for(const auto &frame : client.writtenFrames) {
+		if(auto msg = frame.toRpcMessage(); msg.method().asString() == Rpc::METH_LOGIN)
+			return RpcRequest(msg).params().asMap().value(Rpc::KEY_OPTIONS);
+	}
+	return {};
+}
+
+RpcValue login_result(const TestServerConnection &server)
+{
+	REQUIRE(!server.writtenFrames.empty());
+	const auto &frame = server.writtenFrames.back();
+	// login response itself is sent uncompressed
+	REQUIRE(frame.compression() == RpcFrame::Compression::None);
+	return RpcResponse(frame.toRpcMessage()).result();
+}
+}
+
+DOCTEST_TEST_CASE("ServerConnection selectFrameCompression")
+{
+	TestServerConnection server;
+	REQUIRE(server.selectFrameCompression() == RpcFrame::Compression::None);
+
+	server.setClientOptions(RpcValue::Map{{Rpc::OPT_COMPRESSION, "deflate"}});
+	REQUIRE(server.selectFrameCompression() == RpcFrame::Compression::None);
+
+	server.setClientOptions(RpcValue::Map{{Rpc::OPT_COMPRESSION, RpcValue::List{"foo"}}});
+	REQUIRE(server.selectFrameCompression() == RpcFrame::Compression::None);
+
+	server.setClientOptions(RpcValue::Map{{Rpc::OPT_COMPRESSION, RpcValue::List{"foo", "deflate"}}});
+	const auto expected = RpcFrame::isCompressionSupported(RpcFrame::Compression::Deflate)? RpcFrame::Compression::Deflate: RpcFrame::Compression::None;
+	REQUIRE(server.selectFrameCompression() == expected);
+}
+
+DOCTEST_TEST_CASE("Frame compression login negotiation")
+{
+	TestClientConnection client;
+	TestServerConnection server;
+
+	if (!RpcFrame::isCompressionSupported(RpcFrame::Compression::Deflate)) {
+		client.setFrameCompressionEnabled(true);
+		client.login();
+		deliver_frames(client, server);
+		REQUIRE(client.isBrokerConnected());
+		REQUIRE(!login_options(client).asMap().hasKey(Rpc::OPT_COMPRESSION));
+		REQUIRE(client.frameCompression() == RpcFrame::Compression::None);
+		REQUIRE(server.frameCompression() == RpcFrame::Compression::None);
+		return;
+	}
+
+	DOCTEST_SUBCASE("both peers enable compression")
+	{
+		client.setFrameCompressionEnabled(true);
+		client.login();
+		deliver_frames(client, server);
+		REQUIRE(client.isBrokerConnected());
+		REQUIRE(server.isLoginPhase() == false);
+		REQUIRE(login_options(client).asMap().value(Rpc::OPT_COMPRESSION) == RpcValue(RpcValue::List{"deflate"}));
+		REQUIRE(login_result(server).asMap().value(Rpc::OPT_COMPRESSION).asString() == "deflate");
+		REQUIRE(client.frameCompression() == RpcFrame::Compression::Deflate);
+		REQUIRE(server.frameCompression() == RpcFrame::Compression::Deflate);
+
+		RpcValue received_params;
+		QObject::connect(&server, &ServerConnection::rpcMessageReceived, [&received_params](const RpcMessage &msg) {
+			received_params = msg.params();
+		});
+		const RpcValue params = RpcValue::String(10000, 'x');
+		client.callShvMethod("test", "foo", params);
+		REQUIRE(client.writtenFrames.back().compression() == RpcFrame::Compression::Deflate);
+		deliver_frames(client, server);
+		REQUIRE(received_params == params);
+
+		server.sendResponse(1, RpcValue::String(10, 'x'));
+		REQUIRE(server.writtenFrames.back().compression() == RpcFrame::Compression::None);
+	}
+
+	DOCTEST_SUBCASE("client does not enable compression")
+	{
+		client.login();
+		deliver_frames(client, server);
+		REQUIRE(client.isBrokerConnected());
+		REQUIRE(!login_options(client).asMap().hasKey(Rpc::OPT_COMPRESSION));
+		REQUIRE(!login_result(server).asMap().hasKey(Rpc::OPT_COMPRESSION));
+		REQUIRE(client.frameCompression() == RpcFrame::Compression::None);
+		REQUIRE(server.frameCompression() == RpcFrame::Compression::None);
+
+		server.sendResponse(1, RpcValue::String(10000, 'x'));
+		REQUIRE(server.writtenFrames.back().compression() == RpcFrame::Compression::None);
+	}
+
+	DOCTEST_SUBCASE("server does not accept compression")
+	{
+		server.ignoreClientOptions = true;
+		client.setFrameCompressionEnabled(true);
+		client.login();
+		deliver_frames(client, server);
+		REQUIRE(client.isBrokerConnected());
+		REQUIRE(login_options(client).asMap().hasKey(Rpc::OPT_COMPRESSION));
+		REQUIRE(!login_result(server).asMap().hasKey(Rpc::OPT_COMPRESSION));
+		REQUIRE(client.frameCompression() == RpcFrame::Compression::None);
+		REQUIRE(server.frameCompression() == RpcFrame::Compression::None);
+
+		client.callShvMethod("test", "foo", RpcValue::String(10000, 'x'));
+		REQUIRE(client.writtenFrames.back().compression() == RpcFrame::Compression::None);
+	}
+
+	DOCTEST_SUBCASE("compression is negotiated again on next login")
+	{
+		client.setFrameCompressionEnabled(true);
+		client.login();
+		deliver_frames(client, server);
+		REQUIRE(client.frameCompression() == RpcFrame::Compression::Deflate);
+
+		TestServerConnection server2;
+		server2.ignoreClientOptions = true;
+		client.login();
+		REQUIRE(client.frameCompression() == RpcFrame::Compression::None);
+		deliver_frames(client, server2);
+		REQUIRE(client.isBrokerConnected());
+		REQUIRE(client.frameCompression() == RpcFrame::Compression::None);
+	}
+}
@@ -0,0 +1,105 @@
+#include <shv/iotqt/node/localfsnode.h>
+
+#include <QCryptographicHash>
+#include <QFile>
+#include <QTemporaryDir>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+using namespace shv::iotqt::node;
+using namespace shv::chainpack;
+using namespace std;
+
+namespace {
+constexpr qint64 SPARSE_FILE_SIZE = 5LL * 1024 * 1024 * 1024;
+constexpr qint64 MARKER_OFFSET = 4LL * 1024 * 1024 * 1024 + 123;
+const QByteArray MARKER = "libshv sparse file marker";
+}
+
+DOCTEST_TEST_CASE("LocalFSNode sparse file")
+{
+	QTemporaryDir dir;
+	REQUIRE(dir.isValid());
+	{
+		QFile f(dir.filePath("sparse.bin"));
+		REQUIRE(f.open(QFile::WriteOnly));
+		REQUIRE(f.resize(SPARSE_FILE_SIZE));
+		REQUIRE(f.seek(MARKER_OFFSET));
+		REQUIRE(f.write(MARKER) == MARKER.size());
+	}
+	LocalFSNode nd(dir.path());
+	const ShvNode::StringViewList file_path{"sparse.bin"};
+
+	DOCTEST_SUBCASE("size is taken from metadata")
+	{
+		REQUIRE(nd.callMethod(file_path, "size", {}, {}).toUInt64() == static_cast<uint64_t>(SPARSE_FILE_SIZE));
+	}
+
+	DOCTEST_SUBCASE("read is bounded")
+	{
+		auto blob = nd.callMethod(file_path, "read", RpcValue::Map{{"size", 2 * FileNode::MAX_READ_SIZE}}, {}).asBlob();
+		REQUIRE(blob.size() == static_cast<size_t>(FileNode::MAX_READ_SIZE));
+		// whole file is never truncated silently
+		REQUIRE_THROWS(nd.callMethod(file_path, "read", {}, {}));
+		REQUIRE_THROWS(nd.callMethod(file_path, "readCompressed", {}, {}));
+	}
+
+	DOCTEST_SUBCASE("read past 4GB")
+	{
+		auto blob = nd.callMethod(file_path, "read", RpcValue::Map{{"offset", MARKER_OFFSET}, {"size", MARKER.size()}}, {}).asBlob();
+		REQUIRE(QByteArray(reinterpret_cast<const char*>(blob.data()), static_cast<int>(blob.size())) == MARKER);
+	}
+
+	DOCTEST_SUBCASE("hash over multiple chunks")
+	{
+		const qint64 offset = MARKER_OFFSET - 3 * FileNode::READ_CHUNK_SIZE / 2;
+		const qint64 size = 3 * FileNode::READ_CHUNK_SIZE;
+		QFile f(dir.filePath("sparse.bin"));
+		REQUIRE(f.open(QFile::ReadOnly));
+		REQUIRE(f.seek(offset));
+		const auto expected = QCryptographicHash::hash(f.read(size), QCryptographicHash::Sha1).toHex().toStdString();
+		REQUIRE(nd.callMethod(file_path, "hash", RpcValue::Map{{"offset", offset}, {"size", size}}, {}).asString() == expected);
+	}
+
+}
+
+DOCTEST_TEST_CASE("LocalFSNode sizeCompressed")
+{
+	QTemporaryDir dir;
+	REQUIRE(dir.isValid());
+	const qint64 file_size = 2 * FileNode::MAX_READ_SIZE + 1000;
+	{
+		QFile f(dir.filePath("big.bin"));
+		REQUIRE(f.open(QFile::WriteOnly));
+		QByteArray data;
+		for(qint64 i = 0; i < file_size; ++i)
+			data.append(static_cast<char>((i * 7919) % 251));
+		REQUIRE(f.write(data) == file_size);
+	}
+	{
+		QFile f(dir.filePath("small.bin"));
+		REQUIRE(f.open(QFile::WriteOnly));
+		REQUIRE(f.write("small file content") > 0);
+	}
+	LocalFSNode nd(dir.path());
+
+	DOCTEST_SUBCASE("small file")
+	{
+		const ShvNode::StringViewList file_path{"small.bin"};
+		for(const auto &type : {"gzip", "qcompress"}) {
+			const RpcValue::Map params{{"compressionType", type}};
+			REQUIRE(nd.callMethod(file_path, "sizeCompressed", params, {}).toUInt64() == nd.callMethod(file_path, "readCompressed", params, {}).asBlob().size());
+		}
+	}
+
+	DOCTEST_SUBCASE("whole big file")
+	{
+		const ShvNode::StringViewList file_path{"big.bin"};
+		uint64_t chunks_size = 0;
+		for(qint64 offset = 0; offset < file_size; offset += FileNode::MAX_READ_SIZE) {
+			chunks_size += nd.callMethod(file_path, "readCompressed", RpcValue::Map{{"offset", offset}, {"size", FileNode::MAX_READ_SIZE}}, {}).asBlob().size();
+		}
+		REQUIRE(nd.callMethod(file_path, "sizeCompressed", {}, {}).toUInt64() == chunks_size);
+	}
+}
@@ -0,0 +1,221 @@
+#include <shv/iotqt/rpc/rpccall.h>
+#include <shv/iotqt/rpc/clientconnection.h>
+
+#include <shv/chainpack/rpcmessage.h>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <map>
+#include <vector>
+
+using namespace shv::iotqt::rpc;
+using namespace shv::chainpack;
+using namespace std;
+
+namespace {
+
+template<typename Predicate>
+bool wait_for(Predicate predicate)
+{
+	QElapsedTimer timer;
+	timer.start();
+	while(!predicate()) {
+		if(timer.elapsed() > 5000)
+			return false;
+		QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+	}
+	return true;
+}
+
+void process_events_for(int msec)
+{
+	QElapsedTimer timer;
+	timer.start();
+	while(timer.elapsed() < msec)
+		QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+}
+
+/// connection without socket, requests written by it are kept and responses are injected by test
+class TestClientConnection : public ClientConnection
+{
+public:
+	TestClientConnection()
+	{
+		setHeartBeatInterval(0);
+	}
+
+	void setBrokerConnected() { setState(State::BrokerConnected); }
+	void receiveResponse(const RpcResponse &resp) { onRpcMessageReceived(resp); }
+	RpcResponse responseFor(size_t request_index) const
+	{
+		RpcResponse resp;
+		resp.setRequestId(sentRequests.at(request_index).requestId());
+		return resp;
+	}
+
+	std::vector<RpcRequest> sentRequests;
+protected:
+	void writeFrameData(const std::string &frame_data) override
+	{
+		sentRequests.emplace_back(RpcFrame::fromFrameData(frame_data).toRpcMessage());
+	}
+};
+
+struct BatchResult
+{
+	/// item index -> number of itemFinished signals
+	std::map<int, int> itemFinishedCount;
+	std::map<int, RpcValue> results;
+	std::map<int, RpcError> errors;
+	int finishedCount = 0;
+};
+
+RpcCallBatch* create_batch(ClientConnection *conn, size_t call_count, BatchResult &batch_result)
+{
+	auto *batch = RpcCallBatch::create(conn);
+	for(size_t i = 0; i < call_count; ++i)
+		REQUIRE(batch->addCall("test/node" + std::to_string(i), "get") == static_cast<int>(i));
+	QObject::connect(batch, &RpcCallBatch::itemFinished, [&batch_result](int index, const RpcValue &result, const RpcError &error) {
+		batch_result.itemFinishedCount[index]++;
+		batch_result.results[index] = result;
+		batch_result.errors[index] = error;
+	});
+	QObject::connect(batch, &RpcCallBatch::finished, [&batch_result]() {
+		batch_result.finishedCount++;
+	});
+	return batch;
+}
+
+void require_each_item_finished_once(const BatchResult &batch_result, size_t call_count)
+{
+	REQUIRE(batch_result.itemFinishedCount.size() == call_count);
+	for(const auto &[index, count] : batch_result.itemFinishedCount)
+		REQUIRE(count == 1);
+	REQUIRE(batch_result.finishedCount == 1);
+}
+}
+
+DOCTEST_TEST_CASE("RpcCallBatch")
+{
+	int argc = 1;
+	char arg0[] = "test_rpccallbatch";
+	char *argv[] = {arg0, nullptr};
+	QCoreApplication app(argc, argv);
+
+	TestClientConnection conn;
+	BatchResult batch_result;
+	static constexpr size_t CALL_COUNT = 3;
+
+	DOCTEST_SUBCASE("responses are matched by request id")
+	{
+		conn.setBrokerConnected();
+		auto *batch = create_batch(&conn, CALL_COUNT, batch_result);
+		batch->start();
+		// repeated start does not send requests again
+		batch->start();
+		REQUIRE(conn.sentRequests.size() == CALL_COUNT);
+		for(size_t i = 0; i < CALL_COUNT; ++i)
+			REQUIRE(conn.sentRequests[i].shvPath().asString() == "test/node" + std::to_string(i));
+
+		// response for other caller with the same request id belongs to somebody else
+		auto foreign_resp = conn.responseFor(0);
+		foreign_resp.setCallerIds(5);
+		foreign_resp.setResult("foreign");
+		conn.receiveResponse(foreign_resp);
+		REQUIRE(batch_result.itemFinishedCount.empty());
+
+		// responses come in other order than requests were sent, one of them is error
+		auto resp2 = conn.responseFor(2);
+		resp2.setResult(2);
+		conn.receiveResponse(resp2);
+		auto resp1 = conn.responseFor(1);
+		resp1.setError(RpcResponse::Error::create(RpcResponse::Error::MethodNotFound, "no such method"));
+		conn.receiveResponse(resp1);
+		REQUIRE(batch_result.finishedCount == 0);
+		auto resp0 = conn.responseFor(0);
+		resp0.setResult(0);
+		conn.receiveResponse(resp0);
+		// duplicate response is ignored
+		conn.receiveResponse(resp0);
+
+		require_each_item_finished_once(batch_result, CALL_COUNT);
+		REQUIRE(batch_result.results[0] == RpcValue(0));
+		REQUIRE(!batch_result.errors[0].isValid());
+		REQUIRE(!batch_result.results[1].isValid());
+		REQUIRE(batch_result.errors[1].code() == RpcResponse::Error::MethodNotFound);
+		REQUIRE(batch_result.results[2] == RpcValue(2));
+		REQUIRE(!batch_result.errors[2].isValid());
+	}
+
+	DOCTEST_SUBCASE("timeout is restarted when response is being received")
+	{
+		conn.setBrokerConnected();
+		auto *batch = create_batch(&conn, CALL_COUNT, batch_result);
+		batch->setTimeout(200);
+		batch->start();
+		const auto rq_id = conn.sentRequests.at(0).requestId().toInt();
+		// batch would time out without response meta notifications
+		for(int i = 0; i < 8; ++i) {
+			process_events_for(50);
+			emit conn.responseMetaReceived(rq_id);
+		}
+		REQUIRE(batch_result.finishedCount == 0);
+		auto resp0 = conn.responseFor(0);
+		resp0.setResult(0);
+		conn.receiveResponse(resp0);
+		REQUIRE(wait_for([&batch_result]() { return batch_result.finishedCount > 0; }));
+		require_each_item_finished_once(batch_result, CALL_COUNT);
+		REQUIRE(batch_result.results[0] == RpcValue(0));
+		REQUIRE(batch_result.errors[1].code() == RpcResponse::Error::MethodCallTimeout);
+		REQUIRE(batch_result.errors[2].code() == RpcResponse::Error::MethodCallTimeout);
+	}
+
+	DOCTEST_SUBCASE("abort before start")
+	{
+		conn.setBrokerConnected();
+		auto *batch = create_batch(&conn, CALL_COUNT, batch_result);
+		batch->abort();
+		batch->start();
+		REQUIRE(conn.sentRequests.empty());
+		require_each_item_finished_once(batch_result, CALL_COUNT);
+		for(const auto &[index, error] : batch_result.errors)
+			REQUIRE(error.code() == RpcResponse::Error::MethodCallCancelled);
+	}
+
+	DOCTEST_SUBCASE("abort after start")
+	{
+		conn.setBrokerConnected();
+		auto *batch = create_batch(&conn, CALL_COUNT, batch_result);
+		batch->start();
+		REQUIRE(conn.sentRequests.size() == CALL_COUNT);
+		auto resp0 = conn.responseFor(0);
+		resp0.setResult(0);
+		conn.receiveResponse(resp0);
+		batch->abort();
+		// late response is ignored
+		auto resp1 = conn.responseFor(1);
+		resp1.setResult(1);
+		conn.receiveResponse(resp1);
+		require_each_item_finished_once(batch_result, CALL_COUNT);
+		REQUIRE(batch_result.results[0] == RpcValue(0));
+		REQUIRE(batch_result.errors[1].code() == RpcResponse::Error::MethodCallCancelled);
+		REQUIRE(batch_result.errors[2].code() == RpcResponse::Error::MethodCallCancelled);
+	}
+
+	DOCTEST_SUBCASE("start on disconnected connection")
+	{
+		auto *batch = create_batch(&conn, CALL_COUNT, batch_result);
+		batch->start();
+		REQUIRE(conn.sentRequests.empty());
+		require_each_item_finished_once(batch_result, CALL_COUNT);
+		for(const auto &[index, error] : batch_result.errors)
+			REQUIRE(error.isValid());
+	}
+
+	// let deleteLater() of finished batch happen while connection exists
+	process_events_for(10);
+}
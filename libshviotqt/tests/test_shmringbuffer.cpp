@@ -0,0 +1,140 @@
+#include <shv/iotqt/rpc/shmringbuffer.h>
+#include <shv/core/exception.h>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace shv::iotqt::rpc;
+using namespace std;
+
+namespace {
+constexpr size_t CAPACITY = 16;
+
+struct Memory
+{
+	explicit Memory(size_t size) : data(new (std::align_val_t(64)) char[size]) {}
+	~Memory() { ::operator delete[](data, std::align_val_t(64)); }
+	char *data;
+};
+
+// ring header layout: magic, capacity, head and tail each on its own cache line
+constexpr size_t CAPACITY_OFFSET = 4;
+constexpr size_t HEAD_OFFSET = 64;
+constexpr size_t TAIL_OFFSET = 128;
+
+void set_header_field(const Memory &mem, size_t offset, uint32_t val)
+{
+	std::memcpy(mem.data + offset, &val, sizeof(val));
+}
+}
+
+DOCTEST_TEST_CASE("ShmRingBuffer")
+{
+	Memory mem(ShmRingBuffer::requiredMemorySize(CAPACITY));
+	auto producer = ShmRingBuffer::create(mem.data, CAPACITY);
+	auto consumer = ShmRingBuffer::attach(mem.data, ShmRingBuffer::requiredMemorySize(CAPACITY));
+	REQUIRE(consumer.capacity() == CAPACITY);
+
+	DOCTEST_SUBCASE("invalid memory")
+	{
+		Memory other(ShmRingBuffer::requiredMemorySize(CAPACITY));
+		std::fill_n(other.data, ShmRingBuffer::requiredMemorySize(CAPACITY), 0);
+		REQUIRE_THROWS_AS(ShmRingBuffer::attach(other.data, ShmRingBuffer::requiredMemorySize(CAPACITY)), shv::core::Exception);
+		REQUIRE_THROWS_AS(ShmRingBuffer::attach(mem.data, ShmRingBuffer::requiredMemorySize(CAPACITY) - 1), shv::core::Exception);
+		REQUIRE_THROWS_AS(ShmRingBuffer::create(other.data, 10), shv::core::Exception);
+	}
+
+	DOCTEST_SUBCASE("write wraps around")
+	{
+		std::string buff(CAPACITY, '\0');
+		REQUIRE(producer.write("0123456789") == 10);
+		REQUIRE(consumer.read(buff.data(), 6) == 6);
+		REQUIRE(buff.substr(0, 6) == "012345");
+		REQUIRE(producer.writableSize() == 12);
+		REQUIRE(producer.write("abcdefghijklmnopq") == 12);
+		REQUIRE(producer.writableSize() == 0);
+		REQUIRE(consumer.readableSize() == CAPACITY);
+		REQUIRE(consumer.read(buff.data(), buff.size()) == CAPACITY);
+		REQUIRE(buff == "6789abcdefghijkl");
+		REQUIRE(consumer.read(buff.data(), buff.size()) == 0);
+	}
+
+	DOCTEST_SUBCASE("waiting flags")
+	{
+		// consumer is sleeping after buffer is created
+		REQUIRE(producer.takeReaderWaiting() == true);
+		REQUIRE(producer.takeReaderWaiting() == false);
+		REQUIRE(consumer.setReaderWaiting() == true);
+		producer.write("x");
+		REQUIRE(producer.takeReaderWaiting() == true);
+		REQUIRE(producer.takeReaderWaiting() == false);
+		REQUIRE(consumer.setReaderWaiting() == false);
+
+		producer.write(std::string(CAPACITY - 2, 'x'));
+		REQUIRE(producer.setWriterWaiting(1) == false);
+		REQUIRE(producer.setWriterWaiting(2) == true);
+		char c;
+		consumer.read(&c, 1);
+		REQUIRE(consumer.takeWriterWaiting() == true);
+		REQUIRE(consumer.takeWriterWaiting() == false);
+	}
+
+	DOCTEST_SUBCASE("tampered header")
+	{
+		std::string buff(CAPACITY, '\0');
+		producer.write("0123");
+
+		DOCTEST_SUBCASE("capacity is cached on attach")
+		{
+			set_header_field(mem, CAPACITY_OFFSET, 1u << 30);
+			REQUIRE(consumer.capacity() == CAPACITY);
+			REQUIRE(producer.write(std::string(CAPACITY, 'x')) == CAPACITY - 4);
+			REQUIRE(consumer.readableSize() == CAPACITY);
+			REQUIRE(consumer.read(buff.data(), buff.size()) == CAPACITY);
+		}
+
+		DOCTEST_SUBCASE("head is moved beyond capacity")
+		{
+			set_header_field(mem, HEAD_OFFSET, CAPACITY + 1);
+			REQUIRE_THROWS_AS(consumer.readableSize(), shv::core::Exception);
+			REQUIRE_THROWS_AS(consumer.read(buff.data(), buff.size()), shv::core::Exception);
+			REQUIRE_THROWS_AS(producer.writableSize(), shv::core::Exception);
+			REQUIRE_THROWS_AS(producer.write("x"), shv::core::Exception);
+			REQUIRE_THROWS_AS(consumer.setReaderWaiting(), shv::core::Exception);
+		}
+
+		DOCTEST_SUBCASE("tail is moved ahead of head")
+		{
+			set_header_field(mem, TAIL_OFFSET, 5);
+			REQUIRE_THROWS_AS(consumer.read(buff.data(), buff.size()), shv::core::Exception);
+			REQUIRE_THROWS_AS(producer.write("x"), shv::core::Exception);
+			REQUIRE_THROWS_AS(producer.setWriterWaiting(), shv::core::Exception);
+		}
+	}
+
+	DOCTEST_SUBCASE("concurrent producer and consumer")
+	{
+		static constexpr size_t DATA_SIZE = 100000;
+		std::string sent;
+		for(size_t i = 0; i < DATA_SIZE; ++i)
+			sent += static_cast<char>('a' + i % 26);
+		std::thread producer_thread([&producer, &sent]() {
+			for(size_t pos = 0; pos < sent.size(); ) {
+				pos += producer.write(std::string_view(sent).substr(pos, 7));
+			}
+		});
+		std::string received;
+		char buff[5];
+		while(received.size() < DATA_SIZE) {
+			auto n = consumer.read(buff, sizeof(buff));
+			received.append(buff, n);
+		}
+		producer_thread.join();
+		REQUIRE(received == sent);
+	}
+}
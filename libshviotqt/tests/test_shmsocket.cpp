@@ -0,0 +1,232 @@
+#include <shv/iotqt/rpc/shmsocket.h>
+#include <shv/iotqt/rpc/shmringbuffer.h>
+
+#include <shv/core/exception.h>
+#include <shv/chainpack/rpcmessage.h>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QUrl>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace shv::iotqt::rpc;
+using namespace shv::chainpack;
+using namespace std;
+
+namespace {
+
+template<typename Predicate>
+bool wait_for(Predicate predicate)
+{
+	QElapsedTimer timer;
+	timer.start();
+	while(!predicate()) {
+		if(timer.elapsed() > 5000)
+			return false;
+		QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+	}
+	return true;
+}
+
+std::string request_frame_data(int request_id, const RpcValue &params)
+{
+	RpcRequest rq;
+	rq.setRequestId(request_id);
+	rq.setShvPath("test");
+	rq.setMethod("echo");
+	rq.setParams(params);
+	return rq.toRpcFrame().toFrameData();
+}
+
+class TestServer
+{
+public:
+	TestServer()
+		: m_serverName("test_shmsocket_" + QString::number(QCoreApplication::applicationPid()))
+	{
+		QLocalServer::removeServer(m_serverName);
+		REQUIRE(m_server.listen(m_serverName));
+		QObject::connect(&m_server, &QLocalServer::newConnection, [this]() {
+			socket = std::make_unique<ShmSocket>(m_server.nextPendingConnection(), ShmSocket::Role::Server);
+			QObject::connect(socket.get(), &Socket::error, [this](QAbstractSocket::SocketError socket_error) {
+				errors.push_back(socket_error);
+			});
+		});
+	}
+	QString fullServerName() const { return m_server.fullServerName(); }
+	bool hasError(QAbstractSocket::SocketError socket_error) const
+	{
+		return std::find(errors.begin(), errors.end(), socket_error) != errors.end();
+	}
+
+	std::unique_ptr<ShmSocket> socket;
+	std::vector<QAbstractSocket::SocketError> errors;
+private:
+	QString m_serverName;
+	QLocalServer m_server;
+};
+
+/// client which does not use ShmSocket, it can write anything to the segment
+class RawShmClient
+{
+public:
+	static constexpr size_t RING_CAPACITY = 4096;
+
+	RawShmClient()
+		: m_segmentName("/shv-test-" + std::to_string(::getpid()))
+	{
+		// keep second ring header cache line aligned as ShmSocket does
+		m_ringSize = (ShmRingBuffer::requiredMemorySize(RING_CAPACITY) + 63) / 64 * 64;
+		int fd = ::shm_open(m_segmentName.c_str(), O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
+		REQUIRE(fd >= 0);
+		REQUIRE(::ftruncate(fd, static_cast<off_t>(2 * m_ringSize)) == 0);
+		m_segment = ::mmap(nullptr, 2 * m_ringSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		::close(fd);
+		REQUIRE(m_segment != MAP_FAILED);
+		txRing = ShmRingBuffer::create(m_segment, RING_CAPACITY);
+		ShmRingBuffer::create(static_cast<char*>(m_segment) + m_ringSize, RING_CAPACITY);
+	}
+	~RawShmClient()
+	{
+		::munmap(m_segment, 2 * m_ringSize);
+		::shm_unlink(m_segmentName.c_str());
+	}
+
+	void connectToServer(const QString &server_name)
+	{
+		socket.connectToServer(server_name);
+		REQUIRE(socket.waitForConnected());
+		socket.write((m_segmentName + '\n').c_str());
+		socket.flush();
+	}
+	void setTxHead(uint32_t head)
+	{
+		// head index is on the second cache line of ring header
+		std::memcpy(static_cast<char*>(m_segment) + 64, &head, sizeof(head));
+	}
+
+	QLocalSocket socket;
+	ShmRingBuffer txRing;
+private:
+	std::string m_segmentName;
+	size_t m_ringSize = 0;
+	void *m_segment = nullptr;
+};
+}
+
+DOCTEST_TEST_CASE("ShmSocket")
+{
+	int argc = 1;
+	char arg0[] = "test_shmsocket";
+	char *argv[] = {arg0, nullptr};
+	QCoreApplication app(argc, argv);
+	TestServer server;
+
+	DOCTEST_SUBCASE("frames round trip")
+	{
+		ShmSocket client(new QLocalSocket(), ShmSocket::Role::Client);
+		client.connectToHost(QUrl::fromLocalFile(server.fullServerName()));
+		REQUIRE(wait_for([&]() { return client.state() == QAbstractSocket::ConnectedState; }));
+		REQUIRE(wait_for([&]() { return server.socket && server.socket->state() == QAbstractSocket::ConnectedState; }));
+
+		// frame bigger than ring has to be passed in more chunks
+		const std::vector<RpcValue> sent_params{"foo", RpcValue::String(3 * ShmSocket::DEFAULT_RING_CAPACITY, 'x'), 42};
+		for(size_t i = 0; i < sent_params.size(); ++i)
+			client.writeFrameData(request_frame_data(static_cast<int>(i + 1), sent_params[i]));
+		std::vector<RpcFrame> received;
+		REQUIRE(wait_for([&]() {
+			for(auto &frame : server.socket->takeFrames())
+				received.push_back(std::move(frame));
+			return received.size() == sent_params.size();
+		}));
+		for(size_t i = 0; i < sent_params.size(); ++i) {
+			const auto msg = received[i].toRpcMessage();
+			REQUIRE(msg.requestId().toInt() == static_cast<int>(i + 1));
+			REQUIRE(msg.params() == sent_params[i]);
+		}
+
+		RpcResponse resp;
+		resp.setRequestId(1);
+		resp.setResult("bar");
+		int response_request_id = 0;
+		QObject::connect(&client, &Socket::responseMetaReceived, [&response_request_id](int request_id) {
+			response_request_id = request_id;
+		});
+		server.socket->writeFrameData(resp.toRpcFrame().toFrameData());
+		std::vector<RpcFrame> client_received;
+		REQUIRE(wait_for([&]() {
+			client_received = client.takeFrames();
+			return !client_received.empty();
+		}));
+		REQUIRE(response_request_id == 1);
+		REQUIRE(RpcResponse(client_received[0].toRpcMessage()).result() == RpcValue("bar"));
+		REQUIRE(server.errors.empty());
+	}
+
+	DOCTEST_SUBCASE("oversized frame is refused by sender")
+	{
+		ShmSocket client(new QLocalSocket(), ShmSocket::Role::Client);
+		client.connectToHost(QUrl::fromLocalFile(server.fullServerName()));
+		REQUIRE(wait_for([&]() { return client.state() == QAbstractSocket::ConnectedState; }));
+		REQUIRE(wait_for([&]() { return server.socket && server.socket->state() == QAbstractSocket::ConnectedState; }));
+
+		REQUIRE_THROWS_AS(client.writeFrameData(std::string(ShmSocket::MAX_FRAME_SIZE + 1, 'x')), shv::core::Exception);
+		// nothing was written to ring, connection is still usable
+		client.writeFrameData(request_frame_data(1, "foo"));
+		std::vector<RpcFrame> received;
+		REQUIRE(wait_for([&]() {
+			received = server.socket->takeFrames();
+			return !received.empty();
+		}));
+		REQUIRE(received.size() == 1);
+		REQUIRE(received[0].toRpcMessage().params() == RpcValue("foo"));
+		REQUIRE(client.state() == QAbstractSocket::ConnectedState);
+		REQUIRE(server.errors.empty());
+	}
+
+	DOCTEST_SUBCASE("invalid segment name is refused")
+	{
+		QLocalSocket client;
+		client.connectToServer(server.fullServerName());
+		REQUIRE(client.waitForConnected());
+		client.write("/foo\n");
+		client.flush();
+		REQUIRE(wait_for([&]() { return server.hasError(QAbstractSocket::SocketResourceError); }));
+		REQUIRE(server.socket->state() == QAbstractSocket::UnconnectedState);
+	}
+
+	DOCTEST_SUBCASE("oversized frame drops connection")
+	{
+		RawShmClient client;
+		const auto len = static_cast<uint32_t>(ShmSocket::MAX_FRAME_SIZE + 1);
+		client.txRing.write(std::string_view(reinterpret_cast<const char*>(&len), sizeof(len)));
+		client.connectToServer(server.fullServerName());
+		REQUIRE(wait_for([&]() { return server.hasError(QAbstractSocket::SocketResourceError); }));
+		REQUIRE(server.socket->state() == QAbstractSocket::UnconnectedState);
+		REQUIRE(wait_for([&]() { return client.socket.state() == QLocalSocket::UnconnectedState; }));
+	}
+
+	DOCTEST_SUBCASE("tampered ring header drops connection")
+	{
+		RawShmClient client;
+		client.setTxHead(RawShmClient::RING_CAPACITY + 10);
+		client.connectToServer(server.fullServerName());
+		REQUIRE(wait_for([&]() { return server.hasError(QAbstractSocket::SocketResourceError); }));
+		REQUIRE(server.socket->state() == QAbstractSocket::UnconnectedState);
+		REQUIRE(wait_for([&]() { return client.socket.state() == QLocalSocket::UnconnectedState; }));
+	}
+}
@@ -0,0 +1,252 @@
+#include <shv/iotqt/node/shvnode.h>
+#include <shv/chainpack/rpc.h>
+
+#include <QCoreApplication>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+using namespace shv::iotqt::node;
+using namespace shv::chainpack;
+using namespace std;
+
+namespace {
+const std::vector<MetaMethod> test_methods {
+	methods::DIR,
+	methods::LS,
+	{Rpc::METH_GET, MetaMethod::Flag::IsGetter, "", "RpcValue", AccessLevel::Read},
+};
+
+const std::vector<MetaMethod> other_test_methods {
+	methods::DIR,
+	methods::LS,
+	{Rpc::METH_SET, MetaMethod::Flag::IsSetter, "RpcValue", "Bool", AccessLevel::Write},
+	{Rpc::METH_GET, MetaMethod::Flag::IsGetter, "", "RpcValue", AccessLevel::Read},
+};
+
+class SwitchableMethodsNode : public MethodsTableNode
+{
+	using Super = MethodsTableNode;
+public:
+	using Super::Super;
+	void setMethods(const std::vector<MetaMethod> *methods) { m_methods = methods; }
+};
+
+/// serves children created on first access
+class LazyNode : public ShvNode
+{
+	using Super = ShvNode;
+public:
+	using Super::Super;
+	ShvNode* childNode(const String &name, bool throw_exc = true) const override
+	{
+		if(name == "lazy" && !findChildNode(name))
+			new MethodsTableNode(name, &test_methods, const_cast<LazyNode*>(this));
+		return Super::childNode(name, throw_exc);
+	}
+};
+
+/// intercepts frames for its subtree
+class InterceptingNode : public ShvNode
+{
+	using Super = ShvNode;
+public:
+	using Super::Super;
+	void handleRpcFrame(RpcFrame &&frame) override
+	{
+		interceptedPaths.push_back(RpcMessage::shvPath(frame.meta).asString());
+		Super::handleRpcFrame(std::move(frame));
+	}
+	std::vector<std::string> interceptedPaths;
+};
+}
+
+DOCTEST_TEST_CASE("ShvNode child index")
+{
+	// without application instance QChildEvent is not delivered,
+	// the index must be invalidated by ShvNode child mutation paths themselves
+	REQUIRE(QCoreApplication::instance() == nullptr);
+	ShvRootNode root(nullptr);
+	auto *b = new ShvNode("b", &root);
+	auto *a = new ShvNode("a", &root);
+	auto *c = new ShvNode("c", a);
+
+	REQUIRE(root.childNode("a", false) == a);
+	REQUIRE(root.childNode("b", false) == b);
+	REQUIRE(root.childNode("c", false) == nullptr);
+	REQUIRE(a->childNode("c", false) == c);
+	REQUIRE_THROWS(root.childNode("x"));
+	REQUIRE(root.childNames() == ShvNode::StringList{"a", "b"});
+
+	DOCTEST_SUBCASE("node added")
+	{
+		auto *d = new ShvNode("d", &root);
+		REQUIRE(root.childNode("d", false) == d);
+		REQUIRE(root.childNames() == ShvNode::StringList{"a", "b", "d"});
+	}
+
+	DOCTEST_SUBCASE("node renamed")
+	{
+		b->setNodeId("x");
+		REQUIRE(root.childNode("b", false) == nullptr);
+		REQUIRE(root.childNode("x", false) == b);
+		REQUIRE(root.childNames() == ShvNode::StringList{"a", "x"});
+	}
+
+	DOCTEST_SUBCASE("node deleted")
+	{
+		delete b;
+		REQUIRE(root.childNode("b", false) == nullptr);
+		REQUIRE(root.childNames() == ShvNode::StringList{"a"});
+	}
+
+	DOCTEST_SUBCASE("node reparented")
+	{
+		c->setParentNode(&root);
+		REQUIRE(a->childNode("c", false) == nullptr);
+		REQUIRE(root.childNode("c", false) == c);
+		REQUIRE(a->childNames().empty());
+		REQUIRE(root.childNames() == ShvNode::StringList{"a", "b", "c"});
+	}
+
+	DOCTEST_SUBCASE("unsorted children")
+	{
+		root.setSortedChildren(false);
+		REQUIRE(root.childNames() == ShvNode::StringList{"b", "a"});
+	}
+}
+
+DOCTEST_TEST_CASE("ShvNode method lookup")
+{
+	SwitchableMethodsNode nd("nd", &test_methods);
+	const ShvNode::StringViewList own_path;
+
+	REQUIRE(nd.metaMethod(own_path, Rpc::METH_GET) == &test_methods[2]);
+	REQUIRE(nd.metaMethod(own_path, Rpc::METH_GET) == &test_methods[2]);
+	REQUIRE(nd.metaMethod(own_path, Rpc::METH_SET) == nullptr);
+
+	nd.setMethods(&other_test_methods);
+	REQUIRE(nd.metaMethod(own_path, Rpc::METH_GET) == &other_test_methods[3]);
+	REQUIRE(nd.metaMethod(own_path, Rpc::METH_SET) == &other_test_methods[2]);
+
+	nd.setMethods(&test_methods);
+	REQUIRE(nd.metaMethod(own_path, Rpc::METH_SET) == nullptr);
+	REQUIRE(nd.metaMethod(own_path, Rpc::METH_GET) == &test_methods[2]);
+}
+
+DOCTEST_TEST_CASE("ShvNode dir and ls cache")
+{
+	// ls cache must be invalidated by child mutation paths, not by QChildEvent
+	REQUIRE(QCoreApplication::instance() == nullptr);
+	const ShvNode::StringViewList own_path;
+	SwitchableMethodsNode nd("nd", &test_methods);
+	nd.setDirLsCacheEnabled(true);
+
+	DOCTEST_SUBCASE("dir")
+	{
+		REQUIRE(nd.dir(own_path, {}).asList().size() == test_methods.size());
+		REQUIRE(nd.dir(own_path, {}).asList().size() == test_methods.size());
+		nd.setMethods(&other_test_methods);
+		REQUIRE(nd.dir(own_path, {}).asList().size() == other_test_methods.size());
+		REQUIRE(nd.dir(own_path, Rpc::METH_SET).isIMap());
+	}
+
+	DOCTEST_SUBCASE("ls")
+	{
+		new ShvNode("b", &nd);
+		REQUIRE(nd.ls(own_path, {}).asList() == RpcList{"b"});
+		auto *a = new ShvNode("a", &nd);
+		REQUIRE(nd.ls(own_path, {}).asList() == RpcList{"a", "b"});
+		REQUIRE(nd.ls(own_path, "a").toBool());
+		a->setNodeId("c");
+		REQUIRE(nd.ls(own_path, {}).asList() == RpcList{"b", "c"});
+		REQUIRE(!nd.ls(own_path, "a").toBool());
+		delete a;
+		REQUIRE(nd.ls(own_path, {}).asList() == RpcList{"b"});
+
+		ShvNode other("other", nullptr);
+		auto *d = new ShvNode("d", &other);
+		d->setParentNode(&nd);
+		REQUIRE(nd.ls(own_path, {}).asList() == RpcList{"b", "d"});
+		REQUIRE(nd.ls(own_path, "d").toBool());
+		d->setParentNode(&other);
+		REQUIRE(nd.ls(own_path, {}).asList() == RpcList{"b"});
+		REQUIRE(!nd.ls(own_path, "d").toBool());
+	}
+}
+
+DOCTEST_TEST_CASE("ShvNode frame routing")
+{
+	ShvRootNode root(nullptr);
+	auto *a = new ShvNode("a", &root);
+	new MethodsTableNode("c", &test_methods, a);
+	RpcResponse resp;
+	QObject::connect(&root, &ShvNode::sendRpcMessage, [&resp](const RpcMessage &msg) { resp = RpcResponse(msg); });
+	auto make_frame = [](const std::string &path, const std::string &method, AccessLevel access_level) {
+		RpcRequest rq;
+		rq.setRequestId(1);
+		rq.setShvPath(path);
+		rq.setMethod(method);
+		rq.setAccessLevel(access_level);
+		return rq.toRpcFrame();
+	};
+
+	DOCTEST_SUBCASE("method on nested node")
+	{
+		root.handleRpcFrame(make_frame("a/c", Rpc::METH_DIR, AccessLevel::Browse));
+		REQUIRE(resp.isSuccess());
+		REQUIRE(resp.result().asList().size() == test_methods.size());
+	}
+
+	DOCTEST_SUBCASE("redundant delimiters")
+	{
+		root.handleRpcFrame(make_frame("/a//c", Rpc::METH_LS, AccessLevel::Browse));
+		REQUIRE(resp.isSuccess());
+		REQUIRE(resp.result().asList().empty());
+	}
+
+	DOCTEST_SUBCASE("method not found")
+	{
+		root.handleRpcFrame(make_frame("a/x", Rpc::METH_LS, AccessLevel::Browse));
+		REQUIRE(!resp.isSuccess());
+		REQUIRE(resp.error().code() == RpcResponse::Error::MethodNotFound);
+	}
+
+	DOCTEST_SUBCASE("fast routing")
+	{
+		a->setFastRouting(true);
+		root.handleRpcFrame(make_frame("a/c", Rpc::METH_DIR, AccessLevel::Browse));
+		REQUIRE(resp.isSuccess());
+		REQUIRE(resp.result().asList().size() == test_methods.size());
+	}
+
+	DOCTEST_SUBCASE("intermediate node overriding childNode()")
+	{
+		new LazyNode("l", a);
+		root.handleRpcFrame(make_frame("a/l/lazy", Rpc::METH_DIR, AccessLevel::Browse));
+		REQUIRE(resp.isSuccess());
+		REQUIRE(resp.result().asList().size() == test_methods.size());
+	}
+
+	DOCTEST_SUBCASE("intermediate node overriding handleRpcFrame()")
+	{
+		auto *i = new InterceptingNode("i", a);
+		new MethodsTableNode("c", &test_methods, i);
+		root.handleRpcFrame(make_frame("a/i/c", Rpc::METH_DIR, AccessLevel::Browse));
+		REQUIRE(resp.isSuccess());
+		REQUIRE(i->interceptedPaths == std::vector<std::string>{"c"});
+		// fast routing node in front of it does not change that
+		a->setFastRouting(true);
+		root.handleRpcFrame(make_frame("a/i/c", Rpc::METH_DIR, AccessLevel::Browse));
+		REQUIRE(i->interceptedPaths == std::vector<std::string>{"c", "c"});
+	}
+
+	DOCTEST_SUBCASE("permission denied before params are decoded")
+	{
+		auto frame = make_frame("a/c", Rpc::METH_GET, AccessLevel::Browse);
+		frame.data = "\xff\xff\xff";
+		root.handleRpcFrame(std::move(frame));
+		REQUIRE(!resp.isSuccess());
+		REQUIRE(resp.error().message().find("permission denied") != std::string::npos);
+	}
+}
@@ -1,16 +1,20 @@
 #pragma once
 
 #include <shv/visu/shvvisuglobal.h>
+#include <shv/visu/timeline/sample.h>
 
+#include <shv/chainpack/rpcvalue.h>
 #include <shv/core/utils.h>
 
 #include <QDialog>
+#include <QMap>
+
+#include <functional>
 
 #if SHVVISU_HAS_TIMEZONE
 #include <QTimeZone>
 #endif
 
-namespace shv::chainpack { class RpcValue; }
 namespace shv::iotqt::rpc { class ClientConnection; }
 namespace shv::visu::timeline { class GraphWidget; class GraphModel; class Graph; class ChannelFilterDialog;}
 
@@ -42,7 +46,19 @@ private:
 	void saveSettings();
 
 	shv::chainpack::RpcValue getLogParams();
+	/// requests next log page, invalid since means the first page
+	void downloadLogPage(const shv::chainpack::RpcValue &since);
+	/// requests page evicted from log model again
+	void downloadEvictedPage(int page_index, const shv::chainpack::RpcValue &get_log_params);
+	void callGetLog(const shv::chainpack::RpcValue &params, const std::function<void (const shv::chainpack::RpcValue &)> &on_log, const std::function<void ()> &on_error);
 	void parseLog(shv::chainpack::RpcValue log);
+	void parseLogPage(const shv::chainpack::RpcValue &page, bool is_first_page, const shv::chainpack::RpcValue &get_log_params);
+	void clearGraph();
+	/// adds samples of resident log model page to graph and removes samples of evicted pages
+	void updateGraphPage(int page_index, const shv::chainpack::RpcValue &log);
+	void refreshGraph(bool keep_zoom);
+	struct GraphShortTimes;
+	void appendLogToGraph(shv::visu::timeline::GraphModel *model, const shv::chainpack::RpcValue &log, GraphShortTimes &short_times);
 
 	void showInfo(const QString &msg = QString(), bool is_error = false);
 	void saveData(const std::string &data, QString ext);
@@ -53,8 +69,30 @@ private:
 #endif
 
 	void onGraphChannelFilterChanged();
+	/// fetches pages around resident ones when graph zoom reaches edge of loaded data
+	void onGraphXRangeZoomChanged(const shv::visu::timeline::XRange &range);
 
 private:
+	static constexpr int LOG_PAGE_SIZE = 5000;
+
+	struct ShortTime
+	{
+		int64_t msecSum = 0;
+		uint16_t lastMsec = 0;
+
+		int64_t addShortTime(uint16_t msec)
+		{
+			msecSum += static_cast<uint16_t>(msec - lastMsec);
+			lastMsec = msec;
+			return msecSum;
+		}
+	};
+	struct GraphShortTimes
+	{
+		QMap<std::string, ShortTime> paths;
+		ShortTime ancaHook;
+	};
+
 	Ui::DlgLogInspector *ui;
 
 #if SHVVISU_HAS_TIMEZONE
@@ -64,6 +102,16 @@ private:
 	shv::iotqt::rpc::ClientConnection* m_rpcConnection = nullptr;
 
 	LogModel *m_logModel = nullptr;
+	/// getLog params of current download, pages differ in since and record count limit only
+	shv::chainpack::RpcValue m_logDownloadParams;
+	std::string m_logDownloadPath;
+	int m_logDownloadSerial = 0;
+	int m_logDownloadedRecordCount = 0;
+	int m_logDownloadRecordCountLimit = 0;
+	/// short times are accumulated over consecutive pages appended to the graph
+	GraphShortTimes m_graphShortTimes;
+	int m_graphShortTimesPageIndex = -1;
+	bool m_isGraphZoomRestored = false;
 	LogSortFilterProxyModel *m_logSortFilterProxy = nullptr;
 
 	shv::visu::timeline::GraphModel *m_graphModel = nullptr;
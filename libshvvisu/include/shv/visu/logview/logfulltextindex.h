@@ -0,0 +1,65 @@
+#pragma once
+
+#include <shv/visu/shvvisuglobal.h>
+
+#include <QStringList>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace shv::visu::timeline { class FullTextFilter; }
+
+namespace shv::visu::logview {
+
+/// Trigram index of log rows built on worker thread.
+/// Rows are appended in batches, filter queries are answered from rows indexed so far.
+class SHVVISU_DECL_EXPORT LogFullTextIndex
+{
+public:
+	/// searchable texts of one row, row matches if any of them matches
+	using RowFields = QStringList;
+public:
+	/// callback is called from worker thread whenever a batch of rows is indexed
+	explicit LogFullTextIndex(std::function<void()> rows_indexed_callback = nullptr);
+	~LogFullTextIndex();
+
+	void clear();
+	void appendRows(std::vector<RowFields> &&rows);
+	/// removes rows appended so far, indexed or not, following rows are shifted
+	void removeRows(int first_row, int count);
+	int indexedRowCount() const;
+
+	/// returns ascending indexes of indexed rows matching filter
+	std::vector<int> matchingRows(const timeline::FullTextFilter &filter) const;
+private:
+	using Trigram = uint64_t;
+	static void forEachTrigram(const QString &folded_text, const std::function<void(Trigram)> &fn);
+	void run();
+	void indexBatch(std::vector<RowFields> &&rows, unsigned generation);
+	static void removePostings(std::unordered_map<Trigram, std::vector<int>> &postings, int first_row, int count);
+private:
+	std::function<void()> m_rowsIndexedCallback;
+
+	mutable std::mutex m_indexMutex;
+	std::vector<RowFields> m_rows;
+	std::unordered_map<Trigram, std::vector<int>> m_postings;
+
+	std::mutex m_queueMutex;
+	std::condition_variable m_queueCondition;
+	std::deque<std::vector<RowFields>> m_queue;
+	/// rows removed from batch being indexed just now, applied when the batch is merged to index
+	std::vector<std::pair<int, int>> m_inFlightRemovals;
+	int m_inFlightRowCount = 0;
+	unsigned m_generation = 0;
+	bool m_stopWorker = false;
+	std::thread m_worker;
+};
+
+}
@@ -25,15 +25,72 @@ public:
 	void setTimeZone(const QTimeZone &tz);
 #endif
 
+	static constexpr int DEFAULT_MAX_RESIDENT_ROW_COUNT = 200000;
+
+	/// sets complete log, no more pages are fetched
 	void setLog(const shv::chainpack::RpcValue &log);
+	/// appends getLog result as next page, more pages can be fetched if record count limit was hit,
+	/// get_log_params are kept to download the page again when it is evicted,
+	/// pages on the other end of resident rows are evicted when maxResidentRowCount is exceeded
+	void appendLogPage(const shv::chainpack::RpcValue &page, const shv::chainpack::RpcValue &get_log_params);
+	/// sets log of evicted page requested by pageRequested()
+	void setPageLog(int page_index, const shv::chainpack::RpcValue &log);
+	/// resident pages merged to single log
 	shv::chainpack::RpcValue log() const;
 
+	void setMaxResidentRowCount(int n) { m_maxResidentRowCount = n; }
+	int maxResidentRowCount() const { return m_maxResidentRowCount; }
+	/// no more pages will be downloaded, used when page request fails or download is finished
+	void stopFetchMore();
+	/// pending page request failed, it can be requested again
+	void abortFetch();
+
+	int firstResidentPageIndex() const { return static_cast<int>(m_residentBegin); }
+	int lastResidentPageIndex() const { return static_cast<int>(m_residentEnd) - 1; }
+	/// time of the first resident record, 0 if there are no resident records
+	int64_t residentSinceMsec() const;
+	/// time of the first evicted record after resident ones, 0 if there is none
+	int64_t residentUntilMsec() const;
+
 	int rowCount(const QModelIndex & = QModelIndex()) const override;
 	int columnCount(const QModelIndex & = QModelIndex()) const override;
 	QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
 	QVariant data(const QModelIndex &index, int role) const override;
+
+	/// reloads evicted page after resident ones or downloads next page
+	bool canFetchMore(const QModelIndex &parent) const override;
+	void fetchMore(const QModelIndex &parent) override;
+	/// reloads evicted page before resident ones
+	bool canFetchPrevious() const;
+	void fetchPrevious();
+
+	/// emitted by fetchMore(), since is the exclusive 'since' of the next page, the time of the last downloaded record
+	Q_SIGNAL void fetchMoreRequested(const shv::chainpack::RpcValue &since);
+	/// emitted when evicted page should be downloaded again and passed to setPageLog()
+	Q_SIGNAL void pageRequested(int page_index, const shv::chainpack::RpcValue &get_log_params);
+protected:
+	const shv::chainpack::RpcValue& logRow(int row, const shv::chainpack::RpcValue **page = nullptr) const;
+	void updateFirstRows();
+	void evictPages(bool from_front);
 protected:
-	shv::chainpack::RpcValue m_log;
+	struct Page
+	{
+		/// invalid when the page is evicted
+		shv::chainpack::RpcValue log;
+		shv::chainpack::RpcValue getLogParams;
+		int firstRow = 0;
+		int rowCount = 0;
+		int64_t firstMsec = 0;
+		int64_t lastMsec = 0;
+	};
+	/// all pages ever fetched, rows of pages <m_residentBegin, m_residentEnd) are resident
+	std::vector<Page> m_pages;
+	size_t m_residentBegin = 0;
+	size_t m_residentEnd = 0;
+	int m_rowCount = 0;
+	int m_maxResidentRowCount = DEFAULT_MAX_RESIDENT_ROW_COUNT;
+	bool m_hasMorePages = false;
+	bool m_fetchPending = false;
 #if SHVVISU_HAS_TIMEZONE
 	QTimeZone m_timeZone;
 #endif
@@ -5,10 +5,16 @@
 #include <shv/visu/timeline/fulltextfilter.h>
 
 #include <QSortFilterProxyModel>
+#include <QTimer>
+
+#include <memory>
 #include <optional>
+#include <vector>
 
 namespace shv::visu::logview {
 
+class LogFullTextIndex;
+
 class SHVVISU_DECL_EXPORT LogSortFilterProxyModel : public QSortFilterProxyModel
 {
 	Q_OBJECT
@@ -16,6 +22,9 @@ class SHVVISU_DECL_EXPORT LogSortFilterProxyModel : public QSortFilterProxyModel
 	using Super = QSortFilterProxyModel;
 public:
 	explicit LogSortFilterProxyModel(QObject *parent = nullptr);
+	~LogSortFilterProxyModel() override;
+
+	void setSourceModel(QAbstractItemModel *source_model) override;
 
 	void setChannelFilter(const std::optional<timeline::ChannelFilter> &filter);
 	void setShvPathColumn(int column);
@@ -24,10 +33,34 @@ public:
 
 	bool filterAcceptsRow(int source_rrow, const QModelIndex &source_parent) const override;
 
+	/// full-text filter is applied to indexed rows only, rows are indexed on background
+	bool isFulltextIndexComplete() const;
+	Q_SIGNAL void fulltextIndexProgress(int indexed_row_count, int row_count);
+private:
+	static constexpr int INDEX_BATCH_SIZE = 10000;
+	static constexpr int PARTIAL_RESULTS_UPDATE_MSEC = 300;
+
+	void rebuildFulltextIndex();
+	/// removes rows from index and filter results, following rows are shifted
+	void removeFulltextRows(int first_row, int count);
+	void scheduleFulltextIndexing();
+	void feedFulltextIndex();
+	void onRowsIndexed();
+	void updateFulltextMatches();
 private:
 	std::optional<shv::visu::timeline::ChannelFilter> m_channelFilter;
 	shv::visu::timeline::FullTextFilter m_fulltextFilter;
 	int m_shvPathColumn = -1;
 	int m_valueColumn = -1;
+
+	QList<QMetaObject::Connection> m_sourceModelConnections;
+	QTimer m_partialResultsTimer;
+	/// source rows sent to index so far
+	int m_fulltextFedRowCount = 0;
+	bool m_fulltextFeedScheduled = false;
+	/// full-text filter result for first m_fulltextMatches.size() source rows
+	std::vector<bool> m_fulltextMatches;
+	/// declared last, worker thread has to be joined before other members are destroyed
+	std::unique_ptr<LogFullTextIndex> m_fulltextIndex;
 };
 }
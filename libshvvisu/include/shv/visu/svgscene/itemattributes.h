@@ -0,0 +1,40 @@
+#pragma once
+
+#include <shv/visu/svgscene/types.h>
+
+#include <QMetaType>
+#include <QSharedPointer>
+
+class QGraphicsItem;
+
+namespace shv::visu::svgscene {
+
+/// Attributes of graphics item created once when scene is loaded,
+/// immutable and shared by the item and its controllers.
+class SHVVISU_DECL_EXPORT ItemAttributes
+{
+public:
+	ItemAttributes(const Types::XmlAttributes &xml_attributes, const Types::CssAttributes &css_attributes);
+
+	const Types::XmlAttributes& xmlAttributes() const { return m_xmlAttributes; }
+	const Types::CssAttributes& cssAttributes() const { return m_cssAttributes; }
+
+	/// returns nullptr if attribute is not defined,
+	/// returned pointer is valid as long as ItemAttributes exists
+	const QString* xmlAttribute(const QString &name) const;
+	const QString* cssAttribute(const QString &name) const;
+
+	/// returns nullptr if item has no attributes set,
+	/// returned pointer is valid as long as item exists and its attributes are not replaced
+	static const ItemAttributes* fromItem(const QGraphicsItem *item);
+	static void setToItem(QGraphicsItem *item, QSharedPointer<const ItemAttributes> attributes);
+private:
+	const Types::XmlAttributes m_xmlAttributes;
+	const Types::CssAttributes m_cssAttributes;
+};
+
+using ItemAttributesPtr = QSharedPointer<const ItemAttributes>;
+
+}
+
+Q_DECLARE_METATYPE(shv::visu::svgscene::ItemAttributesPtr)
@@ -7,6 +7,8 @@
 #include <QMetaType>
 #include <QStack>
 
+#include <vector>
+
 class QXmlStreamReader;
 class QXmlStreamAttributes;
 class QGraphicsScene;
@@ -39,6 +41,10 @@ public:
 	virtual ~SaxHandler();
 
 	void load(QXmlStreamReader *data, bool is_skip_definitions = false);
+	/// Parsed elements are cached in cache_dir under hash of SVG file content,
+	/// next load of unchanged file replays them without XML and CSS parsing.
+	/// Cache is not used if cache_dir is empty.
+	bool loadFile(const QString &file_name, const QString &cache_dir, bool is_skip_definitions = false);
 
 	static QString point2str(QPointF r);
 	static QString rect2str(QRectF r);
@@ -50,7 +56,22 @@ protected:
 
 	QGraphicsScene *m_scene;
 private:
+	struct SvgEvent
+	{
+		enum class Type : quint8 {StartElement = 0, EndElement, Characters};
+		Type type = Type::EndElement;
+		SvgElement element;
+		QString text;
+	};
+	static bool readCache(const QString &file_name, std::vector<SvgEvent> &events);
+	static void writeCache(const QString &file_name, const std::vector<SvgEvent> &events);
+
+	void init(bool is_skip_definitions);
 	void parse();
+	void replay(const std::vector<SvgEvent> &events);
+	void startSvgElement(const SvgElement &el);
+	void endSvgElement();
+	void addCharacters(const QString &text);
 	XmlAttributes parseXmlAttributes(const QXmlStreamAttributes &attributes);
 	void mergeCSSAttributes(CssAttributes &css_attributes, const QString &attr_name, const XmlAttributes &xml_attributes);
 
@@ -69,6 +90,8 @@ private:
 	QXmlStreamReader *m_xml = nullptr;
 	QPen m_defaultPen;
 	bool m_skipDefinitions = false;
+	/// events are recorded here during parse if set
+	std::vector<SvgEvent> *m_recordedEvents = nullptr;
 };
 
 }
@@ -12,13 +12,17 @@ struct SHVVISU_DECL_EXPORT Types
 	struct SHVVISU_DECL_EXPORT DataKey
 	{
 		enum {
-			XmlAttributes = 1,
-			CssAttributes,
+			/// not set anymore, use ItemAttributes::fromItem()
+			XmlAttributes [[deprecated("use Attributes")]] = 1,
+			/// not set anymore, use ItemAttributes::fromItem()
+			CssAttributes [[deprecated("use Attributes")]],
 			Id,
 			ChildId,
 			ShvPath,
 			ShvType,
 			ShvVisuType,
+			/// ItemAttributesPtr with XML and CSS attributes
+			Attributes,
 		};
 	};
 
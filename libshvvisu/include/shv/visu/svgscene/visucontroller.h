@@ -1,6 +1,7 @@
 #pragma once
 
 #include <shv/visu/svgscene/saxhandler.h>
+#include <shv/visu/svgscene/itemattributes.h>
 #include <shv/visu/svgscene/types.h>
 
 #include <shv/core/utils.h>
@@ -24,6 +25,10 @@ public:
 protected:
 	static QString graphicsItemAttributeValue(const QGraphicsItem *it, const QString &attr_name, const QString &default_value = QString());
 	static QString graphicsItemCssAttributeValue(const QGraphicsItem *it, const QString &attr_name, const QString &default_value = QString());
+	/// Resolve attributes needed for value updates once, for example in constructor,
+	/// returned pointer is valid as long as graphics item exists, nullptr if attribute is not defined.
+	static const QString* resolveGraphicsItemAttribute(const QGraphicsItem *it, const QString &attr_name);
+	static const QString* resolveGraphicsItemCssAttribute(const QGraphicsItem *it, const QString &attr_name);
 
 	template<typename T>
 	T findChildGraphicsItem(const QString &attr_name = QString(), const QString &attr_value = QString()) const
@@ -41,13 +46,8 @@ protected:
 				if(attr_name.isEmpty()) {
 					return tit;
 				}
-				svgscene::XmlAttributes attrs = qvariant_cast<svgscene::XmlAttributes>(tit->data(Types::DataKey::XmlAttributes));
-				if(attr_value.isEmpty()) {
-					if(attrs.contains(attr_name))
-						return tit;
-				}
-				else {
-					if(attrs.value(attr_name) == attr_value)
+				if(const QString *value = resolveGraphicsItemAttribute(tit, attr_name)) {
+					if(attr_value.isEmpty() || *value == attr_value)
 						return tit;
 				}
 			}
@@ -78,8 +78,7 @@ protected:
 					ret << tit;
 				}
 				else {
-					svgscene::XmlAttributes attrs = qvariant_cast<svgscene::XmlAttributes>(tit->data(Types::DataKey::XmlAttributes));
-					if(attrs.contains(attr_name))
+					if(resolveGraphicsItemAttribute(tit, attr_name))
 						ret << tit;
 				}
 			}
@@ -226,6 +226,8 @@ public:
 	Q_SIGNAL void styleChanged();
 	Q_SIGNAL void layoutChanged();
 	Q_SIGNAL void channelFilterChanged();
+	/// emitted by setXRangeZoom() only, not when zoom follows xRange change
+	Q_SIGNAL void xRangeZoomChanged(const shv::visu::timeline::XRange &range);
 	Q_SIGNAL void channelContextMenuRequest(int channel_index, const QPoint &mouse_pos);
 	void emitChannelContextMenuRequest(int channel_index, const QPoint &mouse_pos);
 	Q_SIGNAL void graphContextMenuRequest(const QPoint &mouse_pos);
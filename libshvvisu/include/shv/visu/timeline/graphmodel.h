@@ -70,6 +70,12 @@ public:
 	virtual void appendValue(qsizetype channel, Sample &&sample);
 	void appendValueShvPath(const std::string &shv_path, Sample &&sample);
 	void forgetValuesBefore(timemsec_t time, int min_samples_count = 100);
+	/// removes samples with time lower than time
+	void removeValuesBefore(timemsec_t time);
+	/// removes samples with time greater or equal to time
+	void removeValuesFrom(timemsec_t time);
+	/// merges samples of other model, channels are matched by shv path and created when missing
+	void mergeValues(const GraphModel &other);
 
 	qsizetype pathToChannelIndex(const std::string &path) const;
 	QString channelShvPath(qsizetype channel) const;
@@ -25,6 +25,7 @@
 #include <QFileDialog>
 #include <QMenu>
 #include <QMessageBox>
+#include <QScrollBar>
 #include <QSettings>
 #include <QSortFilterProxyModel>
 #include <QStandardItemModel>
@@ -32,6 +33,9 @@
 #include <QTimeZone>
 #endif
 
+#include <algorithm>
+#include <limits>
+
 namespace cp = shv::chainpack;
 namespace tl = shv::visu::timeline;
 
@@ -104,8 +108,7 @@ DlgLogInspector::DlgLogInspector(const QString &shv_path, QWidget *parent) :
 				std::string err;
 				auto log = shv::chainpack::RpcValue::fromChainPack(log_data, &err);
 				if (err.empty()) {
-					m_logModel->setLog(log);
-					parseLog(m_logModel->log());
+					parseLog(log);
 				}
 				else {
 					QMessageBox::warning(this, tr("Warning"), tr("Invalid ChainPack file: ") + QString::fromStdString(err));
@@ -120,8 +123,7 @@ DlgLogInspector::DlgLogInspector(const QString &shv_path, QWidget *parent) :
 				std::string err;
 				auto log = shv::chainpack::RpcValue::fromCpon(log_data, &err);
 				if (err.empty()) {
-					m_logModel->setLog(log);
-					parseLog(m_logModel->log());
+					parseLog(log);
 				}
 				else {
 					QMessageBox::warning(this, tr("Warning"), tr("Invalid CPON file: ") + QString::fromStdString(err));
@@ -240,8 +242,16 @@ DlgLogInspector::DlgLogInspector(const QString &shv_path, QWidget *parent) :
 #endif
 
 	connect(ui->btLoad, &QPushButton::clicked, this, &DlgLogInspector::downloadLog);
+	connect(m_logModel, &LogModel::fetchMoreRequested, this, &DlgLogInspector::downloadLogPage);
+	connect(m_logModel, &LogModel::pageRequested, this, &DlgLogInspector::downloadEvictedPage);
+	connect(ui->tblData->verticalScrollBar(), &QScrollBar::valueChanged, this, [this](int value) {
+		// pages evicted from the log model are fetched again when data view is scrolled back to the top
+		if(value == ui->tblData->verticalScrollBar()->minimum())
+			m_logModel->fetchPrevious();
+	});
 
 	connect(m_graph, &shv::visu::timeline::Graph::channelFilterChanged, this, &DlgLogInspector::onGraphChannelFilterChanged);
+	connect(m_graph, &shv::visu::timeline::Graph::xRangeZoomChanged, this, &DlgLogInspector::onGraphXRangeZoomChanged);
 
 	connect(ui->btResizeColumnsToFitWidth, &QAbstractButton::clicked, this, [this]() {
 		ui->tblData->horizontalHeader()->resizeSections(QHeaderView::ResizeToContents);
@@ -331,24 +341,86 @@ void DlgLogInspector::downloadLog()
 		if(shv_path.starts_with("shv/"))
 			shv_path = "history" + shv_path.substr(3);
 	}
+	m_logDownloadPath = shv_path;
+	m_logDownloadParams = getLogParams();
+	m_logDownloadedRecordCount = 0;
+	// log is downloaded in pages, max record count limits all of them together
+	m_logDownloadRecordCountLimit = ui->edMaxRecordCount->value() > ui->edMaxRecordCount->minimum()
+			? ui->edMaxRecordCount->value()
+			: std::numeric_limits<int>::max();
+	m_logDownloadSerial++;
+	downloadLogPage(cp::RpcValue());
+}
+
+void DlgLogInspector::downloadLogPage(const shv::chainpack::RpcValue &since)
+{
+	const bool is_first_page = !since.isValid();
+	auto params = shv::core::utils::ShvGetLogParams::fromRpcValue(m_logDownloadParams);
+	if(!is_first_page) {
+		if(m_logDownloadedRecordCount >= m_logDownloadRecordCountLimit) {
+			m_logModel->stopFetchMore();
+			return;
+		}
+		// since is the time of the last downloaded record, getLog 'since' is exclusive
+		// and it never splits records with the same timestamp between pages
+		params.since = since;
+		params.withSnapshot = false;
+	}
+	params.recordCountLimit = std::min(LOG_PAGE_SIZE, m_logDownloadRecordCountLimit - m_logDownloadedRecordCount);
+	auto get_log_params = params.toRpcValue();
+	callGetLog(get_log_params, [this, is_first_page, get_log_params](const cp::RpcValue &log) {
+		parseLogPage(log, is_first_page, get_log_params);
+	}, [this]() {
+		m_logModel->stopFetchMore();
+	});
+}
+
+void DlgLogInspector::downloadEvictedPage(int page_index, const shv::chainpack::RpcValue &get_log_params)
+{
+	callGetLog(get_log_params, [this, page_index](const cp::RpcValue &log) {
+		const QScrollBar *scroll_bar = ui->tblData->verticalScrollBar();
+		const bool is_scrolled_to_top = scroll_bar->value() == scroll_bar->minimum();
+		const bool is_previous_page = page_index < m_logModel->firstResidentPageIndex();
+		m_logModel->setPageLog(page_index, log);
+		updateGraphPage(page_index, log);
+		refreshGraph(true);
+		if(is_previous_page && is_scrolled_to_top) {
+			// keep rows shown before the page was inserted above them on the top of the view
+			auto ix = m_logSortFilterProxy->mapFromSource(m_logModel->index(static_cast<int>(log.asList().size()), 0));
+			if(ix.isValid())
+				ui->tblData->scrollTo(ix, QAbstractItemView::PositionAtTop);
+		}
+	}, [this]() {
+		m_logModel->abortFetch();
+	});
+}
+
+void DlgLogInspector::callGetLog(const shv::chainpack::RpcValue &params, const std::function<void (const shv::chainpack::RpcValue &)> &on_log, const std::function<void ()> &on_error)
+{
+	const std::string &shv_path = m_logDownloadPath;
 	showInfo(QString::fromStdString("Downloading data from " + shv_path));
-	cp::RpcValue params = getLogParams();
 	shv::iotqt::rpc::ClientConnection *conn = rpcConnection();
 	int rq_id = conn->nextRequestId();
 	auto *cb = new shv::iotqt::rpc::RpcResponseCallBack(conn, rq_id, this);
 	cb->setTimeout(ui->edTimeout->value() * 1000);
-	cb->start(this, [this, shv_path](const cp::RpcResponse &resp) {
+	cb->start(this, [this, shv_path, on_log, on_error, serial = m_logDownloadSerial](const cp::RpcResponse &resp) {
+		if(serial != m_logDownloadSerial) {
+			// response to abandoned download
+			return;
+		}
 		if(resp.isValid()) {
 			if(resp.isError()) {
 				showInfo(QString::fromStdString("GET " + shv_path + " RPC request error: " + resp.error().toString()), true);
+				on_error();
 			}
 			else {
 				showInfo();
-				this->parseLog(resp.result());
+				on_log(resp.result());
 			}
 		}
 		else {
 			showInfo(QString::fromStdString("GET " + shv_path + " RPC request timeout"), true);
+			on_error();
 		}
 	});
 	conn->callShvMethod(rq_id, shv_path, cp::Rpc::METH_GET_LOG, params);
@@ -356,6 +428,8 @@ void DlgLogInspector::downloadLog()
 
 void DlgLogInspector::parseLog(shv::chainpack::RpcValue log)
 {
+	// complete log, not downloaded in pages
+	m_logDownloadSerial++;
 	{
 		std::string str = log.metaData().toString("\t");
 		ui->edInfo->setPlainText(QString::fromStdString(str));
@@ -364,25 +438,91 @@ void DlgLogInspector::parseLog(shv::chainpack::RpcValue log)
 		m_logModel->setLog(log);
 		ui->tblData->horizontalHeader()->resizeSections(QHeaderView::ResizeToContents);
 	}
+	clearGraph();
+	appendLogToGraph(m_graphModel, log, m_graphShortTimes);
+	refreshGraph(false);
+}
+
+void DlgLogInspector::parseLogPage(const shv::chainpack::RpcValue &page, bool is_first_page, const shv::chainpack::RpcValue &get_log_params)
+{
+	m_logDownloadedRecordCount += static_cast<int>(page.asList().size());
+	if(is_first_page) {
+		std::string str = page.metaData().toString("\t");
+		ui->edInfo->setPlainText(QString::fromStdString(str));
+		m_logModel->setLog(cp::RpcValue());
+		clearGraph();
+	}
+	m_logModel->appendLogPage(page, get_log_params);
+	if(is_first_page)
+		ui->tblData->horizontalHeader()->resizeSections(QHeaderView::ResizeToContents);
+
+	if(!page.asList().empty())
+		updateGraphPage(m_logModel->lastResidentPageIndex(), page);
+	// keep user zoom and channel filter when next page arrives
+	refreshGraph(!is_first_page);
+}
+
+void DlgLogInspector::clearGraph()
+{
+	m_graphShortTimes = {};
+	m_graphShortTimesPageIndex = -1;
+	m_graphModel->clear();
+	m_graphModel->setTypeInfo({});
+}
+
+void DlgLogInspector::updateGraphPage(int page_index, const shv::chainpack::RpcValue &log)
+{
+	if(page_index < m_logModel->firstResidentPageIndex() || page_index > m_logModel->lastResidentPageIndex()) {
+		// page was not accepted by log model
+		return;
+	}
+	if(page_index == m_logModel->lastResidentPageIndex()) {
+		if(page_index != m_graphShortTimesPageIndex + 1)
+			m_graphShortTimes = {};
+		appendLogToGraph(m_graphModel, log, m_graphShortTimes);
+		m_graphShortTimesPageIndex = page_index;
+	}
+	else {
+		// page inserted before resident ones cannot be appended
+		tl::GraphModel page_model;
+		page_model.setTypeInfo(m_graphModel->typeInfo());
+		GraphShortTimes short_times;
+		appendLogToGraph(&page_model, log, short_times);
+		m_graphModel->mergeValues(page_model);
+	}
+	// samples are evicted together with log model pages
+	if(auto since = m_logModel->residentSinceMsec(); since > 0)
+		m_graphModel->removeValuesBefore(since);
+	if(auto until = m_logModel->residentUntilMsec(); until > 0)
+		m_graphModel->removeValuesFrom(until);
+}
+
+void DlgLogInspector::refreshGraph(bool keep_zoom)
+{
+	if(keep_zoom) {
+		const auto x_range_zoom = m_graph->xRangeZoom();
+		const auto channel_filter = m_graph->channelFilter();
+		m_graph->createChannelsFromModel();
+		m_graph->setChannelFilter(channel_filter);
+		m_isGraphZoomRestored = true;
+		m_graph->setXRangeZoom(x_range_zoom);
+		m_isGraphZoomRestored = false;
+	}
+	else {
+		m_graph->createChannelsFromModel();
+	}
+	ui->graphView->makeLayout();
+}
+
+void DlgLogInspector::appendLogToGraph(shv::visu::timeline::GraphModel *model, const shv::chainpack::RpcValue &log, GraphShortTimes &short_times)
+{
 	try {
-		struct ShortTime {
-			int64_t msec_sum = 0;
-			uint16_t last_msec = 0;
-
-			int64_t addShortTime(uint16_t msec)
-			{
-				msec_sum += static_cast<uint16_t>(msec - last_msec);
-				last_msec = msec;
-				return msec_sum;
-			}
-		};
-		QMap<std::string, ShortTime> short_times;
 		shv::core::utils::ShvLogRpcValueReader rd(log, shv::core::Exception::Throw);
-		m_graphModel->clear();
-		m_graphModel->beginAppendValues();
-		m_graphModel->setTypeInfo(rd.logHeader().typeInfo());
-		shvDebug() << "typeinfo:" << m_graphModel->typeInfo().toRpcValue().toCpon("  ");
-		ShortTime anca_hook_short_time;
+		model->beginAppendValues();
+		// type info is sent with the first page only
+		if(const auto &type_info = rd.logHeader().typeInfo(); type_info.isValid())
+			model->setTypeInfo(type_info);
+		shvDebug() << "typeinfo:" << model->typeInfo().toRpcValue().toCpon("  ");
 		while(rd.next()) {
 			const core::utils::ShvJournalEntry &entry = rd.entry();
 			if(!(entry.domain.empty()
@@ -394,9 +534,9 @@ void DlgLogInspector::parseLog(shv::chainpack::RpcValue log)
 			int64_t msec = entry.epochMsec;
 			if(entry.shortTime != core::utils::ShvJournalEntry::NO_SHORT_TIME) {
 				auto short_msec = static_cast<uint16_t>(entry.shortTime);
-				ShortTime &st = short_times[entry.path];
-				if(st.msec_sum == 0)
-					st.msec_sum = msec;
+				ShortTime &st = short_times.paths[entry.path];
+				if(st.msecSum == 0)
+					st.msecSum = msec;
 				msec = st.addShortTime(short_msec);
 			}
 			bool ok;
@@ -411,26 +551,23 @@ void DlgLogInspector::parseLog(shv::chainpack::RpcValue log)
 					// Anca hook
 					QVariantList vl = v.toList();
 					uint16_t short_msec = static_cast<uint16_t>(vl.value(0).toInt());
-					if(anca_hook_short_time.msec_sum == 0)
-						anca_hook_short_time.msec_sum = msec;
-					msec = anca_hook_short_time.addShortTime(short_msec);
-					m_graphModel->appendValueShvPath("U", tl::Sample{msec, vl.value(1)});
-					m_graphModel->appendValueShvPath("I", tl::Sample{msec, vl.value(2)});
-					m_graphModel->appendValueShvPath("P", tl::Sample{msec, vl.value(3)});
+					if(short_times.ancaHook.msecSum == 0)
+						short_times.ancaHook.msecSum = msec;
+					msec = short_times.ancaHook.addShortTime(short_msec);
+					model->appendValueShvPath("U", tl::Sample{msec, vl.value(1)});
+					model->appendValueShvPath("I", tl::Sample{msec, vl.value(2)});
+					model->appendValueShvPath("P", tl::Sample{msec, vl.value(3)});
 				}
 				else {
-					m_graphModel->appendValueShvPath(entry.path, tl::Sample{msec, v});
+					model->appendValueShvPath(entry.path, tl::Sample{msec, v});
 				}
 			}
 		}
-		m_graphModel->endAppendValues();
+		model->endAppendValues();
 	}
 	catch (const shv::core::Exception &e) {
 		QMessageBox::warning(this, tr("Warning"), QString::fromStdString(e.message()));
 	}
-
-	m_graph->createChannelsFromModel();
-	ui->graphView->makeLayout();
 }
 
 void DlgLogInspector::showInfo(const QString &msg, bool is_error)
@@ -493,4 +630,15 @@ void DlgLogInspector::onGraphChannelFilterChanged()
 	m_logSortFilterProxy->setChannelFilter(m_graph->channelFilter());
 }
 
+void DlgLogInspector::onGraphXRangeZoomChanged(const shv::visu::timeline::XRange &range)
+{
+	if(m_isGraphZoomRestored)
+		return;
+	const auto x_range = m_graph->xRange();
+	if(range.min <= x_range.min && m_logModel->canFetchPrevious())
+		m_logModel->fetchPrevious();
+	else if(range.max >= x_range.max && m_logModel->canFetchMore(QModelIndex()))
+		m_logModel->fetchMore(QModelIndex());
+}
+
 }
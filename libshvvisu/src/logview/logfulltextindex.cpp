@@ -0,0 +1,230 @@
+#include <shv/visu/logview/logfulltextindex.h>
+#include <shv/visu/timeline/fulltextfilter.h>
+
+#include <algorithm>
+
+namespace shv::visu::logview {
+
+LogFullTextIndex::LogFullTextIndex(std::function<void()> rows_indexed_callback)
+	: m_rowsIndexedCallback(std::move(rows_indexed_callback))
+	, m_worker(&LogFullTextIndex::run, this)
+{
+}
+
+LogFullTextIndex::~LogFullTextIndex()
+{
+	{
+		std::lock_guard lock(m_queueMutex);
+		m_stopWorker = true;
+	}
+	m_queueCondition.notify_one();
+	m_worker.join();
+}
+
+void LogFullTextIndex::clear()
+{
+	{
+		std::lock_guard lock(m_queueMutex);
+		m_queue.clear();
+		// batch being indexed just now is thrown away
+		m_generation++;
+		m_inFlightRowCount = 0;
+		m_inFlightRemovals.clear();
+	}
+	std::lock_guard lock(m_indexMutex);
+	m_rows.clear();
+	m_postings.clear();
+}
+
+void LogFullTextIndex::appendRows(std::vector<RowFields> &&rows)
+{
+	{
+		std::lock_guard lock(m_queueMutex);
+		m_queue.push_back(std::move(rows));
+	}
+	m_queueCondition.notify_one();
+}
+
+void LogFullTextIndex::removeRows(int first_row, int count)
+{
+	// rows are numbered over indexed rows, the batch being indexed just now and queued batches
+	std::lock_guard queue_lock(m_queueMutex);
+	std::lock_guard lock(m_indexMutex);
+	const auto indexed_row_count = static_cast<int>(m_rows.size());
+	if(first_row < indexed_row_count) {
+		const int n = std::min(count, indexed_row_count - first_row);
+		m_rows.erase(m_rows.begin() + first_row, m_rows.begin() + first_row + n);
+		removePostings(m_postings, first_row, n);
+		count -= n;
+		first_row = 0;
+	}
+	else {
+		first_row -= indexed_row_count;
+	}
+	if(count > 0 && first_row < m_inFlightRowCount) {
+		const int n = std::min(count, m_inFlightRowCount - first_row);
+		m_inFlightRemovals.emplace_back(first_row, n);
+		m_inFlightRowCount -= n;
+		count -= n;
+		first_row = 0;
+	}
+	else {
+		first_row -= m_inFlightRowCount;
+	}
+	for(auto it = m_queue.begin(); count > 0 && it != m_queue.end(); ) {
+		auto &batch = *it;
+		const auto batch_size = static_cast<int>(batch.size());
+		if(first_row >= batch_size) {
+			first_row -= batch_size;
+			++it;
+			continue;
+		}
+		const int n = std::min(count, batch_size - first_row);
+		batch.erase(batch.begin() + first_row, batch.begin() + first_row + n);
+		count -= n;
+		first_row = 0;
+		if(batch.empty())
+			it = m_queue.erase(it);
+		else
+			++it;
+	}
+}
+
+void LogFullTextIndex::removePostings(std::unordered_map<Trigram, std::vector<int>> &postings, int first_row, int count)
+{
+	const int last_row = first_row + count;
+	for(auto it = postings.begin(); it != postings.end(); ) {
+		auto &posting = it->second;
+		auto first = std::lower_bound(posting.begin(), posting.end(), first_row);
+		auto last = std::lower_bound(first, posting.end(), last_row);
+		auto rest = posting.erase(first, last);
+		std::for_each(rest, posting.end(), [count](int &row) { row -= count; });
+		if(posting.empty())
+			it = postings.erase(it);
+		else
+			++it;
+	}
+}
+
+int LogFullTextIndex::indexedRowCount() const
+{
+	std::lock_guard lock(m_indexMutex);
+	return static_cast<int>(m_rows.size());
+}
+
+void LogFullTextIndex::forEachTrigram(const QString &folded_text, const std::function<void(Trigram)> &fn)
+{
+	for(qsizetype i = 2; i < folded_text.size(); ++i) {
+		fn(static_cast<Trigram>(folded_text[i - 2].unicode()) << 32
+		   | static_cast<Trigram>(folded_text[i - 1].unicode()) << 16
+		   | static_cast<Trigram>(folded_text[i].unicode()));
+	}
+}
+
+std::vector<int> LogFullTextIndex::matchingRows(const timeline::FullTextFilter &filter) const
+{
+	std::vector<int> ret;
+	std::lock_guard lock(m_indexMutex);
+	const auto row_count = static_cast<int>(m_rows.size());
+	auto row_matches = [this, &filter](int row) {
+		const auto &fields = m_rows[static_cast<size_t>(row)];
+		return std::any_of(fields.begin(), fields.end(), [&filter](const QString &field) { return filter.matches(field); });
+	};
+	if(filter.pattern().isEmpty() || filter.isRegularExpression()) {
+		// regular expression cannot be resolved by trigrams, but texts do not have to be formatted again at least
+		for(int row = 0; row < row_count; ++row) {
+			if(row_matches(row))
+				ret.push_back(row);
+		}
+		return ret;
+	}
+	// intersect posting lists of pattern trigrams, the shortest one first
+	std::vector<const std::vector<int>*> postings;
+	bool has_missing_trigram = false;
+	forEachTrigram(filter.pattern().toCaseFolded(), [this, &postings, &has_missing_trigram](Trigram trigram) {
+		auto it = m_postings.find(trigram);
+		if(it == m_postings.end())
+			has_missing_trigram = true;
+		else
+			postings.push_back(&it->second);
+	});
+	if(has_missing_trigram)
+		return ret;
+	if(postings.empty()) {
+		// pattern is shorter than trigram
+		for(int row = 0; row < row_count; ++row) {
+			if(row_matches(row))
+				ret.push_back(row);
+		}
+		return ret;
+	}
+	std::sort(postings.begin(), postings.end(), [](const auto *p1, const auto *p2) { return p1->size() < p2->size(); });
+	std::vector<int> candidates = *postings.front();
+	for(size_t i = 1; i < postings.size() && !candidates.empty(); ++i) {
+		std::vector<int> intersection;
+		std::set_intersection(candidates.begin(), candidates.end(), postings[i]->begin(), postings[i]->end(), std::back_inserter(intersection));
+		candidates = std::move(intersection);
+	}
+	// trigrams can be found in different fields or out of order, candidates must be verified
+	std::copy_if(candidates.begin(), candidates.end(), std::back_inserter(ret), row_matches);
+	return ret;
+}
+
+void LogFullTextIndex::run()
+{
+	while(true) {
+		std::vector<RowFields> rows;
+		unsigned generation;
+		{
+			std::unique_lock lock(m_queueMutex);
+			m_queueCondition.wait(lock, [this]() { return m_stopWorker || !m_queue.empty(); });
+			if(m_stopWorker)
+				return;
+			rows = std::move(m_queue.front());
+			m_queue.pop_front();
+			generation = m_generation;
+			m_inFlightRowCount = static_cast<int>(rows.size());
+		}
+		indexBatch(std::move(rows), generation);
+	}
+}
+
+void LogFullTextIndex::indexBatch(std::vector<RowFields> &&rows, unsigned generation)
+{
+	// trigrams are collected without lock, GUI thread can query index meanwhile
+	std::unordered_map<Trigram, std::vector<int>> batch_postings;
+	for(size_t i = 0; i < rows.size(); ++i) {
+		const auto batch_row = static_cast<int>(i);
+		for(const auto &field : rows[i]) {
+			forEachTrigram(field.toCaseFolded(), [&batch_postings, batch_row](Trigram trigram) {
+				auto &posting = batch_postings[trigram];
+				if(posting.empty() || posting.back() != batch_row)
+					posting.push_back(batch_row);
+			});
+		}
+	}
+	{
+		std::lock_guard queue_lock(m_queueMutex);
+		if(generation != m_generation)
+			return;
+		for(const auto &[first_row, count] : m_inFlightRemovals) {
+			rows.erase(rows.begin() + first_row, rows.begin() + first_row + count);
+			removePostings(batch_postings, first_row, count);
+		}
+		m_inFlightRemovals.clear();
+		m_inFlightRowCount = 0;
+		std::lock_guard lock(m_indexMutex);
+		const auto first_row = static_cast<int>(m_rows.size());
+		for(auto &[trigram, batch_posting] : batch_postings) {
+			auto &posting = m_postings[trigram];
+			posting.reserve(posting.size() + batch_posting.size());
+			for(int row : batch_posting)
+				posting.push_back(first_row + row);
+		}
+		std::move(rows.begin(), rows.end(), std::back_inserter(m_rows));
+	}
+	if(m_rowsIndexedCallback)
+		m_rowsIndexedCallback();
+}
+
+}
@@ -1,10 +1,13 @@
 #include <shv/visu/logview/logmodel.h>
 
 #include <shv/core/utils/shvfilejournal.h>
+#include <shv/core/utils/shvlogheader.h>
 #include <shv/core/log.h>
 
 #include <QDateTime>
 
+#include <algorithm>
+
 namespace cp = shv::chainpack;
 
 namespace shv::visu::logview {
@@ -28,22 +31,231 @@ void LogModel::setTimeZone(const QTimeZone &tz)
 }
 #endif
 
+namespace {
+int64_t row_msec(const cp::RpcValue &row)
+{
+	return row.asList().valref(LogModel::ColDateTime).toDateTime().msecsSinceEpoch();
+}
+}
+
 void LogModel::setLog(const shv::chainpack::RpcValue &log)
 {
 	beginResetModel();
-	m_log = log;
+	m_pages.clear();
+	m_rowCount = 0;
+	if(log.isList() && !log.asList().empty()) {
+		const auto &rows = log.asList();
+		m_rowCount = static_cast<int>(rows.size());
+		m_pages.push_back(Page{.log = log, .getLogParams = {}, .firstRow = 0, .rowCount = m_rowCount, .firstMsec = row_msec(rows.front()), .lastMsec = row_msec(rows.back())});
+	}
+	m_residentBegin = 0;
+	m_residentEnd = m_pages.size();
+	m_hasMorePages = false;
+	m_fetchPending = false;
 	endResetModel();
 }
 
+void LogModel::appendLogPage(const shv::chainpack::RpcValue &page, const shv::chainpack::RpcValue &get_log_params)
+{
+	m_fetchPending = false;
+	m_hasMorePages = page.metaData().value("recordCountLimitHit").toBool();
+	const auto &rows = page.asList();
+	if(rows.empty()) {
+		// getLog keeps records with the same timestamp in one page, so empty page is the last one
+		m_hasMorePages = false;
+		return;
+	}
+	if(m_residentEnd != m_pages.size()) {
+		shvWarning() << "Cannot append page, pages after resident ones must be fetched first";
+		return;
+	}
+	const auto page_row_count = static_cast<int>(rows.size());
+	beginInsertRows(QModelIndex(), m_rowCount, m_rowCount + page_row_count - 1);
+	m_pages.push_back(Page{.log = page, .getLogParams = get_log_params, .firstRow = m_rowCount, .rowCount = page_row_count, .firstMsec = row_msec(rows.front()), .lastMsec = row_msec(rows.back())});
+	m_residentEnd = m_pages.size();
+	m_rowCount += page_row_count;
+	endInsertRows();
+	evictPages(true);
+}
+
+void LogModel::setPageLog(int page_index, const shv::chainpack::RpcValue &log)
+{
+	m_fetchPending = false;
+	const auto ix = static_cast<size_t>(page_index);
+	const bool is_previous = ix + 1 == m_residentBegin;
+	const bool is_next = ix == m_residentEnd && ix < m_pages.size();
+	if(page_index < 0 || !(is_previous || is_next)) {
+		// resident rows were changed meanwhile
+		return;
+	}
+	Page &pg = m_pages[ix];
+	// page range is downloaded again, its record count can differ if the log source changed meanwhile
+	pg.log = log;
+	pg.rowCount = static_cast<int>(log.asList().size());
+	if(pg.rowCount > 0) {
+		pg.firstMsec = row_msec(log.asList().front());
+		pg.lastMsec = row_msec(log.asList().back());
+	}
+	const int first_row = is_previous? 0: m_rowCount;
+	if(pg.rowCount > 0)
+		beginInsertRows(QModelIndex(), first_row, first_row + pg.rowCount - 1);
+	if(is_previous)
+		m_residentBegin--;
+	else
+		m_residentEnd++;
+	m_rowCount += pg.rowCount;
+	updateFirstRows();
+	if(pg.rowCount > 0)
+		endInsertRows();
+	evictPages(!is_previous);
+}
+
+void LogModel::updateFirstRows()
+{
+	int first_row = 0;
+	for(auto i = m_residentBegin; i < m_residentEnd; ++i) {
+		m_pages[i].firstRow = first_row;
+		first_row += m_pages[i].rowCount;
+	}
+}
+
+void LogModel::evictPages(bool from_front)
+{
+	// keep at least the last fetched page resident
+	while(m_residentEnd - m_residentBegin > 1 && m_rowCount > m_maxResidentRowCount) {
+		const auto ix = from_front? m_residentBegin: m_residentEnd - 1;
+		Page &pg = m_pages[ix];
+		const int first_row = from_front? 0: m_rowCount - pg.rowCount;
+		if(pg.rowCount > 0)
+			beginRemoveRows(QModelIndex(), first_row, first_row + pg.rowCount - 1);
+		pg.log = cp::RpcValue();
+		if(from_front)
+			m_residentBegin++;
+		else
+			m_residentEnd--;
+		m_rowCount -= pg.rowCount;
+		updateFirstRows();
+		if(pg.rowCount > 0)
+			endRemoveRows();
+	}
+}
+
+void LogModel::stopFetchMore()
+{
+	m_fetchPending = false;
+	m_hasMorePages = false;
+}
+
+void LogModel::abortFetch()
+{
+	m_fetchPending = false;
+}
+
+int64_t LogModel::residentSinceMsec() const
+{
+	if(m_residentBegin >= m_residentEnd)
+		return 0;
+	return m_pages[m_residentBegin].firstMsec;
+}
+
+int64_t LogModel::residentUntilMsec() const
+{
+	if(m_residentEnd >= m_pages.size())
+		return 0;
+	return m_pages[m_residentEnd].firstMsec;
+}
+
 shv::chainpack::RpcValue LogModel::log() const
 {
-	return m_log;
+	if(m_residentBegin >= m_residentEnd)
+		return shv::chainpack::RpcValue();
+	const auto first_page = m_pages.begin() + static_cast<std::ptrdiff_t>(m_residentBegin);
+	const auto end_page = m_pages.begin() + static_cast<std::ptrdiff_t>(m_residentEnd);
+	if(m_residentEnd - m_residentBegin == 1)
+		return first_page->log;
+	// paths dictionaries differ between pages, merged log contains full paths
+	cp::RpcList rows;
+	rows.reserve(static_cast<size_t>(m_rowCount));
+	for(auto it = first_page; it != end_page; ++it) {
+		const auto &pg = *it;
+		const cp::RpcValue::IMap &dict = pg.log.metaData().valref(core::utils::ShvJournalCommon::KEY_PATHS_DICT).asIMap();
+		for(const auto &row : pg.log.asList()) {
+			const auto &path = row.asList().valref(ColPath);
+			if(dict.empty() || !(path.isInt() || path.isUInt())) {
+				rows.push_back(row);
+				continue;
+			}
+			cp::RpcList r = row.asList();
+			r[ColPath] = dict.value(path.toInt());
+			rows.push_back(r);
+		}
+	}
+	auto header = core::utils::ShvLogHeader::fromMetaData(first_page->log.metaData());
+	const auto last_header = core::utils::ShvLogHeader::fromMetaData((end_page - 1)->log.metaData());
+	header.setPathDict({});
+	header.setWithPathsDict(false);
+	header.setUntil(last_header.until());
+	header.setRecordCount(static_cast<int>(rows.size()));
+	header.setRecordCountLimitHit(last_header.recordCountLimitHit());
+	cp::RpcValue ret = rows;
+	ret.setMetaData(header.toMetaData());
+	return ret;
+}
+
+const shv::chainpack::RpcValue &LogModel::logRow(int row, const shv::chainpack::RpcValue **page) const
+{
+	// first page which starts after row is preceded by the page containing it
+	const auto first_page = m_pages.begin() + static_cast<std::ptrdiff_t>(m_residentBegin);
+	const auto end_page = m_pages.begin() + static_cast<std::ptrdiff_t>(m_residentEnd);
+	auto it = std::upper_bound(first_page, end_page, row, [](int r, const Page &pg) {
+		return r < pg.firstRow;
+	});
+	if(it == first_page) {
+		static const cp::RpcValue empty;
+		return empty;
+	}
+	--it;
+	if(page)
+		*page = &it->log;
+	return it->log.asList().valref(static_cast<size_t>(row - it->firstRow));
 }
 
 int LogModel::rowCount(const QModelIndex &) const
 {
-	const shv::chainpack::RpcList &lst = m_log.asList();
-	return static_cast<int>(lst.size());
+	return m_rowCount;
+}
+
+bool LogModel::canFetchMore(const QModelIndex &parent) const
+{
+	if(parent.isValid() || m_fetchPending)
+		return false;
+	return m_residentEnd < m_pages.size() || (m_hasMorePages && !m_pages.empty());
+}
+
+void LogModel::fetchMore(const QModelIndex &parent)
+{
+	if(!canFetchMore(parent))
+		return;
+	m_fetchPending = true;
+	if(m_residentEnd < m_pages.size()) {
+		emit pageRequested(static_cast<int>(m_residentEnd), m_pages[m_residentEnd].getLogParams);
+		return;
+	}
+	// getLog 'since' is exclusive and records with the same timestamp are never split between pages
+	emit fetchMoreRequested(cp::RpcValue::DateTime::fromMSecsSinceEpoch(m_pages.back().lastMsec));
+}
+
+bool LogModel::canFetchPrevious() const
+{
+	return !m_fetchPending && m_residentBegin > 0;
+}
+
+void LogModel::fetchPrevious()
+{
+	if(!canFetchPrevious())
+		return;
+	m_fetchPending = true;
+	emit pageRequested(static_cast<int>(m_residentBegin) - 1, m_pages[m_residentBegin - 1].getLogParams);
 }
 
 int LogModel::columnCount(const QModelIndex&) const
@@ -74,8 +286,8 @@ QVariant LogModel::data(const QModelIndex &index, int role) const
 {
 	if(index.isValid() && index.row() < rowCount()) {
 		if(role == Qt::DisplayRole) {
-			const shv::chainpack::RpcList &lst = m_log.asList();
-			shv::chainpack::RpcValue row = lst.value(static_cast<unsigned>(index.row()));
+			const shv::chainpack::RpcValue *page = nullptr;
+			const shv::chainpack::RpcValue &row = logRow(index.row(), &page);
 			shv::chainpack::RpcValue val = row.asList().value(static_cast<unsigned>(index.column()));
 			if(index.column() == ColDateTime) {
 				int64_t msec = val.toDateTime().msecsSinceEpoch();
@@ -89,7 +301,7 @@ QVariant LogModel::data(const QModelIndex &index, int role) const
 			}
 			if(index.column() == ColPath) {
 				if ((val.type() == cp::RpcValue::Type::UInt) || (val.type() == cp::RpcValue::Type::Int)) {
-					const chainpack::RpcValue::IMap &dict = m_log.metaData().valref(core::utils::ShvJournalCommon::KEY_PATHS_DICT).asIMap();
+					const chainpack::RpcValue::IMap &dict = page->metaData().valref(core::utils::ShvJournalCommon::KEY_PATHS_DICT).asIMap();
 					auto it = dict.find(val.toInt());
 					if(it != dict.end())
 						val = it->second;
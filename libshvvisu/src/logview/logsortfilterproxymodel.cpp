@@ -1,14 +1,57 @@
 #include <shv/visu/logview/logsortfilterproxymodel.h>
+#include <shv/visu/logview/logfulltextindex.h>
 
 #include <shv/core/utils/shvpath.h>
 #include <shv/core/log.h>
 
+#include <QTimer>
+
+#include <algorithm>
+
 namespace shv::visu::logview {
 
 LogSortFilterProxyModel::LogSortFilterProxyModel(QObject *parent) :
 	Super(parent)
 {
+	m_fulltextIndex = std::make_unique<LogFullTextIndex>([this]() {
+		// called from index worker thread
+		QMetaObject::invokeMethod(this, &LogSortFilterProxyModel::onRowsIndexed, Qt::QueuedConnection);
+	});
+	m_partialResultsTimer.setSingleShot(true);
+	m_partialResultsTimer.setInterval(PARTIAL_RESULTS_UPDATE_MSEC);
+	connect(&m_partialResultsTimer, &QTimer::timeout, this, [this]() {
+		updateFulltextMatches();
+		invalidateFilter();
+	});
+}
+
+LogSortFilterProxyModel::~LogSortFilterProxyModel() = default;
 
+void LogSortFilterProxyModel::setSourceModel(QAbstractItemModel *source_model)
+{
+	for(const auto &c : m_sourceModelConnections)
+		disconnect(c);
+	m_sourceModelConnections.clear();
+	Super::setSourceModel(source_model);
+	if(source_model) {
+		m_sourceModelConnections << connect(source_model, &QAbstractItemModel::rowsInserted, this, [this](const QModelIndex &parent, int first, int) {
+			if(parent.isValid())
+				return;
+			if(first >= m_fulltextFedRowCount)
+				scheduleFulltextIndexing();
+			else
+				rebuildFulltextIndex();
+		});
+		m_sourceModelConnections << connect(source_model, &QAbstractItemModel::rowsRemoved, this, [this](const QModelIndex &parent, int first, int last) {
+			if(parent.isValid())
+				return;
+			removeFulltextRows(first, last - first + 1);
+		});
+		m_sourceModelConnections << connect(source_model, &QAbstractItemModel::rowsMoved, this, &LogSortFilterProxyModel::rebuildFulltextIndex);
+		m_sourceModelConnections << connect(source_model, &QAbstractItemModel::modelReset, this, &LogSortFilterProxyModel::rebuildFulltextIndex);
+		m_sourceModelConnections << connect(source_model, &QAbstractItemModel::layoutChanged, this, &LogSortFilterProxyModel::rebuildFulltextIndex);
+	}
+	rebuildFulltextIndex();
 }
 
 void LogSortFilterProxyModel::setChannelFilter(const std::optional<shv::visu::timeline::ChannelFilter> &filter)
@@ -20,19 +63,106 @@ void LogSortFilterProxyModel::setChannelFilter(const std::optional<shv::visu::ti
 void LogSortFilterProxyModel::setShvPathColumn(int column)
 {
 	m_shvPathColumn = column;
+	rebuildFulltextIndex();
 }
 
 void LogSortFilterProxyModel::setValueColumn(int column)
 {
 	m_valueColumn = column;
+	rebuildFulltextIndex();
 }
 
 void LogSortFilterProxyModel::setFulltextFilter(const timeline::FullTextFilter &filter)
 {
 	m_fulltextFilter = filter;
+	updateFulltextMatches();
 	invalidateFilter();
 }
 
+bool LogSortFilterProxyModel::isFulltextIndexComplete() const
+{
+	return !sourceModel() || m_fulltextIndex->indexedRowCount() == sourceModel()->rowCount();
+}
+
+void LogSortFilterProxyModel::rebuildFulltextIndex()
+{
+	m_fulltextIndex->clear();
+	m_fulltextFedRowCount = 0;
+	m_fulltextMatches.clear();
+	scheduleFulltextIndexing();
+}
+
+void LogSortFilterProxyModel::removeFulltextRows(int first_row, int count)
+{
+	// rows not sent to index yet are fed from the source model later
+	if(first_row >= m_fulltextFedRowCount)
+		return;
+	count = std::min(count, m_fulltextFedRowCount - first_row);
+	m_fulltextIndex->removeRows(first_row, count);
+	m_fulltextFedRowCount -= count;
+	if(static_cast<size_t>(first_row) < m_fulltextMatches.size()) {
+		const auto first = m_fulltextMatches.begin() + first_row;
+		m_fulltextMatches.erase(first, first + std::min<std::ptrdiff_t>(count, m_fulltextMatches.end() - first));
+	}
+}
+
+void LogSortFilterProxyModel::scheduleFulltextIndexing()
+{
+	if(m_fulltextFeedScheduled || !sourceModel())
+		return;
+	m_fulltextFeedScheduled = true;
+	QTimer::singleShot(0, this, &LogSortFilterProxyModel::feedFulltextIndex);
+}
+
+void LogSortFilterProxyModel::feedFulltextIndex()
+{
+	// texts are formatted in GUI thread one batch per event loop iteration,
+	// source model cannot be accessed from index worker
+	m_fulltextFeedScheduled = false;
+	QAbstractItemModel *model = sourceModel();
+	if(!model || m_shvPathColumn < 0)
+		return;
+	const int row_count = model->rowCount();
+	const int last_row = std::min(row_count, m_fulltextFedRowCount + INDEX_BATCH_SIZE);
+	std::vector<LogFullTextIndex::RowFields> rows;
+	rows.reserve(static_cast<size_t>(last_row - m_fulltextFedRowCount));
+	for(int row = m_fulltextFedRowCount; row < last_row; ++row) {
+		LogFullTextIndex::RowFields fields;
+		fields << model->data(model->index(row, m_shvPathColumn)).toString();
+		if(m_valueColumn >= 0)
+			fields << model->data(model->index(row, m_valueColumn)).toString();
+		rows.push_back(std::move(fields));
+	}
+	m_fulltextFedRowCount = last_row;
+	if(!rows.empty())
+		m_fulltextIndex->appendRows(std::move(rows));
+	if(m_fulltextFedRowCount < row_count)
+		scheduleFulltextIndexing();
+}
+
+void LogSortFilterProxyModel::onRowsIndexed()
+{
+	if(sourceModel())
+		emit fulltextIndexProgress(m_fulltextIndex->indexedRowCount(), sourceModel()->rowCount());
+	if(!m_fulltextFilter.pattern().isEmpty() && !m_partialResultsTimer.isActive()) {
+		// show partial results while indexing is running, refiltering all rows after each batch would be too slow
+		m_partialResultsTimer.start();
+	}
+}
+
+void LogSortFilterProxyModel::updateFulltextMatches()
+{
+	m_fulltextMatches.clear();
+	if(m_fulltextFilter.pattern().isEmpty())
+		return;
+	m_fulltextMatches.resize(static_cast<size_t>(m_fulltextIndex->indexedRowCount()));
+	for(int row : m_fulltextIndex->matchingRows(m_fulltextFilter)) {
+		// rows can be indexed meanwhile
+		if(static_cast<size_t>(row) < m_fulltextMatches.size())
+			m_fulltextMatches[static_cast<size_t>(row)] = true;
+	}
+}
+
 bool startsWithPath(const QStringView &str, const QStringView &path)
 {
 	if (path.empty())
@@ -57,13 +187,9 @@ bool LogSortFilterProxyModel::filterAcceptsRow(int source_row, const QModelIndex
 		is_row_accepted = (m_channelFilter) ? m_channelFilter.value().isPathPermitted(sourceModel()->data(ix).toString()) : true;
 
 		if (is_row_accepted && !m_fulltextFilter.pattern().isEmpty()) {
-			bool is_fulltext_filter_matched = m_fulltextFilter.matches(sourceModel()->data(ix).toString());
-
-			if (m_valueColumn >= 0) {
-				ix = sourceModel()->index(source_row, m_valueColumn, source_parent);
-				is_fulltext_filter_matched = is_fulltext_filter_matched || m_fulltextFilter.matches(sourceModel()->data(ix).toString());
-			}
-			is_row_accepted = is_row_accepted && is_fulltext_filter_matched;
+			// rows not indexed yet are hidden until the index reaches them
+			const auto row = static_cast<size_t>(source_row);
+			is_row_accepted = row < m_fulltextMatches.size() && m_fulltextMatches[row];
 		}
 	}
 
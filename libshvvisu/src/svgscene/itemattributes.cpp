@@ -0,0 +1,43 @@
+#include <shv/visu/svgscene/itemattributes.h>
+
+#include <QGraphicsItem>
+
+namespace shv::visu::svgscene {
+
+namespace {
+const QString* findValue(const QMap<QString, QString> &map, const QString &name)
+{
+	// map is const, so it is never detached and pointer to value stays valid
+	auto it = map.constFind(name);
+	return it == map.cend()? nullptr: &it.value();
+}
+}
+
+ItemAttributes::ItemAttributes(const Types::XmlAttributes &xml_attributes, const Types::CssAttributes &css_attributes)
+	: m_xmlAttributes(xml_attributes)
+	, m_cssAttributes(css_attributes)
+{
+}
+
+const QString* ItemAttributes::xmlAttribute(const QString &name) const
+{
+	return findValue(m_xmlAttributes, name);
+}
+
+const QString* ItemAttributes::cssAttribute(const QString &name) const
+{
+	return findValue(m_cssAttributes, name);
+}
+
+const ItemAttributes* ItemAttributes::fromItem(const QGraphicsItem *item)
+{
+	// item data keeps its own reference, so raw pointer outlives the temporary QVariant
+	return item->data(Types::DataKey::Attributes).value<ItemAttributesPtr>().data();
+}
+
+void ItemAttributes::setToItem(QGraphicsItem *item, QSharedPointer<const ItemAttributes> attributes)
+{
+	item->setData(Types::DataKey::Attributes, QVariant::fromValue(std::move(attributes)));
+}
+
+}
@@ -6,6 +6,7 @@
 #include <shv/visu/svgscene/types.h>
 #include <shv/visu/svgscene/simpletextitem.h>
 #include <shv/visu/svgscene/groupitem.h>
+#include <shv/visu/svgscene/itemattributes.h>
 
 #include <QGraphicsItem>
 #include <QGraphicsTextItem>
@@ -15,6 +16,11 @@
 #include <QtMath>
 #include <QFontMetrics>
 #include <QSet>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
 
 #define logSvgW() shvCWarning("svg")
 #define logSvgM() shvCMessage("svg")
@@ -923,11 +929,134 @@ SaxHandler::~SaxHandler() = default;
 
 void SaxHandler::load(QXmlStreamReader *data, bool skip_definitions)
 {
-	m_skipDefinitions = skip_definitions;
+	init(skip_definitions);
 	m_xml = data;
+	parse();
+	m_xml = nullptr;
+}
+
+namespace {
+constexpr quint32 SVG_CACHE_MAGIC = 0x53564743; // "SVGC"
+// increment when SvgEvent serialization or element parsing changes
+constexpr quint32 SVG_CACHE_VERSION = 1;
+}
+
+bool SaxHandler::loadFile(const QString &file_name, const QString &cache_dir, bool skip_definitions)
+{
+	QFile file(file_name);
+	if(!file.open(QFile::ReadOnly)) {
+		logSvgW() << "Cannot open file:" << file_name << file.errorString();
+		return false;
+	}
+	const QByteArray svg_data = file.readAll();
+	QString cache_file_name;
+	if(!cache_dir.isEmpty()) {
+		// content hash invalidates cache when SVG changes
+		const auto hash = QCryptographicHash::hash(svg_data, QCryptographicHash::Sha1).toHex();
+		cache_file_name = QDir(cache_dir).filePath(QString::fromLatin1(hash) + (skip_definitions? QStringLiteral("-nodefs"): QString()) + QStringLiteral(".svgcache"));
+		std::vector<SvgEvent> events;
+		if(readCache(cache_file_name, events)) {
+			logSvgM() << "Loading:" << file_name << "from cache:" << cache_file_name;
+			init(skip_definitions);
+			replay(events);
+			return true;
+		}
+	}
+	QXmlStreamReader xml(svg_data);
+	std::vector<SvgEvent> events;
+	if(!cache_file_name.isEmpty())
+		m_recordedEvents = &events;
+	load(&xml, skip_definitions);
+	m_recordedEvents = nullptr;
+	if(xml.hasError()) {
+		logSvgW() << "Error parsing file:" << file_name << xml.errorString();
+		return false;
+	}
+	if(!cache_file_name.isEmpty()) {
+		QDir().mkpath(cache_dir);
+		writeCache(cache_file_name, events);
+	}
+	return true;
+}
+
+bool SaxHandler::readCache(const QString &file_name, std::vector<SvgEvent> &events)
+{
+	QFile file(file_name);
+	if(!file.open(QFile::ReadOnly))
+		return false;
+	QDataStream in(&file);
+	in.setVersion(QDataStream::Qt_5_15);
+	quint32 magic = 0;
+	quint32 version = 0;
+	quint32 count = 0;
+	in >> magic >> version >> count;
+	if(magic != SVG_CACHE_MAGIC || version != SVG_CACHE_VERSION) {
+		logSvgM() << "Ignoring cache file of different version:" << file_name;
+		return false;
+	}
+	// count is not trusted to preallocate, corrupted file could request huge buffer
+	for(quint32 i = 0; i < count; ++i) {
+		SvgEvent &event = events.emplace_back();
+		quint8 type = 0;
+		in >> type;
+		event.type = static_cast<SvgEvent::Type>(type);
+		switch (event.type) {
+		case SvgEvent::Type::StartElement:
+			in >> event.element.name >> event.element.xmlAttributes >> event.element.styleAttributes;
+			break;
+		case SvgEvent::Type::EndElement:
+			break;
+		case SvgEvent::Type::Characters:
+			in >> event.text;
+			break;
+		default:
+			in.setStatus(QDataStream::ReadCorruptData);
+			break;
+		}
+		if(in.status() != QDataStream::Ok)
+			break;
+	}
+	if(in.status() != QDataStream::Ok) {
+		logSvgW() << "Corrupted cache file:" << file_name;
+		events.clear();
+		return false;
+	}
+	return true;
+}
+
+void SaxHandler::writeCache(const QString &file_name, const std::vector<SvgEvent> &events)
+{
+	// cache is shared by all instances, write it atomically
+	QSaveFile file(file_name);
+	if(!file.open(QFile::WriteOnly)) {
+		logSvgW() << "Cannot open cache file:" << file_name << "for writing:" << file.errorString();
+		return;
+	}
+	QDataStream out(&file);
+	out.setVersion(QDataStream::Qt_5_15);
+	out << SVG_CACHE_MAGIC << SVG_CACHE_VERSION << static_cast<quint32>(events.size());
+	for(const auto &event : events) {
+		out << static_cast<quint8>(event.type);
+		switch (event.type) {
+		case SvgEvent::Type::StartElement:
+			out << event.element.name << event.element.xmlAttributes << event.element.styleAttributes;
+			break;
+		case SvgEvent::Type::EndElement:
+			break;
+		case SvgEvent::Type::Characters:
+			out << event.text;
+			break;
+		}
+	}
+	if(!file.commit())
+		logSvgW() << "Cannot write cache file:" << file_name << file.errorString();
+}
+
+void SaxHandler::init(bool skip_definitions)
+{
+	m_skipDefinitions = skip_definitions;
 	m_defaultPen = QPen(Qt::black, 1, Qt::SolidLine, Qt::FlatCap, Qt::SvgMiterJoin);
 	m_defaultPen.setMiterLimit(4);
-	parse();
 }
 
 void SaxHandler::parse()
@@ -947,44 +1076,27 @@ void SaxHandler::parse()
 				}
 			}
 			el.xmlAttributes = parseXmlAttributes(m_xml->attributes());
-			logSvgD() << QString(m_elementStack.count(), '-') << ">" << "+ start element:" << el.name << "id:" << el.xmlAttributes.value("id");
 			if(!m_elementStack.isEmpty())
 				el.styleAttributes = m_elementStack.last().styleAttributes;
 			mergeCSSAttributes(el.styleAttributes, QStringLiteral("style"), el.xmlAttributes);
-			m_elementStack.push(el);
-			bool is_item_created = startElement();
-			m_elementStack.last().itemCreated = is_item_created;
+			if(m_recordedEvents)
+				m_recordedEvents->push_back(SvgEvent{SvgEvent::Type::StartElement, el, {}});
+			startSvgElement(el);
 			break;
 		}
 		case QXmlStreamReader::EndElement:
 		{
-			SvgElement svg_element = m_elementStack.pop();
-			logSvgD() << QString(m_elementStack.count(), '-') << ">" << "- end element:" << m_xml->name() << "item created:" << svg_element.itemCreated;
-			if(svg_element.itemCreated && m_topLevelItem) {
-				installVisuController(m_topLevelItem, svg_element);
-				m_topLevelItem = m_topLevelItem->parentItem();
-			}
+			if(m_recordedEvents)
+				m_recordedEvents->push_back(SvgEvent{SvgEvent::Type::EndElement, {}, {}});
+			endSvgElement();
 			break;
 		}
 		case QXmlStreamReader::Characters:
 		{
-			logSvgD() << "characters element:" << m_xml->text();// << typeid (*m_topLevelItem).name();
-			if(auto *simple_text_item = dynamic_cast<SimpleTextItem*>(m_topLevelItem)) {
-				QString text = simple_text_item->text();
-				if(!text.isEmpty())
-					text += '\n';
-				logSvgD() << simple_text_item->text() << "+" << m_xml->text().toString();
-				simple_text_item->setText(text + m_xml->text().toString());
-			}
-			else if(auto *qgraphics_text_item = dynamic_cast<QGraphicsTextItem*>(m_topLevelItem)) {
-				QString text = qgraphics_text_item->toPlainText();
-				if(!text.isEmpty())
-					text += '\n';
-				qgraphics_text_item->setPlainText(text.append(m_xml->text()));
-			}
-			else {
-				logSvgD() << "characters are not part of text item, will be ignored";
-			}
+			const auto text = m_xml->text().toString();
+			if(m_recordedEvents)
+				m_recordedEvents->push_back(SvgEvent{SvgEvent::Type::Characters, {}, text});
+			addCharacters(text);
 			break;
 		}
 		case QXmlStreamReader::ProcessingInstruction:
@@ -996,6 +1108,64 @@ void SaxHandler::parse()
 	}
 }
 
+void SaxHandler::replay(const std::vector<SvgEvent> &events)
+{
+	for(const auto &event : events) {
+		switch (event.type) {
+		case SvgEvent::Type::StartElement:
+			startSvgElement(event.element);
+			break;
+		case SvgEvent::Type::EndElement:
+			endSvgElement();
+			break;
+		case SvgEvent::Type::Characters:
+			addCharacters(event.text);
+			break;
+		}
+	}
+}
+
+void SaxHandler::startSvgElement(const SvgElement &el)
+{
+	logSvgD() << QString(m_elementStack.count(), '-') << ">" << "+ start element:" << el.name << "id:" << el.xmlAttributes.value("id");
+	m_elementStack.push(el);
+	bool is_item_created = startElement();
+	m_elementStack.last().itemCreated = is_item_created;
+}
+
+void SaxHandler::endSvgElement()
+{
+	if(m_elementStack.isEmpty())
+		return;
+	SvgElement svg_element = m_elementStack.pop();
+	logSvgD() << QString(m_elementStack.count(), '-') << ">" << "- end element:" << svg_element.name << "item created:" << svg_element.itemCreated;
+	if(svg_element.itemCreated && m_topLevelItem) {
+		installVisuController(m_topLevelItem, svg_element);
+		m_topLevelItem = m_topLevelItem->parentItem();
+	}
+}
+
+void SaxHandler::addCharacters(const QString &text)
+{
+	logSvgD() << "characters element:" << text;
+	if(auto *simple_text_item = dynamic_cast<SimpleTextItem*>(m_topLevelItem)) {
+		QString item_text = simple_text_item->text();
+		if(!item_text.isEmpty())
+			item_text += '\n';
+		logSvgD() << simple_text_item->text() << "+" << text;
+		simple_text_item->setText(item_text + text);
+	}
+	else if(auto *qgraphics_text_item = dynamic_cast<QGraphicsTextItem*>(m_topLevelItem)) {
+		QString item_text = qgraphics_text_item->toPlainText();
+		if(!item_text.isEmpty())
+			item_text += '\n';
+		qgraphics_text_item->setPlainText(item_text.append(text));
+	}
+	else {
+		logSvgD() << "characters are not part of text item, will be ignored";
+	}
+}
+
 bool SaxHandler::startElement()
 {
 	const SvgElement &el = m_elementStack.last();
@@ -1203,8 +1373,7 @@ void SaxHandler::setXmlAttributes(QGraphicsItem *git, const SaxHandler::SvgEleme
 		if(it.key().startsWith(QStringLiteral("shv")))
 			attrs[it.key()] = it.value();
 	}
-	git->setData(Types::DataKey::XmlAttributes, QVariant::fromValue(attrs));
-	git->setData(Types::DataKey::CssAttributes, QVariant::fromValue(el.styleAttributes));
+	ItemAttributes::setToItem(git, ItemAttributesPtr::create(attrs, el.styleAttributes));
 }
 
 void SaxHandler::setTransform(QGraphicsItem *it, const QString &str_val)
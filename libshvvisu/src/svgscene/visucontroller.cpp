@@ -21,14 +21,26 @@ VisuController::VisuController(QGraphicsItem *graphics_item, QObject *parent)
 
 QString VisuController::graphicsItemAttributeValue(const QGraphicsItem *it, const QString &attr_name, const QString &default_value)
 {
-	auto attrs = qvariant_cast<svgscene::XmlAttributes>(it->data(Types::DataKey::XmlAttributes));
-	return attrs.value(attr_name, default_value);
+	const QString *value = resolveGraphicsItemAttribute(it, attr_name);
+	return value? *value: default_value;
 }
 
 QString VisuController::graphicsItemCssAttributeValue(const QGraphicsItem *it, const QString &attr_name, const QString &default_value)
 {
-	auto attrs = qvariant_cast<svgscene::CssAttributes>(it->data(Types::DataKey::CssAttributes));
-	return attrs.value(attr_name, default_value);
+	const QString *value = resolveGraphicsItemCssAttribute(it, attr_name);
+	return value? *value: default_value;
+}
+
+const QString* VisuController::resolveGraphicsItemAttribute(const QGraphicsItem *it, const QString &attr_name)
+{
+	const ItemAttributes *attrs = ItemAttributes::fromItem(it);
+	return attrs? attrs->xmlAttribute(attr_name): nullptr;
+}
+
+const QString* VisuController::resolveGraphicsItemCssAttribute(const QGraphicsItem *it, const QString &attr_name)
+{
+	const ItemAttributes *attrs = ItemAttributes::fromItem(it);
+	return attrs? attrs->cssAttribute(attr_name): nullptr;
 }
 
 
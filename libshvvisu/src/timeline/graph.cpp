@@ -578,6 +578,8 @@ void Graph::setXRangeZoom(const XRange &r)
 	}
 	m_state.xRangeZoom = new_r;
 	makeXAxis();
+	if(prev_r.min != new_r.min || prev_r.max != new_r.max)
+		emit xRangeZoomChanged(new_r);
 }
 
 void Graph::resetXZoom()
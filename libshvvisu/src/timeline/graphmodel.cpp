@@ -3,6 +3,7 @@
 #include <shv/chainpack/rpcvalue.h>
 #include <shv/coreqt/log.h>
 
+#include <algorithm>
 #include <cmath>
 
 namespace shv::visu::timeline {
@@ -283,6 +284,46 @@ void GraphModel::forgetValuesBefore(timemsec_t time, int min_samples_count)
 	}
 }
 
+void GraphModel::removeValuesBefore(timemsec_t time)
+{
+	for(auto &samples : m_samples) {
+		auto it = std::lower_bound(samples.begin(), samples.end(), time, [](const Sample &s, timemsec_t t) {
+			return s.time < t;
+		});
+		samples.erase(samples.begin(), it);
+	}
+}
+
+void GraphModel::removeValuesFrom(timemsec_t time)
+{
+	for(auto &samples : m_samples) {
+		auto it = std::lower_bound(samples.begin(), samples.end(), time, [](const Sample &s, timemsec_t t) {
+			return s.time < t;
+		});
+		samples.erase(it, samples.end());
+	}
+}
+
+void GraphModel::mergeValues(const GraphModel &other)
+{
+	for (qsizetype other_ix = 0; other_ix < other.channelCount(); ++other_ix) {
+		const ChannelInfo &other_info = other.channelInfo(other_ix);
+		const auto shv_path = other_info.shvPath.toStdString();
+		auto ch_ix = pathToChannelIndex(shv_path);
+		if(ch_ix < 0) {
+			appendChannel(shv_path, other_info.name.toStdString(), other_info.typeDescr);
+			ch_ix = channelCount() - 1;
+		}
+		ChannelSamples &samples = m_samples[ch_ix];
+		const auto old_count = samples.count();
+		for (qsizetype i = 0; i < other.count(other_ix); ++i)
+			samples.push_back(other.sampleAt(other_ix, i));
+		std::inplace_merge(samples.begin(), samples.begin() + old_count, samples.end(), [](const Sample &s1, const Sample &s2) {
+			return s1.time < s2.time;
+		});
+	}
+}
+
 qsizetype GraphModel::pathToChannelIndex(const std::string &path) const
 {
 	auto it = m_pathToChannelCache.find(path);